@@ -6,7 +6,7 @@ public class MoonshotMover : ModuleRules
 	{
 		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
 	
-		PublicDependencyModuleNames.AddRange(new string[] { "Core", "CoreUObject", "Engine", "InputCore" });
+		PublicDependencyModuleNames.AddRange(new string[] { "Core", "CoreUObject", "Engine", "InputCore", "MassEntity", "MassCommon", "MassSpawner" });
 
 		PrivateDependencyModuleNames.AddRange(new string[] { "NetCore", "Mover" });
 	}
@@ -2,6 +2,13 @@
 
 #include "MoonshotMoverAttachingMode.h"
 #include "MoonshotMoverDataModelTypes.h"
+#include "MoonshotMoverDeterministicMath.h"
+#include "MoonshotMoverInputBaselines.h"
+#include "MoonshotMoverInputLatency.h"
+#include "MoonshotMoverModeRegistry.h"
+#include "MoonshotMoverProxySimulation.h"
+#include "MoonshotMoverSimTelemetry.h"
+#include "MoonshotMoverFallAlongSurface.h"
 #include "MoonshotMoverUtils.h"
 #include "Kismet/BlueprintFunctionLibrary.h"
 #include "Mover/Public/MoverComponent.h"
@@ -26,10 +33,23 @@ UMoonshotMoverAttachingMode::UMoonshotMoverAttachingMode(const FObjectInitialize
 void UMoonshotMoverAttachingMode::OnGenerateMove(const FMoverTickStartData& StartState, const FMoverTimeStep& TimeStep, FProposedMove& OutProposedMove) const
 {
 	//const FCharacterDefaultInputs* CharacterInputs = StartState.InputCmd.InputCollection.FindDataByType<FCharacterDefaultInputs>();
-    const FMoonshotMoverCharacterInputs* CharacterInputs = StartState.InputCmd.InputCollection.FindDataByType<FMoonshotMoverCharacterInputs>();
+    FMoonshotMoverCharacterInputs RepairedInputs;
+    const FMoonshotMoverCharacterInputs* CharacterInputs = FMoonshotMoverInputRepair::Resolve(GetMoverComponent(), GetBlackboard_Mutable(), TimeStep,
+    	StartState.InputCmd.InputCollection.FindDataByType<FMoonshotMoverCharacterInputs>(), RepairedInputs);
+    if (CharacterInputs)
+    {
+    	FMoonshotMoverInputLatency::MarkGenerateMove(GetMoverComponent(), TimeStep, CharacterInputs->LatencyStamp);
+    }
 	const FMoverDefaultSyncState* StartingSyncState = StartState.SyncState.SyncStateCollection.FindDataByType<FMoverDefaultSyncState>();
 	check(StartingSyncState);
 
+	// Distant, unseen proxies skip move generation as well as the collision in OnSimulationTick
+	if (FMoonshotMoverProxySimulation::ShouldExtrapolate(GetMoverComponent(), Cast<UPrimitiveComponent>(GetMoverComponent()->GetUpdatedComponent()), *StartingSyncState, *CommonMovementSettings))
+	{
+		FMoonshotMoverProxySimulation::GenerateMove(*StartingSyncState, FRotator::ZeroRotator, OutProposedMove);
+		return;
+	}
+
 	const float DeltaSeconds = TimeStep.StepMs * 0.001f;
 
 	FAttachingModeParams Params;
@@ -38,7 +58,6 @@ void UMoonshotMoverAttachingMode::OnGenerateMove(const FMoverTickStartData& Star
 		Params.MoveInputType = CharacterInputs->GetMoveInputType();
 		Params.MoveInput = CharacterInputs->GetMoveInput();
         Params.ControlRotation = CharacterInputs->ControlRotation;
-        Params.GravityAcceleration = CharacterInputs->GravityAcceleration;
 	}
 	else
 	{
@@ -62,6 +81,8 @@ void UMoonshotMoverAttachingMode::OnGenerateMove(const FMoverTickStartData& Star
     Params.Deceleration = CommonMovementSettings->AttachBrakingScale;
 	Params.DeltaSeconds = DeltaSeconds;
 
+    const FMoonshotMoverMath Math(CommonMovementSettings->bUseDeterministicMath);
+
     FRotator IntendedOrientation_WorldSpace;
     if (!CharacterInputs || CharacterInputs->OrientationIntent.IsNearlyZero())
     {
@@ -70,15 +91,12 @@ void UMoonshotMoverAttachingMode::OnGenerateMove(const FMoverTickStartData& Star
 
     } else
     {
-        IntendedOrientation_WorldSpace = CharacterInputs->GetOrientationIntentDir_WorldSpace().ToOrientationRotator();
+        IntendedOrientation_WorldSpace = Math.VectorToRotator(CharacterInputs->GetOrientationIntentDir_WorldSpace());
     }
 
     Params.OrientationIntent = IntendedOrientation_WorldSpace;
 
-    if (!CharacterInputs || Params.GravityAcceleration.IsNearlyZero())
-    {
-        Params.GravityAcceleration = -980.0f * GetMoverComponent()->GetOwner()->GetActorUpVector();
-    }
+    Params.GravityAcceleration = FMoonshotMoverGravity::Resolve(*StartingSyncState, CharacterInputs, *CommonMovementSettings);
 	
 	OutProposedMove.DirectionIntent = Params.MoveInput.GetSafeNormal();
 	OutProposedMove.bHasDirIntent = !OutProposedMove.DirectionIntent.IsNearlyZero();
@@ -95,20 +113,22 @@ void UMoonshotMoverAttachingMode::OnGenerateMove(const FMoverTickStartData& Star
 
     if (Params.DeltaSeconds > 0.0f)
     {
-        Params.OrientationIntent = Params.OrientationIntent.Vector().ToOrientationRotator();
-        Params.PriorOrientation = Params.PriorOrientation.Vector().ToOrientationRotator();
+        Params.OrientationIntent = Math.VectorToRotator(Math.RotatorToVector(Params.OrientationIntent));
+        Params.PriorOrientation = Math.VectorToRotator(Math.RotatorToVector(Params.PriorOrientation));
+
+        const FQuat InverseActorQuat = GetMoverComponent()->GetOwner()->GetActorQuat().Inverse();
 
-        Params.OrientationIntent = GetMoverComponent()->GetOwner()->GetActorTransform().InverseTransformRotation(Params.OrientationIntent.Quaternion()).Rotator();
-        Params.PriorOrientation = GetMoverComponent()->GetOwner()->GetActorTransform().InverseTransformRotation(Params.PriorOrientation.Quaternion()).Rotator();
+        Params.OrientationIntent = Math.QuatToRotator(Math.Multiply(InverseActorQuat, Math.RotatorToQuat(Params.OrientationIntent)));
+        Params.PriorOrientation = Math.QuatToRotator(Math.Multiply(InverseActorQuat, Math.RotatorToQuat(Params.PriorOrientation)));
 
-        FQuat DeltaQuat = FQuat::FindBetweenNormals(Params.PriorOrientation.Vector(), Params.OrientationIntent.Vector());
-        FRotator AngularDelta = DeltaQuat.Rotator();
+        FQuat DeltaQuat = Math.FindBetweenNormals(Math.RotatorToVector(Params.PriorOrientation), Math.RotatorToVector(Params.OrientationIntent));
+        FRotator AngularDelta = Math.QuatToRotator(DeltaQuat);
 
         //UE_LOG(LogTemp, Display, TEXT("Delta: %s"), *AngularDelta.ToString());
 
         FRotator Winding, Remainder;
 
-        AngularDelta.GetWindingAndRemainder(Winding, Remainder);
+        Math.GetWindingAndRemainder(AngularDelta, Winding, Remainder);
 
         AngularVelocityDpS = Remainder * (1.0f / Params.DeltaSeconds);
 
@@ -135,11 +155,14 @@ void UMoonshotMoverAttachingMode::OnSimulationTick(const FSimulationTickParams&
 	UPrimitiveComponent* UpdatedPrimitive = Params.UpdatedPrimitive;
 	FProposedMove ProposedMove = Params.ProposedMove;
 
-    const FMoonshotMoverCharacterInputs* CharacterInputs = StartState.InputCmd.InputCollection.FindDataByType<FMoonshotMoverCharacterInputs>();
+    FMoonshotMoverCharacterInputs RepairedInputs;
+    const FMoonshotMoverCharacterInputs* CharacterInputs = FMoonshotMoverInputRepair::Resolve(GetMoverComponent(), GetBlackboard_Mutable(), Params.TimeStep,
+    	StartState.InputCmd.InputCollection.FindDataByType<FMoonshotMoverCharacterInputs>(), RepairedInputs);
 	const FMoverDefaultSyncState* StartingSyncState = StartState.SyncState.SyncStateCollection.FindDataByType<FMoverDefaultSyncState>();
 	check(StartingSyncState);
 
 	FMoverDefaultSyncState& OutputSyncState = OutputState.SyncState.SyncStateCollection.FindOrAddMutableDataByType<FMoverDefaultSyncState>();
+	const FMoonshotMoverSimTickScope TickScope(GetMoverComponent(), Params.TimeStep, *StartingSyncState, OutputSyncState, CommonMovementSettings->ResimBudgetMs);
 
 	const float DeltaSeconds = Params.TimeStep.StepMs * 0.001f;
     float PctTimeApplied = 0.f;
@@ -151,18 +174,51 @@ void UMoonshotMoverAttachingMode::OnSimulationTick(const FSimulationTickParams&
 		return;
 	}
 
+	// Distant, unseen proxies only need to look plausible until the next server update
+	if (FMoonshotMoverProxySimulation::ShouldExtrapolate(GetMoverComponent(), UpdatedPrimitive, *StartingSyncState, *CommonMovementSettings))
+	{
+		FMoonshotMoverProxySimulation::Extrapolate(UpdatedComponent, *StartingSyncState, ProposedMove, DeltaSeconds, *CommonMovementSettings, GetBlackboard_Mutable(), OutputSyncState);
+		return;
+	}
+
 	FMovementRecord MoveRecord;
 	MoveRecord.SetDeltaSeconds(DeltaSeconds);
 
 	FFloorCheckResult CurrentFloor;
 	UMoverBlackboard* SimBlackboard = GetBlackboard_Mutable();
 
-	// If we don't have cached floor information, we need to search for it again
-	if (!SimBlackboard->TryGet(CommonBlackboard::LastFloorResult, CurrentFloor))
+	// While the predicted contact is more than this tick (plus the safety window) away, we are in free fall toward a known plane and can skip the floor and attach queries
+	FMoonshotMoverPredictedContact PredictedContact;
+	float TimeToImpact = UE_BIG_NUMBER;
+	bool bPredictedContactFar = false;
+	if (CommonMovementSettings->bUsePredictedContact && SimBlackboard->TryGet(MoonshotBlackboard::PredictedContact, PredictedContact))
+	{
+		const FVector GravityAcceleration = FMoonshotMoverGravity::Resolve(*StartingSyncState, CharacterInputs, *CommonMovementSettings);
+		// Assume air control pushes straight at the surface so the prediction errs early
+		const float MaxControlAcceleration = AirControlPercentage * CommonMovementSettings->ZeroGLinearAcceleration;
+
+		TimeToImpact = UAttachingModeUtils::ComputeTimeToImpact(
+			PredictedContact.GetHeightAbovePlane(UpdatedPrimitive->GetComponentLocation()),
+			ProposedMove.LinearVelocity | PredictedContact.PlaneNormal,
+			(GravityAcceleration | PredictedContact.PlaneNormal) - MaxControlAcceleration);
+
+		bPredictedContactFar = TimeToImpact > DeltaSeconds + CommonMovementSettings->PredictedContactWindow;
+	}
+
+	// If we don't have cached floor information, reuse a floor handed off by the previous mode, or search for it again
+	if (!bPredictedContactFar && !SimBlackboard->TryGet(CommonBlackboard::LastFloorResult, CurrentFloor))
 	{
-		UMoonshotMoverUtils::FindFloor(UpdatedComponent, UpdatedPrimitive,
-			CommonMovementSettings->FloorSweepDistance, CommonMovementSettings->MaxWalkSlopeCosine,
-			UpdatedPrimitive->GetComponentLocation(), CurrentFloor);
+		FMoonshotMoverFloorHandoff FloorHandoff;
+		if (FMoonshotMoverFloorHandoff::TryGetValid(SimBlackboard, UpdatedPrimitive->GetComponentLocation(), CommonMovementSettings->FloorHandoffTolerance, FloorHandoff))
+		{
+			CurrentFloor = FloorHandoff.Floor;
+		}
+		else
+		{
+			UMoonshotMoverUtils::FindFloor(UpdatedComponent, UpdatedPrimitive,
+				CommonMovementSettings->FloorSweepDistance, CommonMovementSettings->MaxWalkSlopeCosine,
+				UpdatedPrimitive->GetComponentLocation(), CurrentFloor);
+		}
 	}
  
 	OutputSyncState.MoveDirectionIntent = (ProposedMove.bHasDirIntent ? ProposedMove.DirectionIntent : FVector::ZeroVector);
@@ -171,20 +227,27 @@ void UMoonshotMoverAttachingMode::OnSimulationTick(const FSimulationTickParams&
 	const FRotator StartingOrient = StartingSyncState->GetOrientation_WorldSpace();
 	//FRotator TargetOrient = StartingOrient;
 
+    const FMoonshotMoverMath Math(CommonMovementSettings->bUseDeterministicMath);
+
     // Apply orientation changes (if any)
-    FQuat OrientQuat = StartingOrient.Quaternion();
+    const FQuat StartQuat = Math.RotatorToQuat(StartingOrient);
+    FQuat OrientQuat = StartQuat;
 	if (!ProposedMove.AngularVelocity.IsZero())
 	{
 		//FRotator TargetOrient = StartingOrient + ProposedMove.AngularVelocity * DeltaSeconds;
         //OrientQuat = TargetOrient.Quaternion();
-        FQuat AngularVelocityQuat = (ProposedMove.AngularVelocity * DeltaSeconds).Quaternion();
-        OrientQuat = OrientQuat * AngularVelocityQuat;
+        FQuat AngularVelocityQuat = Math.RotatorToQuat(ProposedMove.AngularVelocity * DeltaSeconds);
+        OrientQuat = Math.Multiply(OrientQuat, AngularVelocityQuat);
 	}
 
     FVector CurrentUp = GetMoverComponent()->GetOwner()->GetActorUpVector();
     FVector GravityUp = CurrentUp;
 
-	if (CurrentFloor.HitResult.IsValidBlockingHit())
+	if (bPredictedContactFar)
+	{
+		GravityUp = PredictedContact.PlaneNormal;
+	}
+	else if (CurrentFloor.HitResult.IsValidBlockingHit())
     {
         GravityUp = CurrentFloor.HitResult.ImpactNormal;
     }
@@ -209,6 +272,22 @@ void UMoonshotMoverAttachingMode::OnSimulationTick(const FSimulationTickParams&
 		{
 
 			GravityUp = Hit.ImpactNormal;
+
+			// Only static surfaces can be predicted; anything that moves needs the per-tick queries
+			const UPrimitiveComponent* HitComponent = Hit.GetComponent();
+			if (CommonMovementSettings->bUsePredictedContact && HitComponent && HitComponent->Mobility == EComponentMobility::Static)
+			{
+				FMoonshotMoverPredictedContact NewContact;
+				NewContact.PlanePoint = Hit.ImpactPoint;
+				NewContact.PlaneNormal = Hit.ImpactNormal;
+				// Bounding sphere radius is conservative for any orientation of the collision shape
+				NewContact.ContactOffset = UpdatedPrimitive->Bounds.SphereRadius;
+				SimBlackboard->Set(MoonshotBlackboard::PredictedContact, NewContact);
+			}
+			else
+			{
+				SimBlackboard->Invalidate(MoonshotBlackboard::PredictedContact);
+			}
 		}
 		else
 		{
@@ -217,36 +296,63 @@ void UMoonshotMoverAttachingMode::OnSimulationTick(const FSimulationTickParams&
 		}
 	}
 
-    FQuat GravityQuat = FQuat::FindBetweenNormals(CurrentUp, GravityUp);
-    OrientQuat = GravityQuat * OrientQuat;
+    FQuat GravityQuat = Math.FindBetweenNormals(CurrentUp, GravityUp);
+    OrientQuat = Math.Multiply(GravityQuat, OrientQuat);
 
 
-    OrientQuat.Normalize();
+    OrientQuat = Math.GetNormalized(OrientQuat);
 	
 	FVector MoveDelta = ProposedMove.LinearVelocity * DeltaSeconds;
 
 
 	FHitResult Hit(1.f);
 
+	// Fast falls are split so each sweep covers at most a fraction of our collider, and always split when the attach surface is predicted to be reached this tick
+	int32 NumSubsteps = 1;
+	if (CommonMovementSettings->bEnableAdaptiveSubstepping && !TickScope.IsReducedCost())
+	{
+		NumSubsteps = (TimeToImpact <= DeltaSeconds)
+			? CommonMovementSettings->MaxSubsteps
+			: UMoonshotMoverUtils::ComputeNumSubsteps(MoveDelta, UpdatedPrimitive, CommonMovementSettings->SubstepDistanceRadiusFraction, CommonMovementSettings->MaxSubsteps);
+	}
+	int32 HitSubstep = 0;
+
 	if (!MoveDelta.IsNearlyZero() || !ProposedMove.AngularVelocity.IsNearlyZero())
 	{
-		UMovementUtils::TrySafeMoveUpdatedComponent(UpdatedComponent, UpdatedPrimitive, MoveDelta, OrientQuat, true, Hit, ETeleportType::None, MoveRecord);
+		const FVector SubstepDelta = MoveDelta / NumSubsteps;
+
+		for (HitSubstep = 0; HitSubstep < NumSubsteps; ++HitSubstep)
+		{
+			const bool bIsLastSubstep = (HitSubstep == NumSubsteps - 1);
+			const FQuat SubstepQuat = bIsLastSubstep ? OrientQuat : Math.Slerp(StartQuat, OrientQuat, float(HitSubstep + 1) / NumSubsteps);
+
+			UMovementUtils::TrySafeMoveUpdatedComponent(UpdatedComponent, UpdatedPrimitive, SubstepDelta, SubstepQuat, true, Hit, ETeleportType::None, MoveRecord);
+
+			if (Hit.IsValidBlockingHit())
+			{
+				break;
+			}
+		}
 	}
 
     FFloorCheckResult LandingFloor;
 
 	if (Hit.IsValidBlockingHit() && UpdatedPrimitive)
 	{   
+        // Something got in the way before the predicted contact, so the prediction no longer describes this fall
+        SimBlackboard->Invalidate(MoonshotBlackboard::PredictedContact);
+
         float LastMoveTimeSlice = DeltaSeconds;
 		float SubTimeTickRemaining = LastMoveTimeSlice * (1.f - Hit.Time);
 
-        PctTimeApplied += Hit.Time * (1.f - PctTimeApplied);
+        PctTimeApplied = (float(HitSubstep) + Hit.Time) / NumSubsteps;
 
-        if (UAttachingModeUtils::IsValidLandingSpot(UpdatedComponent, UpdatedPrimitive, UpdatedPrimitive->GetComponentLocation(),
+        if (FAttachingFallAlongSurface::IsValidLandingSpot(UpdatedComponent, UpdatedPrimitive, UpdatedPrimitive->GetComponentLocation(),
             Hit, CommonMovementSettings->FloorSweepDistance, CommonMovementSettings->MaxWalkSlopeCosine, OUT LandingFloor))
         {
             //UE_LOG(LogTemp, Warning, TEXT("WE got a valid landing spot!"));
             CaptureFinalState(UpdatedComponent, *StartingSyncState, LandingFloor, DeltaSeconds, DeltaSeconds * PctTimeApplied, OutputSyncState, OutputState, MoveRecord);
+            FMoonshotDeterministicMath::LogSyncStateChecksum(GetMoverComponent(), Params.TimeStep, OutputSyncState);
             return;
         }
 
@@ -256,17 +362,19 @@ void UMoonshotMoverAttachingMode::OnSimulationTick(const FSimulationTickParams&
 
 		UMoverComponent* MoverComponent = GetMoverComponent();
 		//FMoverOnImpactParams ImpactParams(DefaultModeNames::Flying, Hit, MoveDelta);
-		FMoverOnImpactParams ImpactParams(FName("ZeroG"), Hit, MoveDelta);
+		FMoverOnImpactParams ImpactParams(MoonshotModeNames::ZeroG, Hit, MoveDelta);
 		MoverComponent->HandleImpact(ImpactParams);
 		// Try to slide the remaining distance along the surface.
         //UE_LOG(LogTemp, Display, TEXT("Not a valid landing spot, trying to slide."));
-		UMovementUtils::TryMoveToSlideAlongSurface(UpdatedComponent, UpdatedPrimitive, MoverComponent, MoveDelta, 1.f - Hit.Time, OrientQuat, Hit.Normal, Hit, true, MoveRecord);
+		const float PctOfDeltaRemaining = (float(NumSubsteps - HitSubstep) - Hit.Time) / NumSubsteps;
+		UMovementUtils::TryMoveToSlideAlongSurface(UpdatedComponent, UpdatedPrimitive, MoverComponent, MoveDelta, PctOfDeltaRemaining, OrientQuat, Hit.Normal, Hit, true, MoveRecord);
 
         PctTimeApplied += Hit.Time * (1.f - PctTimeApplied);
 
         if (LandingFloor.IsWalkableFloor())
         {
             CaptureFinalState(UpdatedComponent, *StartingSyncState, LandingFloor, DeltaSeconds, DeltaSeconds * PctTimeApplied, OutputSyncState, OutputState, MoveRecord);
+            FMoonshotDeterministicMath::LogSyncStateChecksum(GetMoverComponent(), Params.TimeStep, OutputSyncState);
             return;
         }
 	}
@@ -277,6 +385,7 @@ void UMoonshotMoverAttachingMode::OnSimulationTick(const FSimulationTickParams&
     }
 
 	CaptureFinalState(UpdatedComponent, *StartingSyncState, LandingFloor, DeltaSeconds, DeltaSeconds* PctTimeApplied, OutputSyncState, OutputState, MoveRecord);
+	FMoonshotDeterministicMath::LogSyncStateChecksum(GetMoverComponent(), Params.TimeStep, OutputSyncState);
 }
 
 
@@ -294,6 +403,8 @@ bool UMoonshotMoverAttachingMode::AttemptTeleport(USceneComponent* UpdatedCompon
 		UpdatedComponent->ComponentVelocity = StartingSyncState.GetVelocity_WorldSpace();
 
 		GetBlackboard_Mutable()->Invalidate(CommonBlackboard::LastFloorResult);
+		GetBlackboard_Mutable()->Invalidate(MoonshotBlackboard::PredictedContact);
+		GetBlackboard_Mutable()->Invalidate(MoonshotBlackboard::FloorHandoff);
 
 		return true;
 	}
@@ -306,6 +417,8 @@ void UMoonshotMoverAttachingMode::ProcessLanded(const FFloorCheckResult& FloorRe
     UMoverBlackboard* SimBlackboard = GetBlackboard_Mutable();
 	FName NextMovementMode = NAME_None; 
 
+	SimBlackboard->Invalidate(MoonshotBlackboard::PredictedContact);
+
 	//UE_LOG(LogTemp, Warning, TEXT("ProcessLanded: FloorResult.IsWalkableFloor? %s"), FloorResult.IsWalkableFloor() ? TEXT("true") : TEXT("false"));
 
     if (FloorResult.IsWalkableFloor())
@@ -358,6 +471,7 @@ void UMoonshotMoverAttachingMode::CaptureFinalState(USceneComponent* UpdatedComp
 
     //UE_LOG(LogTemp, Warning, TEXT("About to process landed with FloorResult.IsWalkableFloor? %s"), FloorResult.IsWalkableFloor() ? TEXT("true") : TEXT("false"));
 	ProcessLanded(FloorResult, EffectiveVelocity, MovementBaseInfo, TickEndData);
+	FMoonshotMoverFloorHandoff::Publish(SimBlackboard, CommonMovementSettings->AirMovementModeName, FloorResult, MovementBaseInfo, FinalLocation);
 
 	if (MovementBaseInfo.HasRelativeInfo())
 	{
@@ -383,6 +497,9 @@ void UMoonshotMoverAttachingMode::OnRegistered(const FName ModeName)
 {
 	Super::OnRegistered(ModeName);
 
+	// Resolve our handle now so mode checks elsewhere never touch the name table
+	FMoonshotMoverModeRegistry::Get().Register(ModeName);
+
 	CommonMovementSettings = GetMoverComponent()->FindSharedSettings<UMoonshotMoverCommonMovementSettings>();
 	ensureMsgf(CommonMovementSettings, TEXT("Failed to find instance of MoonshotMoverCommonMovementSettings on %s. Movement may not function properly."), *GetPathNameSafe(this));
 }
@@ -396,98 +513,45 @@ void UMoonshotMoverAttachingMode::OnUnregistered()
 
 bool UAttachingModeUtils::IsValidLandingSpot(USceneComponent* UpdatedComponent, UPrimitiveComponent* UpdatedPrimitive, const FVector& Location, const FHitResult& Hit, float FloorSweepDistance, float WalkableFloorZ, FFloorCheckResult& OutFloorResult)
 {
-	OutFloorResult.Clear();
-
-	if (!Hit.bBlockingHit)
-	{
-		return false;
-	}
-
-	if (Hit.bStartPenetrating)
-	{
-		return false;
-	}
-
-	// Reject unwalkable floor normals.
-	if (!UMoonshotMoverUtils::IsHitSurfaceWalkable(Hit, WalkableFloorZ, UpdatedComponent))
-	{
-		return false;
-	}
-
-	// Make sure floor test passes here.
-	UMoonshotMoverUtils::FindFloor(UpdatedComponent, UpdatedPrimitive, 
-		FloorSweepDistance, WalkableFloorZ,
-		Location, OutFloorResult);
-
-	if (!OutFloorResult.IsWalkableFloor())
-	{
-		return false;
-	}
-
-	return true;
+	return FAttachingFallAlongSurface::IsValidLandingSpot(UpdatedComponent, UpdatedPrimitive, Location, Hit, FloorSweepDistance, WalkableFloorZ, OutFloorResult);
 }
 
 float UAttachingModeUtils::TryMoveToFallAlongSurface(USceneComponent* UpdatedComponent, UPrimitiveComponent* UpdatedPrimitive, UMoverComponent* MoverComponent, const FVector& Delta, float PctOfDeltaToMove, const FQuat Rotation, const FVector& Normal, FHitResult& Hit, bool bHandleImpact, float FloorSweepDistance, float MaxWalkSlopeCosine, FFloorCheckResult& OutFloorResult, FMovementRecord& MoveRecord)
 {
-	OutFloorResult.Clear();
+	return FAttachingFallAlongSurface::TryMoveToFallAlongSurface(UpdatedComponent, UpdatedPrimitive, MoverComponent, Delta, PctOfDeltaToMove, Rotation, Normal, Hit, bHandleImpact, FloorSweepDistance, MaxWalkSlopeCosine, OutFloorResult, MoveRecord);
+}
 
-	if (!Hit.bBlockingHit)
+float UAttachingModeUtils::ComputeTimeToImpact(float Height, float NormalVelocity, float NormalAcceleration)
+{
+	if (Height <= 0.f)
 	{
 		return 0.f;
 	}
 
-	float PctOfTimeUsed = 0.f;
-	const FVector OldHitNormal = Normal;
-
-	FVector SlideDelta = UMovementUtils::ComputeSlideDelta(Delta, PctOfDeltaToMove, Normal, Hit);
-
-	if ((SlideDelta | Delta) > 0.f)
+	// No acceleration along the normal: straight line
+	if (FMath::IsNearlyZero(NormalAcceleration))
 	{
-		// First sliding attempt along surface
-		UMovementUtils::TrySafeMoveUpdatedComponent(UpdatedComponent, UpdatedPrimitive, SlideDelta, Rotation, true, Hit, ETeleportType::None, MoveRecord);
+		return (NormalVelocity < 0.f) ? (-Height / NormalVelocity) : UE_BIG_NUMBER;
+	}
 
-		PctOfTimeUsed = Hit.Time;
-		if (Hit.IsValidBlockingHit())
-		{
-			// Notify first impact
-			if (MoverComponent && bHandleImpact)
-			{
-				FMoverOnImpactParams ImpactParams(NAME_None, Hit, SlideDelta);
-				MoverComponent->HandleImpact(ImpactParams);
-			}
+	const float Discriminant = FMath::Square(NormalVelocity) - 2.f * NormalAcceleration * Height;
+	if (Discriminant < 0.f)
+	{
+		// Turns around before reaching the plane
+		return UE_BIG_NUMBER;
+	}
 
-			// Check if we landed
-			if (!UAttachingModeUtils::IsValidLandingSpot(UpdatedComponent, UpdatedPrimitive, UpdatedPrimitive->GetComponentLocation(),
-				Hit, FloorSweepDistance, MaxWalkSlopeCosine, OutFloorResult))
-			{
-				// We've hit another surface during our first move, so let's try to slide along both of them together
-
-				// Compute new slide normal when hitting multiple surfaces.
-				SlideDelta = UMovementUtils::ComputeTwoWallAdjustedDelta(SlideDelta, Hit, OldHitNormal);
-
-				// Only proceed if the new direction is of significant length and not in reverse of original attempted move.
-				if (!SlideDelta.IsNearlyZero(SMALL_MOVE_DISTANCE) && (SlideDelta | Delta) > 0.f)
-				{
-					// Perform second move, taking 2 walls into account
-					UMovementUtils::TrySafeMoveUpdatedComponent(UpdatedComponent, UpdatedPrimitive, SlideDelta, Rotation, true, Hit, ETeleportType::None, MoveRecord);
-					PctOfTimeUsed += (Hit.Time * (1.f - PctOfTimeUsed));
-
-					// Notify second impact
-					if (MoverComponent && bHandleImpact && Hit.bBlockingHit)
-					{
-						FMoverOnImpactParams ImpactParams(NAME_None, Hit, SlideDelta);
-						MoverComponent->HandleImpact(ImpactParams);
-					}
-
-					// Check if we've landed, to acquire floor result
-					UAttachingModeUtils::IsValidLandingSpot(UpdatedComponent, UpdatedPrimitive, UpdatedPrimitive->GetComponentLocation(),
-						Hit, FloorSweepDistance, MaxWalkSlopeCosine, OutFloorResult);
-				}
-			}
-		}
+	// Smallest positive root of Height + v*t + 0.5*a*t^2
+	const float SqrtDiscriminant = FMath::Sqrt(Discriminant);
+	const float RootA = (-NormalVelocity - SqrtDiscriminant) / NormalAcceleration;
+	const float RootB = (-NormalVelocity + SqrtDiscriminant) / NormalAcceleration;
+	const float FirstRoot = FMath::Min(RootA, RootB);
+	const float SecondRoot = FMath::Max(RootA, RootB);
 
-		return FMath::Clamp(PctOfTimeUsed, 0.f, 1.f);
+	if (FirstRoot > 0.f)
+	{
+		return FirstRoot;
 	}
 
-	return 0.f;
-}
\ No newline at end of file
+	return (SecondRoot > 0.f) ? SecondRoot : UE_BIG_NUMBER;
+}
@@ -1,11 +1,149 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 
 #include "MoonshotMoverDataModelTypes.h"
+#include "MoonshotMoverCommonMovementSettings.h"
+#include "MoonshotMoverInputBaselines.h"
+#include "MoonshotMoverModeRegistry.h"
+#include "MoonshotMoverNetProfiler.h"
+#include "MoonshotMoverNetQuantize.h"
 #include "Mover/Public/MoverTypes.h"
 #include "Mover/Public/MoverDataModelTypes.h"
 #include "Components/PrimitiveComponent.h"
 #include "Mover/Public/MoveLibrary/BasedMovementUtils.h"
 #include "Mover/Public/MoverLog.h"
+#include "Mover/Public/MoveLibrary/MoverBlackboard.h"
+#include "HAL/IConsoleManager.h"
+
+namespace MoonshotMoverInputs
+{
+	static bool bCompactInputs = true;
+	static FAutoConsoleVariableRef CVarCompactInputs(
+		TEXT("moonshot.Mover.CompactInputs"),
+		bCompactInputs,
+		TEXT("Send FMoonshotMoverCharacterInputs with the compact quantization profile. Receivers accept both profiles."));
+
+	static bool bSendInputGravity = false;
+	static FAutoConsoleVariableRef CVarSendInputGravity(
+		TEXT("moonshot.Mover.SendInputGravity"),
+		bSendInputGravity,
+		TEXT("Send FMoonshotMoverCharacterInputs::GravityAcceleration. Off by default: the modes derive gravity on both ends. Only useful with bAcceptInputGravity."));
+
+	// Gravity as it goes on the wire
+	FVector GetWireGravity(const FMoonshotMoverCharacterInputs& Inputs)
+	{
+		return bSendInputGravity ? Inputs.GravityAcceleration : FVector::ZeroVector;
+	}
+
+	static int32 InputRedundancy = 3;
+	static FAutoConsoleVariableRef CVarInputRedundancy(
+		TEXT("moonshot.Mover.InputRedundancy"),
+		InputRedundancy,
+		TEXT("Number of earlier unacknowledged input commands resent with each compact input (0-7), so the server can repair lost packets."));
+
+	constexpr int32 MaxInputRedundancy = 7;
+	constexpr int32 RedundancyBits = 3;
+
+	static bool bDeltaInputs = true;
+	static FAutoConsoleVariableRef CVarDeltaInputs(
+		TEXT("moonshot.Mover.DeltaInputs"),
+		bDeltaInputs,
+		TEXT("Within the compact profile, start the command chain from the last input the receiver acknowledged instead of a keyframe."));
+
+	// Fields covered by the change mask of a delta-encoded command. Jump flags and the movement base are always sent.
+	enum EDeltaField : uint32
+	{
+		GravityField			= 1 << 0,
+		MoveInputField			= 1 << 1,
+		OrientationIntentField	= 1 << 2,
+		ControlRotationField	= 1 << 3,
+		AngularVelocityField	= 1 << 4,
+		SuggestedModeField		= 1 << 5,
+
+		AllFields				= (1 << 6) - 1
+	};
+	constexpr int32 NumDeltaFields = 6;
+
+	// Exact comparison: equal values always quantize to equal bits, so the receiver's copy of the baseline field is what it would have decoded
+	uint32 GetChangedFields(const FMoonshotMoverCharacterInputs& Inputs, const FMoonshotMoverCharacterInputs& Baseline)
+	{
+		uint32 Changed = 0;
+		Changed |= (GetWireGravity(Inputs) != GetWireGravity(Baseline)) ? GravityField : 0;
+		Changed |= (Inputs.GetMoveInputType() != Baseline.GetMoveInputType() || Inputs.GetMoveInput() != Baseline.GetMoveInput()) ? MoveInputField : 0;
+		Changed |= (Inputs.OrientationIntent != Baseline.OrientationIntent) ? OrientationIntentField : 0;
+		Changed |= (Inputs.AngularVelocity != Baseline.AngularVelocity) ? AngularVelocityField : 0;
+		Changed |= (Inputs.SuggestedMovementMode != Baseline.SuggestedMovementMode) ? SuggestedModeField : 0;
+
+		// Control rotation is encoded relative to gravity, so it has to be resent whenever gravity changes
+		Changed |= (Inputs.ControlRotation != Baseline.ControlRotation || (Changed & GravityField)) ? ControlRotationField : 0;
+		return Changed;
+	}
+}
+
+bool FMoonshotMoverFloorHandoff::IsValidAt(const FVector& Location, float Tolerance) const
+{
+	if (!Floor.IsWalkableFloor() || !Floor.HitResult.GetComponent())
+	{
+		return false;
+	}
+
+	if (FVector::DistSquared(Location, ValidatedLocation) > FMath::Square(Tolerance))
+	{
+		return false;
+	}
+
+	// A dynamic base that has moved since validation invalidates the contact
+	if (BaseInfo.HasRelativeInfo())
+	{
+		const UPrimitiveComponent* BaseComponent = BaseInfo.MovementBase.Get();
+		if (!BaseComponent || BaseInfo.BoneName != NAME_None
+			|| !BaseComponent->GetComponentLocation().Equals(BaseInfo.Location)
+			|| !BaseComponent->GetComponentQuat().Equals(BaseInfo.Rotation))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void FMoonshotMoverFloorHandoff::Publish(UMoverBlackboard* SimBlackboard, FName SourceModeName, const FFloorCheckResult& Floor, const FRelativeBaseInfo& BaseInfo, const FVector& Location)
+{
+	if (!SimBlackboard || !Floor.IsWalkableFloor())
+	{
+		return;
+	}
+
+	FMoonshotMoverFloorHandoff Handoff;
+	Handoff.Floor = Floor;
+	Handoff.BaseInfo = BaseInfo;
+	Handoff.ContactNormal = Floor.HitResult.ImpactNormal;
+	Handoff.ValidatedLocation = Location;
+	Handoff.SourceModeName = SourceModeName;
+
+	SimBlackboard->Set(MoonshotBlackboard::FloorHandoff, Handoff);
+}
+
+bool FMoonshotMoverFloorHandoff::TryGetValid(const UMoverBlackboard* SimBlackboard, const FVector& Location, float Tolerance, FMoonshotMoverFloorHandoff& OutHandoff)
+{
+	return SimBlackboard
+		&& SimBlackboard->TryGet(MoonshotBlackboard::FloorHandoff, OutHandoff)
+		&& OutHandoff.IsValidAt(Location, Tolerance);
+}
+
+bool FMoonshotMoverGravity::IsInputAuthored(const FMoonshotMoverCharacterInputs* Inputs, const UMoonshotMoverCommonMovementSettings& Settings)
+{
+	return Settings.bAcceptInputGravity && Inputs && !Inputs->GravityAcceleration.IsNearlyZero();
+}
+
+FVector FMoonshotMoverGravity::Resolve(const FMoverDefaultSyncState& SyncState, const FMoonshotMoverCharacterInputs* Inputs, const UMoonshotMoverCommonMovementSettings& Settings)
+{
+	if (IsInputAuthored(Inputs, Settings))
+	{
+		return Inputs->GravityAcceleration;
+	}
+
+	return -Settings.GravityMagnitude * SyncState.GetOrientation_WorldSpace().Quaternion().GetUpVector();
+}
 
 FMoverDataStructBase* FMoonshotMoverCharacterInputs::Clone() const
 {
@@ -16,19 +154,259 @@ FMoverDataStructBase* FMoonshotMoverCharacterInputs::Clone() const
 
 bool FMoonshotMoverCharacterInputs::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
 {
-	Super::NetSerialize(Ar, Map, bOutSuccess);
+	FMoonshotMoverNetProfiler::FStructScope ProfileScope(Ar, Map, TEXT("FMoonshotMoverCharacterInputs"));
+
+	// The profile travels with every input so receivers never need to agree on the setting
+	bool bCompact = Ar.IsSaving() && MoonshotMoverInputs::bCompactInputs;
+	Ar.SerializeBits(&bCompact, 1);
+
+	if (bCompact)
+	{
+		NetSerializeCompact(Ar, Map);
+	}
+	else
+	{
+		{
+			FMoonshotMoverNetProfiler::FFieldScope ProfileField(Ar, TEXT("Base"));
+			Super::NetSerialize(Ar, Map, bOutSuccess);
+		}
 
-    SerializePackedVector<100, 30>(GravityAcceleration, Ar);
-    AngularVelocity.SerializeCompressedShort(Ar);
+		{
+			FMoonshotMoverNetProfiler::FFieldScope ProfileField(Ar, TEXT("Sequence"));
+			uint32 Sequence = InputSequence;
+			Ar.SerializeBits(&Sequence, FMoonshotMoverInputBaselines::SequenceBits);
+			InputSequence = static_cast<uint8>(Sequence);
+		}
 
-    bOutSuccess = true;
+		{
+			FMoonshotMoverNetProfiler::FFieldScope ProfileField(Ar, TEXT("Gravity"));
+			FVector WireGravity = Ar.IsSaving() ? MoonshotMoverInputs::GetWireGravity(*this) : FVector::ZeroVector;
+			SerializePackedVector<100, 30>(WireGravity, Ar);
+			GravityAcceleration = Ar.IsLoading() ? WireGravity : GravityAcceleration;
+		}
+
+		{
+			FMoonshotMoverNetProfiler::FFieldScope ProfileField(Ar, TEXT("AngularVelocity"));
+			AngularVelocity.SerializeCompressedShort(Ar);
+		}
+	}
+
+    bOutSuccess = !Ar.IsError();
     return bOutSuccess;
 }
 
+void FMoonshotMoverCharacterInputs::NetSerializeCompact(FArchive& Ar, UPackageMap* Map)
+{
+	using namespace MoonshotMoverInputs;
+
+	// Header: our sequence, how many earlier commands precede us, and the acknowledged command the chain starts from
+	FMoonshotMoverCharacterInputs Baseline;
+	uint32 Sequence = InputSequence;
+	uint32 NumRedundant = 0;
+	uint32 BaselineSequence = 0;
+	bool bHasBaseline = false;
+
+	if (Ar.IsSaving() && Map)
+	{
+		FMoonshotMoverInputBaselines::RecordSent(Map, *this);
+
+		uint8 AckedSequence = 0;
+		bHasBaseline = bDeltaInputs && FMoonshotMoverInputBaselines::FindSendBaseline(Map, Baseline, AckedSequence);
+		BaselineSequence = AckedSequence;
+
+		// Resend the commands right before this one that the receiver has not acknowledged, without gaps.
+		// Only the acked autonomous stream has a history of its own; proxy inputs share the connection's.
+		const uint32 MaxRedundant = FMoonshotMoverInputBaselines::HasAcknowledged(Map) ? FMath::Clamp(InputRedundancy, 0, MaxInputRedundancy) : 0;
+		FMoonshotMoverCharacterInputs Unused;
+		while (NumRedundant < MaxRedundant)
+		{
+			const uint8 Candidate = InputSequence - static_cast<uint8>(NumRedundant + 1);
+			if ((bHasBaseline && FMoonshotMoverInputBaselines::SequenceDelta(Candidate, AckedSequence) <= 0)
+				|| !FMoonshotMoverInputBaselines::FindSent(Map, Candidate, Unused))
+			{
+				break;
+			}
+			++NumRedundant;
+		}
+	}
+
+	bool bIsMissingBaseline = false;
+	{
+		FMoonshotMoverNetProfiler::FFieldScope ProfileField(Ar, TEXT("Header"));
+		Ar.SerializeBits(&Sequence, FMoonshotMoverInputBaselines::SequenceBits);
+		Ar.SerializeBits(&NumRedundant, RedundancyBits);
+		Ar.SerializeBits(&bHasBaseline, 1);
+
+		if (bHasBaseline)
+		{
+			Ar.SerializeBits(&BaselineSequence, FMoonshotMoverInputBaselines::SequenceBits);
+
+			if (Ar.IsLoading())
+			{
+				bIsMissingBaseline = !Map || !FMoonshotMoverInputBaselines::FindReceivedBaseline(Map, static_cast<uint8>(BaselineSequence), Baseline);
+				if (bIsMissingBaseline)
+				{
+					// The bits still have to be read to stay aligned, so decode against the closest command we do hold.
+					// Nothing decoded this way is recorded as a baseline or for input repair.
+					uint8 FallbackSequence = 0;
+					if (Map && FMoonshotMoverInputBaselines::FindNewestReceived(Map, Baseline, FallbackSequence))
+					{
+						UE_LOG(LogMover, Warning, TEXT("Input %u is a delta against %u, which is no longer held. Unchanged fields are taken from input %u instead."), Sequence, BaselineSequence, FallbackSequence);
+					}
+					else
+					{
+						UE_LOG(LogMover, Warning, TEXT("Input %u is a delta against %u, and no earlier input is held. Unchanged fields decode as zero."), Sequence, BaselineSequence);
+					}
+				}
+			}
+		}
+	}
+
+	const bool bShouldRecord = Ar.IsLoading() && Map && !bIsMissingBaseline;
+
+	// Earlier commands, each a delta against the one before it. The receiver only files them for FMoonshotMoverInputRepair.
+	FMoonshotMoverCharacterInputs Redundant[MaxInputRedundancy];
+	const FMoonshotMoverCharacterInputs* Previous = bHasBaseline ? &Baseline : nullptr;
+
+	for (uint32 Index = 0; Index < NumRedundant && Index < MaxInputRedundancy; ++Index)
+	{
+		FMoonshotMoverCharacterInputs& Command = Redundant[Index];
+		const uint8 CommandSequence = static_cast<uint8>(Sequence - NumRedundant + Index);
+
+		if (Ar.IsSaving())
+		{
+			FMoonshotMoverInputBaselines::FindSent(Map, CommandSequence, Command);
+		}
+		Command.InputSequence = CommandSequence;
+		{
+			FMoonshotMoverNetProfiler::FStructScope ProfileScope(Ar, Map, TEXT("FMoonshotMoverCharacterInputs.Redundant"));
+			Command.SerializeCommandFields(Ar, Previous);
+		}
+
+		if (bShouldRecord && !Ar.IsError())
+		{
+			FMoonshotMoverInputBaselines::RecordReceived(Map, CommandSequence, Command);
+		}
+		Previous = &Command;
+	}
+
+	InputSequence = static_cast<uint8>(Sequence);
+	SerializeCommandFields(Ar, Previous);
+
+	if (bShouldRecord && !Ar.IsError())
+	{
+		FMoonshotMoverInputBaselines::RecordReceived(Map, InputSequence, *this);
+	}
+}
+
+void FMoonshotMoverCharacterInputs::SerializeCommandFields(FArchive& Ar, const FMoonshotMoverCharacterInputs* Previous)
+{
+	using namespace MoonshotMoverInputs;
+
+	uint32 ChangedFields = AllFields;
+
+	if (Previous)
+	{
+		if (Ar.IsSaving())
+		{
+			ChangedFields = GetChangedFields(*this, *Previous);
+		}
+		FMoonshotMoverNetProfiler::FFieldScope ProfileField(Ar, TEXT("ChangeMask"));
+		Ar.SerializeBits(&ChangedFields, NumDeltaFields);
+
+		if (Ar.IsLoading())
+		{
+			// Start from the previous command; the changed fields below overwrite it
+			GravityAcceleration = Previous->GravityAcceleration;
+			SetMoveInput(Previous->GetMoveInputType(), Previous->GetMoveInput());
+			OrientationIntent = Previous->OrientationIntent;
+			ControlRotation = Previous->ControlRotation;
+			AngularVelocity = Previous->AngularVelocity;
+			SuggestedMovementMode = Previous->SuggestedMovementMode;
+		}
+	}
+
+	// Gravity first: the control rotation below is encoded relative to it
+	FVector WireGravity = Ar.IsSaving() ? GetWireGravity(*this) : GravityAcceleration;
+	if (ChangedFields & GravityField)
+	{
+		FMoonshotMoverNetProfiler::FFieldScope ProfileField(Ar, TEXT("Gravity"));
+		FMoonshotMoverNetQuantize::SerializeGravity(Ar, WireGravity);
+		GravityAcceleration = Ar.IsLoading() ? WireGravity : GravityAcceleration;
+	}
+
+	if (ChangedFields & MoveInputField)
+	{
+		FMoonshotMoverNetProfiler::FFieldScope ProfileField(Ar, TEXT("MoveInput"));
+		uint32 InputType = static_cast<uint32>(GetMoveInputType());
+		Ar.SerializeBits(&InputType, 2);
+
+		FVector Input = GetMoveInput();
+		bool bHasMoveInput = Ar.IsSaving() && !Input.IsZero();
+		Ar.SerializeBits(&bHasMoveInput, 1);
+		if (bHasMoveInput)
+		{
+			// Same precision SetMoveInput stores
+			SerializePackedVector<100, 30>(Input, Ar);
+		}
+
+		if (Ar.IsLoading())
+		{
+			SetMoveInput(static_cast<EMoveInputType>(InputType), bHasMoveInput ? Input : FVector::ZeroVector);
+		}
+	}
+
+	if (ChangedFields & OrientationIntentField)
+	{
+		FMoonshotMoverNetProfiler::FFieldScope ProfileField(Ar, TEXT("OrientationIntent"));
+		FMoonshotMoverNetQuantize::SerializeDirectionWithZeroFlag(Ar, OrientationIntent);
+	}
+
+	if (ChangedFields & ControlRotationField)
+	{
+		FMoonshotMoverNetProfiler::FFieldScope ProfileField(Ar, TEXT("ControlRotation"));
+		FMoonshotMoverNetQuantize::SerializeGravityRelativeRotation(Ar, ControlRotation, WireGravity);
+	}
+
+	if (ChangedFields & AngularVelocityField)
+	{
+		FMoonshotMoverNetProfiler::FFieldScope ProfileField(Ar, TEXT("AngularVelocity"));
+		FMoonshotMoverNetQuantize::SerializeRotatorWithZeroFlag(Ar, AngularVelocity);
+	}
+
+	if (ChangedFields & SuggestedModeField)
+	{
+		FMoonshotMoverNetProfiler::FFieldScope ProfileField(Ar, TEXT("SuggestedMode"));
+		FMoonshotMoverModeHandle::NetSerializeModeName(Ar, SuggestedMovementMode);
+	}
+
+	// Cheaper to send than to flag
+	{
+		FMoonshotMoverNetProfiler::FFieldScope ProfileField(Ar, TEXT("Jump"));
+		Ar.SerializeBits(&bIsJumpPressed, 1);
+		Ar.SerializeBits(&bIsJumpJustPressed, 1);
+	}
+
+	// Always sent in full: stored commands only hold the base weakly, so it may be gone by the time a later command deltas against it
+	FMoonshotMoverNetProfiler::FFieldScope ProfileField(Ar, TEXT("MovementBase"));
+	Ar.SerializeBits(&bUsingMovementBase, 1);
+	if (bUsingMovementBase)
+	{
+		Ar << MovementBase;
+		Ar << MovementBaseBoneName;
+	}
+	else if (Ar.IsLoading())
+	{
+		MovementBase = nullptr;
+		MovementBaseBoneName = NAME_None;
+	}
+}
+
 void FMoonshotMoverCharacterInputs::ToString(FAnsiStringBuilderBase& Out) const
 {
 	Super::ToString(Out);
 
+    Out.Appendf("InputSequence: %u\n", InputSequence);
     Out.Appendf("GravityAcceleration: X=%.2f Y=%.2f Z=%.2f\n", GravityAcceleration.X, GravityAcceleration.Y, GravityAcceleration.Z);
     Out.Appendf("AngularVelocity: P=%.2f Y=%.2f R=%.2f\n", AngularVelocity.Pitch, AngularVelocity.Yaw, AngularVelocity.Roll);
 }
\ No newline at end of file
@@ -0,0 +1,374 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "MoonshotMoverDeterministicMath.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/Crc.h"
+#include "Mover/Public/MoverComponent.h"
+#include "Mover/Public/MoverLog.h"
+#include "Mover/Public/MoverSimulationTypes.h"
+
+// Everything in this file must round identically everywhere: no fused multiply-adds, no reassociation.
+// Pushed here and popped at the end so unity builds do not carry the settings into the next file of the blob.
+#if defined(__clang__)
+#pragma float_control(precise, on, push)
+#pragma clang fp contract(off)
+#pragma clang fp reassociate(off)
+#elif defined(_MSC_VER)
+#pragma float_control(precise, on, push)
+#pragma fp_contract(off)
+#endif
+
+namespace MoonshotDeterministicMath
+{
+	static bool bLogSyncChecksums = false;
+	static FAutoConsoleVariableRef CVarLogSyncChecksums(
+		TEXT("moonshot.Mover.LogSyncChecksums"),
+		bLogSyncChecksums,
+		TEXT("Log a checksum of the Mover sync state after every simulation tick, to diff client and server runs of the same inputs."));
+
+	constexpr double Pi = 3.14159265358979311600e+00;
+	constexpr double HalfPi = 1.57079632679489655800e+00;
+	constexpr double DegToRad = Pi / 180.0;
+	constexpr double RadToDeg = 180.0 / Pi;
+
+	// Pi/2 split in two so the range reduction in SinCos stays exact for moderately large angles (fdlibm pio2_1, pio2_1t)
+	constexpr double HalfPiHi = 1.57079632673412561417e+00;
+	constexpr double HalfPiLo = 6.07710050650619224932e-11;
+	constexpr double TwoOverPi = 6.36619772367581382433e-01;
+
+	// Minimax polynomials on [-Pi/4, Pi/4] (fdlibm __kernel_sin/__kernel_cos)
+	double KernelSin(double X)
+	{
+		const double Z = X * X;
+		const double R = 8.33333333332248946124e-03 + Z * (-1.98412698298579493134e-04 + Z * (2.75573137070700676789e-06 + Z * (-2.50507602534068634195e-08 + Z * 1.58969099521155010221e-10)));
+		return X + (X * Z) * (-1.66666666666666324348e-01 + Z * R);
+	}
+
+	double KernelCos(double X)
+	{
+		const double Z = X * X;
+		const double R = Z * (4.16666666666666019037e-02 + Z * (-1.38888888888741095749e-03 + Z * (2.48015872894767294178e-05 + Z * (-2.75573143513906633035e-07 + Z * (2.08757232129817482790e-09 + Z * -1.13596475577881948265e-11)))));
+		return (1.0 - 0.5 * Z) + Z * R;
+	}
+
+	// atan on [0, inf) (fdlibm s_atan)
+	double AtanPositive(double X)
+	{
+		static constexpr double AtanHi[] = { 4.63647609000806093515e-01, 7.85398163397448278999e-01, 9.82793723247329054082e-01, 1.57079632679489655800e+00 };
+		static constexpr double AtanLo[] = { 2.26987774529616870924e-17, 3.06161699786838301793e-17, 1.39033110312309984516e-17, 6.12323399573676603587e-17 };
+
+		int32 Id;
+		if (X < 0.4375)
+		{
+			Id = -1;
+		}
+		else if (X < 0.6875)
+		{
+			Id = 0;
+			X = (2.0 * X - 1.0) / (2.0 + X);
+		}
+		else if (X < 1.1875)
+		{
+			Id = 1;
+			X = (X - 1.0) / (X + 1.0);
+		}
+		else if (X < 2.4375)
+		{
+			Id = 2;
+			X = (X - 1.5) / (1.0 + 1.5 * X);
+		}
+		else
+		{
+			Id = 3;
+			X = -1.0 / X;
+		}
+
+		const double Z = X * X;
+		const double W = Z * Z;
+		const double S1 = Z * (3.33333333333329318027e-01 + W * (1.42857142725034663711e-01 + W * (9.09088713343650656196e-02 + W * (6.66107313738753120669e-02 + W * (4.97687799461593236017e-02 + W * 1.62858201153657823623e-02)))));
+		const double S2 = W * (-1.99999999998764832476e-01 + W * (-1.11111104054623557880e-01 + W * (-7.69187620504482999495e-02 + W * (-5.83357013379057348645e-02 + W * -3.65315727442169155270e-02))));
+
+		if (Id < 0)
+		{
+			return X - X * (S1 + S2);
+		}
+		return AtanHi[Id] - ((X * (S1 + S2) - AtanLo[Id]) - X);
+	}
+
+	// Same result as FRotator::NormalizeAxis, computed without fmod
+	double NormalizeAxis(double Angle)
+	{
+		Angle = Angle - 360.0 * FMath::FloorToDouble(Angle / 360.0);
+		return (Angle > 180.0) ? Angle - 360.0 : Angle;
+	}
+}
+
+void FMoonshotDeterministicMath::SinCos(double Radians, double& OutSin, double& OutCos)
+{
+	using namespace MoonshotDeterministicMath;
+
+	const double Quadrant = FMath::FloorToDouble(Radians * TwoOverPi + 0.5);
+	const double R = (Radians - Quadrant * HalfPiHi) - Quadrant * HalfPiLo;
+	const double S = KernelSin(R);
+	const double C = KernelCos(R);
+
+	switch (static_cast<int64>(Quadrant) & 3)
+	{
+	case 0: OutSin = S; OutCos = C; break;
+	case 1: OutSin = C; OutCos = -S; break;
+	case 2: OutSin = -S; OutCos = -C; break;
+	default: OutSin = -C; OutCos = S; break;
+	}
+}
+
+double FMoonshotDeterministicMath::Atan2(double Y, double X)
+{
+	using namespace MoonshotDeterministicMath;
+
+	if (X == 0.0)
+	{
+		return (Y > 0.0) ? HalfPi : ((Y < 0.0) ? -HalfPi : 0.0);
+	}
+
+	const double Angle = AtanPositive(FMath::Abs(Y) / FMath::Abs(X));
+	if (X > 0.0)
+	{
+		return (Y < 0.0) ? -Angle : Angle;
+	}
+	return (Y < 0.0) ? -(Pi - Angle) : (Pi - Angle);
+}
+
+double FMoonshotDeterministicMath::Asin(double X)
+{
+	X = FMath::Clamp(X, -1.0, 1.0);
+	return Atan2(X, FMath::Sqrt((1.0 - X) * (1.0 + X)));
+}
+
+double FMoonshotDeterministicMath::Acos(double X)
+{
+	X = FMath::Clamp(X, -1.0, 1.0);
+	return Atan2(FMath::Sqrt((1.0 - X) * (1.0 + X)), X);
+}
+
+FQuat FMoonshotDeterministicMath::RotatorToQuat(const FRotator& Rotator)
+{
+	using namespace MoonshotDeterministicMath;
+
+	constexpr double HalfDegToRad = DegToRad * 0.5;
+
+	double SP, CP, SY, CY, SR, CR;
+	SinCos(NormalizeAxis(Rotator.Pitch) * HalfDegToRad, SP, CP);
+	SinCos(NormalizeAxis(Rotator.Yaw) * HalfDegToRad, SY, CY);
+	SinCos(NormalizeAxis(Rotator.Roll) * HalfDegToRad, SR, CR);
+
+	return FQuat(
+		 CR * SP * SY - SR * CP * CY,
+		-CR * SP * CY - SR * CP * SY,
+		 CR * CP * SY - SR * SP * CY,
+		 CR * CP * CY + SR * SP * SY);
+}
+
+FRotator FMoonshotDeterministicMath::QuatToRotator(const FQuat& Quat)
+{
+	using namespace MoonshotDeterministicMath;
+
+	// Same threshold as FQuat::Rotator
+	constexpr double SingularityThreshold = 0.4999995;
+
+	const double SingularityTest = Quat.Z * Quat.X - Quat.W * Quat.Y;
+	const double YawY = 2.0 * (Quat.W * Quat.Z + Quat.X * Quat.Y);
+	const double YawX = 1.0 - 2.0 * (Quat.Y * Quat.Y + Quat.Z * Quat.Z);
+
+	FRotator Result;
+	Result.Yaw = Atan2(YawY, YawX) * RadToDeg;
+
+	if (SingularityTest < -SingularityThreshold)
+	{
+		Result.Pitch = -90.0;
+		Result.Roll = NormalizeAxis(-Result.Yaw - 2.0 * Atan2(Quat.X, Quat.W) * RadToDeg);
+	}
+	else if (SingularityTest > SingularityThreshold)
+	{
+		Result.Pitch = 90.0;
+		Result.Roll = NormalizeAxis(Result.Yaw - 2.0 * Atan2(Quat.X, Quat.W) * RadToDeg);
+	}
+	else
+	{
+		Result.Pitch = Asin(2.0 * SingularityTest) * RadToDeg;
+		Result.Roll = Atan2(-2.0 * (Quat.W * Quat.X + Quat.Y * Quat.Z), 1.0 - 2.0 * (Quat.X * Quat.X + Quat.Y * Quat.Y)) * RadToDeg;
+	}
+
+	return Result;
+}
+
+FVector FMoonshotDeterministicMath::RotatorToVector(const FRotator& Rotator)
+{
+	using namespace MoonshotDeterministicMath;
+
+	double SP, CP, SY, CY;
+	SinCos(NormalizeAxis(Rotator.Pitch) * DegToRad, SP, CP);
+	SinCos(NormalizeAxis(Rotator.Yaw) * DegToRad, SY, CY);
+
+	return FVector(CP * CY, CP * SY, SP);
+}
+
+FRotator FMoonshotDeterministicMath::VectorToRotator(const FVector& V)
+{
+	using namespace MoonshotDeterministicMath;
+
+	FRotator Result;
+	Result.Yaw = Atan2(V.Y, V.X) * RadToDeg;
+	Result.Pitch = Atan2(V.Z, FMath::Sqrt(V.X * V.X + V.Y * V.Y)) * RadToDeg;
+	Result.Roll = 0.0;
+	return Result;
+}
+
+void FMoonshotDeterministicMath::GetWindingAndRemainder(const FRotator& Rotator, FRotator& OutWinding, FRotator& OutRemainder)
+{
+	using namespace MoonshotDeterministicMath;
+
+	OutRemainder = FRotator(NormalizeAxis(Rotator.Pitch), NormalizeAxis(Rotator.Yaw), NormalizeAxis(Rotator.Roll));
+	OutWinding = FRotator(Rotator.Pitch - OutRemainder.Pitch, Rotator.Yaw - OutRemainder.Yaw, Rotator.Roll - OutRemainder.Roll);
+}
+
+FQuat FMoonshotDeterministicMath::Multiply(const FQuat& A, const FQuat& B)
+{
+	return FQuat(
+		A.W * B.X + A.X * B.W + A.Y * B.Z - A.Z * B.Y,
+		A.W * B.Y - A.X * B.Z + A.Y * B.W + A.Z * B.X,
+		A.W * B.Z + A.X * B.Y - A.Y * B.X + A.Z * B.W,
+		A.W * B.W - A.X * B.X - A.Y * B.Y - A.Z * B.Z);
+}
+
+FQuat FMoonshotDeterministicMath::GetNormalized(const FQuat& Quat)
+{
+	const double SquareSum = Quat.X * Quat.X + Quat.Y * Quat.Y + Quat.Z * Quat.Z + Quat.W * Quat.W;
+	if (SquareSum < UE_SMALL_NUMBER)
+	{
+		return FQuat::Identity;
+	}
+
+	const double Scale = 1.0 / FMath::Sqrt(SquareSum);
+	return FQuat(Quat.X * Scale, Quat.Y * Scale, Quat.Z * Scale, Quat.W * Scale);
+}
+
+FQuat FMoonshotDeterministicMath::FindBetweenNormals(const FVector& A, const FVector& B)
+{
+	// Same construction as FQuat::FindBetweenNormals
+	const double W = 1.0 + (A.X * B.X + A.Y * B.Y + A.Z * B.Z);
+
+	if (W >= 1.e-6)
+	{
+		return GetNormalized(FQuat(
+			A.Y * B.Z - A.Z * B.Y,
+			A.Z * B.X - A.X * B.Z,
+			A.X * B.Y - A.Y * B.X,
+			W));
+	}
+
+	// A and B point in opposite directions, rotate 180 degrees around any perpendicular axis
+	return GetNormalized(FMath::Abs(A.X) > FMath::Abs(A.Y)
+		? FQuat(-A.Z, 0.0, A.X, 0.0)
+		: FQuat(0.0, -A.Z, A.Y, 0.0));
+}
+
+FQuat FMoonshotDeterministicMath::Slerp(const FQuat& A, const FQuat& B, double Alpha)
+{
+	// Same construction as FQuat::Slerp
+	const double RawCosom = A.X * B.X + A.Y * B.Y + A.Z * B.Z + A.W * B.W;
+	const double Cosom = FMath::Abs(RawCosom);
+
+	double Scale0, Scale1;
+	if (Cosom < 0.9999)
+	{
+		const double Omega = Acos(Cosom);
+		double SinOmega, Unused;
+		SinCos(Omega, SinOmega, Unused);
+		const double InvSin = 1.0 / SinOmega;
+
+		double Sin0, Sin1;
+		SinCos((1.0 - Alpha) * Omega, Sin0, Unused);
+		SinCos(Alpha * Omega, Sin1, Unused);
+		Scale0 = Sin0 * InvSin;
+		Scale1 = Sin1 * InvSin;
+	}
+	else
+	{
+		Scale0 = 1.0 - Alpha;
+		Scale1 = Alpha;
+	}
+
+	Scale1 = (RawCosom >= 0.0) ? Scale1 : -Scale1;
+
+	return GetNormalized(FQuat(
+		Scale0 * A.X + Scale1 * B.X,
+		Scale0 * A.Y + Scale1 * B.Y,
+		Scale0 * A.Z + Scale1 * B.Z,
+		Scale0 * A.W + Scale1 * B.W));
+}
+
+FVector FMoonshotDeterministicMath::RotateVector(const FQuat& Quat, const FVector& V)
+{
+	// V' = V + 2w(Q x V) + (2Q x (Q x V)), same as FQuat::RotateVector
+	const FVector Q(Quat.X, Quat.Y, Quat.Z);
+	const FVector T(
+		2.0 * (Q.Y * V.Z - Q.Z * V.Y),
+		2.0 * (Q.Z * V.X - Q.X * V.Z),
+		2.0 * (Q.X * V.Y - Q.Y * V.X));
+
+	return FVector(
+		V.X + Quat.W * T.X + (Q.Y * T.Z - Q.Z * T.Y),
+		V.Y + Quat.W * T.Y + (Q.Z * T.X - Q.X * T.Z),
+		V.Z + Quat.W * T.Z + (Q.X * T.Y - Q.Y * T.X));
+}
+
+FVector FMoonshotDeterministicMath::GetSafeNormal(const FVector& V, double Tolerance)
+{
+	const double SquareSum = V.X * V.X + V.Y * V.Y + V.Z * V.Z;
+	if (SquareSum == 1.0)
+	{
+		return V;
+	}
+	if (SquareSum < Tolerance)
+	{
+		return FVector::ZeroVector;
+	}
+
+	const double Scale = 1.0 / FMath::Sqrt(SquareSum);
+	return FVector(V.X * Scale, V.Y * Scale, V.Z * Scale);
+}
+
+uint32 FMoonshotDeterministicMath::HashSyncState(const FMoverDefaultSyncState& SyncState)
+{
+	const FVector Location = SyncState.GetLocation_WorldSpace();
+	const FRotator Orientation = SyncState.GetOrientation_WorldSpace();
+	const FVector Velocity = SyncState.GetVelocity_WorldSpace();
+
+	const double Bits[] =
+	{
+		Location.X, Location.Y, Location.Z,
+		Orientation.Pitch, Orientation.Yaw, Orientation.Roll,
+		Velocity.X, Velocity.Y, Velocity.Z,
+	};
+
+	return FCrc::MemCrc32(Bits, sizeof(Bits));
+}
+
+void FMoonshotDeterministicMath::LogSyncStateChecksum(const UMoverComponent* MoverComponent, const FMoverTimeStep& TimeStep, const FMoverDefaultSyncState& SyncState)
+{
+	if (!MoonshotDeterministicMath::bLogSyncChecksums || !MoverComponent)
+	{
+		return;
+	}
+
+	UE_LOG(LogMover, Log, TEXT("SyncChecksum %s Role=%d Frame=%d SimTimeMs=%.3f Checksum=%08x"),
+		*GetNameSafe(MoverComponent->GetOwner()),
+		int32(MoverComponent->GetOwnerRole()),
+		TimeStep.ServerFrame,
+		TimeStep.BaseSimTimeMs,
+		HashSyncState(SyncState));
+}
+
+#if defined(__clang__) || defined(_MSC_VER)
+#pragma float_control(pop)
+#endif
@@ -0,0 +1,422 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "MoonshotMoverInputBaselines.h"
+#include "UObject/CoreNet.h"
+#include "UObject/ObjectKey.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/NetConnection.h"
+#include "GameFramework/Pawn.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Mover/Public/MoverComponent.h"
+#include "Mover/Public/MoverLog.h"
+#include "Mover/Public/MoveLibrary/MoverBlackboard.h"
+#include <atomic>
+
+namespace MoonshotInputBaselines
+{
+	// Commands are held with their movement base as a weak reference, since they can outlive it.
+	// Sequence is the full count, not the wire sequence, so a slot last written a wrap ago never matches.
+	struct FSlot
+	{
+		FMoonshotMoverCharacterInputs Inputs;
+		TWeakObjectPtr<UPrimitiveComponent> MovementBase;
+		int64 Sequence = 0;
+		bool bIsValid = false;
+
+		void Store(int64 InSequence, const FMoonshotMoverCharacterInputs& InInputs)
+		{
+			Inputs = InInputs;
+			MovementBase = InInputs.MovementBase;
+			Inputs.MovementBase = nullptr;
+			Sequence = InSequence;
+			bIsValid = true;
+		}
+
+		bool Load(int64 InSequence, FMoonshotMoverCharacterInputs& OutInputs) const
+		{
+			if (!bIsValid || Sequence != InSequence)
+			{
+				return false;
+			}
+
+			OutInputs = Inputs;
+			OutInputs.MovementBase = MovementBase.Get();
+			return true;
+		}
+	};
+
+	struct FConnectionState
+	{
+		TWeakObjectPtr<const UPackageMap> Map;
+
+		// Sending side, in full counts
+		FSlot Sent[FMoonshotMoverInputBaselines::NumSlots];
+		int64 NewestSentSequence = 0;
+		bool bHasSent = false;
+		int64 AckedSequence = 0;
+		bool bHasAck = false;
+
+		// Receiving side, in full counts
+		FSlot Received[FMoonshotMoverInputBaselines::NumSlots];
+		int64 NewestReceivedSequence = 0;
+		bool bHasUnackedReceive = false;
+		bool bHasReceived = false;
+		double LastReceivedSeconds = 0.0;
+	};
+
+	FCriticalSection Lock;
+	TMap<TObjectKey<UPackageMap>, TUniquePtr<FConnectionState>> States;
+
+	int32 SequenceDelta(uint8 A, uint8 B)
+	{
+		return FMoonshotMoverInputBaselines::SequenceDelta(A, B);
+	}
+
+	// Full count of the wire sequence nearest Newest
+	int64 Widen(int64 Newest, uint8 Sequence)
+	{
+		return Newest + SequenceDelta(Sequence, static_cast<uint8>(Newest));
+	}
+
+	// Whether Sequence is one of the NumSlots newest up to Newest, the only ones the slots can still hold
+	bool IsHeld(int64 Newest, int64 Sequence)
+	{
+		return Sequence <= Newest && Newest - Sequence < FMoonshotMoverInputBaselines::NumSlots;
+	}
+
+	FConnectionState* Find(const UPackageMap* Map)
+	{
+		const TUniquePtr<FConnectionState>* State = States.Find(Map);
+		return State ? State->Get() : nullptr;
+	}
+
+	FConnectionState& FindOrAdd(const UPackageMap* Map)
+	{
+		if (FConnectionState* Existing = Find(Map))
+		{
+			return *Existing;
+		}
+
+		// New connections are rare, so drop the state of closed ones here
+		for (auto It = States.CreateIterator(); It; ++It)
+		{
+			if (!It.Value()->Map.IsValid())
+			{
+				It.RemoveCurrent();
+			}
+		}
+
+		TUniquePtr<FConnectionState>& NewState = States.Add(Map, MakeUnique<FConnectionState>());
+		NewState->Map = Map;
+		return *NewState;
+	}
+
+	FSlot& GetSlot(FSlot* Slots, int64 Sequence)
+	{
+		return Slots[static_cast<uint8>(Sequence) % FMoonshotMoverInputBaselines::NumSlots];
+	}
+
+	const FSlot& GetSlot(const FSlot* Slots, int64 Sequence)
+	{
+		return Slots[static_cast<uint8>(Sequence) % FMoonshotMoverInputBaselines::NumSlots];
+	}
+
+	void ResetReceived(FConnectionState& State)
+	{
+		for (FSlot& Slot : State.Received)
+		{
+			Slot.bIsValid = false;
+		}
+		State.bHasReceived = false;
+		State.bHasUnackedReceive = false;
+	}
+}
+
+void FMoonshotMoverInputBaselines::RecordSent(const UPackageMap* Map, const FMoonshotMoverCharacterInputs& Inputs)
+{
+	using namespace MoonshotInputBaselines;
+
+	FScopeLock ScopeLock(&Lock);
+	FConnectionState& State = FindOrAdd(Map);
+
+	const int64 Sequence = State.bHasSent ? Widen(State.NewestSentSequence, Inputs.InputSequence) : Inputs.InputSequence;
+	GetSlot(State.Sent, Sequence).Store(Sequence, Inputs);
+
+	if (!State.bHasSent || Sequence > State.NewestSentSequence)
+	{
+		State.NewestSentSequence = Sequence;
+		State.bHasSent = true;
+	}
+}
+
+bool FMoonshotMoverInputBaselines::FindSent(const UPackageMap* Map, uint8 Sequence, FMoonshotMoverCharacterInputs& OutInputs)
+{
+	using namespace MoonshotInputBaselines;
+
+	FScopeLock ScopeLock(&Lock);
+	const FConnectionState* State = Find(Map);
+	if (!State || !State->bHasSent)
+	{
+		return false;
+	}
+
+	const int64 FullSequence = Widen(State->NewestSentSequence, Sequence);
+	return IsHeld(State->NewestSentSequence, FullSequence) && GetSlot(State->Sent, FullSequence).Load(FullSequence, OutInputs);
+}
+
+bool FMoonshotMoverInputBaselines::FindSendBaseline(const UPackageMap* Map, FMoonshotMoverCharacterInputs& OutBaseline, uint8& OutBaselineSequence)
+{
+	using namespace MoonshotInputBaselines;
+
+	FScopeLock ScopeLock(&Lock);
+	const FConnectionState* State = Find(Map);
+	if (!State || !State->bHasAck || !State->bHasSent)
+	{
+		return false;
+	}
+
+	// The receiver only holds its last NumSlots commands, so older acks cannot be used
+	const int64 Age = State->NewestSentSequence - State->AckedSequence;
+	if (Age < 0 || Age > NumSlots - 2)
+	{
+		return false;
+	}
+
+	OutBaselineSequence = static_cast<uint8>(State->AckedSequence);
+	return GetSlot(State->Sent, State->AckedSequence).Load(State->AckedSequence, OutBaseline);
+}
+
+bool FMoonshotMoverInputBaselines::HasAcknowledged(const UPackageMap* Map)
+{
+	using namespace MoonshotInputBaselines;
+
+	FScopeLock ScopeLock(&Lock);
+	const FConnectionState* State = Find(Map);
+	return State && State->bHasAck;
+}
+
+void FMoonshotMoverInputBaselines::Acknowledge(const UPackageMap* Map, uint8 Sequence)
+{
+	using namespace MoonshotInputBaselines;
+
+	FScopeLock ScopeLock(&Lock);
+	FConnectionState& State = FindOrAdd(Map);
+
+	if (!State.bHasSent)
+	{
+		return;
+	}
+
+	// Only commands we still hold can be acked; anything else is a stale ack from before a wrap
+	const int64 FullSequence = Widen(State.NewestSentSequence, Sequence);
+	if (!IsHeld(State.NewestSentSequence, FullSequence))
+	{
+		return;
+	}
+
+	// Acks travel unreliably and may arrive out of order
+	if (!State.bHasAck || FullSequence > State.AckedSequence)
+	{
+		State.AckedSequence = FullSequence;
+		State.bHasAck = true;
+	}
+}
+
+void FMoonshotMoverInputBaselines::RecordReceived(const UPackageMap* Map, uint8 Sequence, const FMoonshotMoverCharacterInputs& Inputs)
+{
+	using namespace MoonshotInputBaselines;
+
+	FScopeLock ScopeLock(&Lock);
+	FConnectionState& State = FindOrAdd(Map);
+
+	const double Now = FPlatformTime::Seconds();
+	int64 FullSequence = Sequence;
+	if (State.bHasReceived)
+	{
+		const int32 Delta = SequenceDelta(Sequence, static_cast<uint8>(State.NewestReceivedSequence));
+		if (Now - State.LastReceivedSeconds > MaxReceiveGapSeconds || Delta < -NumSlots)
+		{
+			// After a long gap the 8 bits cannot say how many commands were missed, so start over from this one.
+			// It still counts on from the old history, so anything keyed by full counts never sees them go backwards.
+			const uint8 Skipped = static_cast<uint8>(Delta);
+			FullSequence = State.NewestReceivedSequence + (Skipped != 0 ? Skipped : 256);
+			ResetReceived(State);
+		}
+		else
+		{
+			FullSequence = State.NewestReceivedSequence + Delta;
+		}
+	}
+	State.LastReceivedSeconds = Now;
+
+	FSlot& Slot = GetSlot(State.Received, FullSequence);
+	if (Slot.bIsValid && Slot.Sequence > FullSequence)
+	{
+		return;
+	}
+
+	Slot.Store(FullSequence, Inputs);
+
+	if (!State.bHasReceived || FullSequence > State.NewestReceivedSequence)
+	{
+		State.NewestReceivedSequence = FullSequence;
+		State.bHasReceived = true;
+		State.bHasUnackedReceive = true;
+	}
+}
+
+bool FMoonshotMoverInputBaselines::FindReceivedBaseline(const UPackageMap* Map, uint8 Sequence, FMoonshotMoverCharacterInputs& OutBaseline)
+{
+	using namespace MoonshotInputBaselines;
+
+	FScopeLock ScopeLock(&Lock);
+	const FConnectionState* State = Find(Map);
+	if (!State || !State->bHasReceived)
+	{
+		return false;
+	}
+
+	const int64 FullSequence = Widen(State->NewestReceivedSequence, Sequence);
+	return IsHeld(State->NewestReceivedSequence, FullSequence) && GetSlot(State->Received, FullSequence).Load(FullSequence, OutBaseline);
+}
+
+bool FMoonshotMoverInputBaselines::WidenReceivedSequence(const UPackageMap* Map, uint8 Sequence, int64& OutSequence)
+{
+	using namespace MoonshotInputBaselines;
+
+	FScopeLock ScopeLock(&Lock);
+	const FConnectionState* State = Find(Map);
+	if (!State || !State->bHasReceived)
+	{
+		return false;
+	}
+
+	OutSequence = Widen(State->NewestReceivedSequence, Sequence);
+	return true;
+}
+
+bool FMoonshotMoverInputBaselines::FindReceived(const UPackageMap* Map, int64 Sequence, FMoonshotMoverCharacterInputs& OutInputs)
+{
+	using namespace MoonshotInputBaselines;
+
+	FScopeLock ScopeLock(&Lock);
+	const FConnectionState* State = Find(Map);
+	return State && State->bHasReceived && IsHeld(State->NewestReceivedSequence, Sequence)
+		&& GetSlot(State->Received, Sequence).Load(Sequence, OutInputs);
+}
+
+bool FMoonshotMoverInputBaselines::FindNewestReceived(const UPackageMap* Map, FMoonshotMoverCharacterInputs& OutInputs, uint8& OutSequence)
+{
+	using namespace MoonshotInputBaselines;
+
+	FScopeLock ScopeLock(&Lock);
+	const FConnectionState* State = Find(Map);
+	if (!State || !State->bHasReceived)
+	{
+		return false;
+	}
+
+	OutSequence = static_cast<uint8>(State->NewestReceivedSequence);
+	return GetSlot(State->Received, State->NewestReceivedSequence).Load(State->NewestReceivedSequence, OutInputs);
+}
+
+bool FMoonshotMoverInputBaselines::ConsumeSequenceToAcknowledge(const UPackageMap* Map, uint8& OutSequence)
+{
+	using namespace MoonshotInputBaselines;
+
+	FScopeLock ScopeLock(&Lock);
+	FConnectionState* State = Find(Map);
+	if (!State || !State->bHasUnackedReceive)
+	{
+		return false;
+	}
+
+	State->bHasUnackedReceive = false;
+	OutSequence = static_cast<uint8>(State->NewestReceivedSequence);
+	return true;
+}
+
+namespace MoonshotInputRepair
+{
+	std::atomic<uint64> RepairedFrames { 0 };
+	std::atomic<uint64> UnrepairedFrames { 0 };
+
+	static FAutoConsoleCommand CmdLogStats(
+		TEXT("moonshot.Mover.InputRepairStats"),
+		TEXT("Log how many lost input commands the server repaired from redundant windows, and how many it had to simulate with a repeated command."),
+		FConsoleCommandDelegate::CreateLambda([]()
+		{
+			const FMoonshotMoverInputRepair::FStats Stats = FMoonshotMoverInputRepair::GetStats();
+			UE_LOG(LogMover, Log, TEXT("Input repair: %llu repaired, %llu unrepaired (simulated with a repeated command)"), Stats.RepairedFrames, Stats.UnrepairedFrames);
+		}));
+}
+
+const FMoonshotMoverCharacterInputs* FMoonshotMoverInputRepair::Resolve(const UMoverComponent* MoverComponent, UMoverBlackboard* SimBlackboard, const FMoverTimeStep& TimeStep, const FMoonshotMoverCharacterInputs* Inputs, FMoonshotMoverCharacterInputs& OutRepairedStorage)
+{
+	using namespace MoonshotInputRepair;
+
+	const APawn* Pawn = MoverComponent ? Cast<APawn>(MoverComponent->GetOwner()) : nullptr;
+	if (!Inputs || !SimBlackboard || !Pawn || Pawn->GetLocalRole() != ROLE_Authority || Pawn->IsLocallyControlled())
+	{
+		return Inputs;
+	}
+
+	FMoonshotMoverInputRepairState State;
+	SimBlackboard->TryGet(MoonshotBlackboard::InputRepair, State);
+
+	if (State.ServerFrame != TimeStep.ServerFrame)
+	{
+		State.ServerFrame = TimeStep.ServerFrame;
+		State.bUseRepaired = false;
+
+		// Compare full counts, so a command a wrap old is neither taken for a repeat nor repaired from
+		const UNetConnection* Connection = Pawn->GetNetConnection();
+		int64 Sequence = 0;
+		if (!Connection || !FMoonshotMoverInputBaselines::WidenReceivedSequence(Connection->PackageMap, Inputs->InputSequence, Sequence))
+		{
+			SimBlackboard->Set(MoonshotBlackboard::InputRepair, State);
+			return Inputs;
+		}
+
+		// NP hands us the previous command again when the next one did not arrive in time
+		const bool bIsRepeat = State.bHasLastSequence && Sequence <= State.LastSequence;
+		if (!bIsRepeat)
+		{
+			State.LastSequence = Sequence;
+			State.bHasLastSequence = true;
+		}
+		else
+		{
+			const int64 MissingSequence = State.LastSequence + 1;
+
+			if (FMoonshotMoverInputBaselines::FindReceived(Connection->PackageMap, MissingSequence, State.Repaired))
+			{
+				State.LastSequence = MissingSequence;
+				State.bUseRepaired = true;
+				++RepairedFrames;
+			}
+			else
+			{
+				++UnrepairedFrames;
+			}
+		}
+
+		SimBlackboard->Set(MoonshotBlackboard::InputRepair, State);
+	}
+
+	if (State.bUseRepaired)
+	{
+		OutRepairedStorage = State.Repaired;
+		return &OutRepairedStorage;
+	}
+	return Inputs;
+}
+
+FMoonshotMoverInputRepair::FStats FMoonshotMoverInputRepair::GetStats()
+{
+	FStats Stats;
+	Stats.RepairedFrames = MoonshotInputRepair::RepairedFrames.load();
+	Stats.UnrepairedFrames = MoonshotInputRepair::UnrepairedFrames.load();
+	return Stats;
+}
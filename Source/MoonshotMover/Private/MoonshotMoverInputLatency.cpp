@@ -0,0 +1,226 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "MoonshotMoverInputLatency.h"
+#include "MoonshotMoverSimTelemetry.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "ProfilingDebugging/CountersTrace.h"
+#include "UObject/ObjectKey.h"
+#include "Mover/Public/MoverComponent.h"
+#include "Mover/Public/MoverLog.h"
+#include "Mover/Public/MoverSimulationTypes.h"
+
+#if MOONSHOT_INPUT_LATENCY
+
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Input Latency: Event to ProduceInput (ms)"), STAT_MoonshotMover_Latency_ProduceInput, STATGROUP_MoonshotMover);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Input Latency: ProduceInput to GenerateMove (ms)"), STAT_MoonshotMover_Latency_GenerateMove, STATGROUP_MoonshotMover);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Input Latency: GenerateMove to SimulationTick (ms)"), STAT_MoonshotMover_Latency_SimulationTick, STATGROUP_MoonshotMover);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Input Latency: SimulationTick to Transform (ms)"), STAT_MoonshotMover_Latency_TransformApplied, STATGROUP_MoonshotMover);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Input Latency: Event to Transform (ms)"), STAT_MoonshotMover_Latency_Total, STATGROUP_MoonshotMover);
+
+TRACE_DECLARE_FLOAT_COUNTER(MoonshotMover_Latency_ProduceInput, TEXT("MoonshotMover/InputLatency/EventToProduceInput"));
+TRACE_DECLARE_FLOAT_COUNTER(MoonshotMover_Latency_GenerateMove, TEXT("MoonshotMover/InputLatency/ProduceInputToGenerateMove"));
+TRACE_DECLARE_FLOAT_COUNTER(MoonshotMover_Latency_SimulationTick, TEXT("MoonshotMover/InputLatency/GenerateMoveToSimulationTick"));
+TRACE_DECLARE_FLOAT_COUNTER(MoonshotMover_Latency_TransformApplied, TEXT("MoonshotMover/InputLatency/SimulationTickToTransform"));
+TRACE_DECLARE_FLOAT_COUNTER(MoonshotMover_Latency_Total, TEXT("MoonshotMover/InputLatency/EventToTransform"));
+
+namespace MoonshotInputLatency
+{
+	using EStage = FMoonshotMoverInputLatency::EStage;
+
+	// One command's progress through the stages on one component
+	struct FComponentState
+	{
+		TWeakObjectPtr<const UMoverComponent> MoverComponent;
+		int32 ServerFrame = INDEX_NONE;
+		double InputEventSeconds = 0.0;
+		double ProducedSeconds = 0.0;
+		double GenerateMoveSeconds = 0.0;
+		double SimulationTickSeconds = 0.0;
+
+		// A mode change runs GenerateMove again for the same command; it is only measured once
+		double LastMeasuredProducedSeconds = 0.0;
+	};
+
+	TMap<TObjectKey<UMoverComponent>, FComponentState> States;
+
+	FMoonshotMoverInputLatency::FStageStats Stats[static_cast<int32>(EStage::Num)];
+	FMoonshotMoverInputLatency::FStageStats TotalStats;
+
+	const TCHAR* StageNames[] = { TEXT("Event -> ProduceInput"), TEXT("ProduceInput -> GenerateMove"), TEXT("GenerateMove -> SimulationTick"), TEXT("SimulationTick -> Transform") };
+	static_assert(UE_ARRAY_COUNT(StageNames) == static_cast<int32>(EStage::Num), "Name every stage");
+
+	FComponentState& FindOrAdd(const UMoverComponent* MoverComponent)
+	{
+		if (FComponentState* Existing = States.Find(MoverComponent))
+		{
+			return *Existing;
+		}
+
+		// New components are rare, so drop the state of destroyed ones here
+		for (auto It = States.CreateIterator(); It; ++It)
+		{
+			if (!It.Value().MoverComponent.IsValid())
+			{
+				It.RemoveCurrent();
+			}
+		}
+
+		FComponentState& NewState = States.Add(MoverComponent);
+		NewState.MoverComponent = MoverComponent;
+		return NewState;
+	}
+
+	void Accumulate(FMoonshotMoverInputLatency::FStageStats& Into, double Ms)
+	{
+		++Into.Count;
+		Into.TotalMs += Ms;
+		Into.MaxMs = FMath::Max(Into.MaxMs, Ms);
+	}
+
+	void Record(EStage Stage, double Ms)
+	{
+		Accumulate(Stats[static_cast<int32>(Stage)], Ms);
+
+		switch (Stage)
+		{
+		case EStage::ProduceInput:
+			SET_FLOAT_STAT(STAT_MoonshotMover_Latency_ProduceInput, Ms);
+			TRACE_COUNTER_SET(MoonshotMover_Latency_ProduceInput, Ms);
+			break;
+		case EStage::GenerateMove:
+			SET_FLOAT_STAT(STAT_MoonshotMover_Latency_GenerateMove, Ms);
+			TRACE_COUNTER_SET(MoonshotMover_Latency_GenerateMove, Ms);
+			break;
+		case EStage::SimulationTick:
+			SET_FLOAT_STAT(STAT_MoonshotMover_Latency_SimulationTick, Ms);
+			TRACE_COUNTER_SET(MoonshotMover_Latency_SimulationTick, Ms);
+			break;
+		case EStage::TransformApplied:
+			SET_FLOAT_STAT(STAT_MoonshotMover_Latency_TransformApplied, Ms);
+			TRACE_COUNTER_SET(MoonshotMover_Latency_TransformApplied, Ms);
+			break;
+		default:
+			break;
+		}
+	}
+
+	void RecordTotal(double Ms)
+	{
+		Accumulate(TotalStats, Ms);
+		SET_FLOAT_STAT(STAT_MoonshotMover_Latency_Total, Ms);
+		TRACE_COUNTER_SET(MoonshotMover_Latency_Total, Ms);
+	}
+
+	FString Describe(const TCHAR* Name, const FMoonshotMoverInputLatency::FStageStats& StageStats)
+	{
+		return FString::Printf(TEXT("%s: avg %.2f ms, max %.2f ms over %llu"), Name, StageStats.Count ? StageStats.TotalMs / StageStats.Count : 0.0, StageStats.MaxMs, StageStats.Count);
+	}
+
+	static FAutoConsoleCommand CmdLogLatency(
+		TEXT("moonshot.Mover.InputLatency"),
+		TEXT("Log Moonshot input-to-movement latency per stage since startup."),
+		FConsoleCommandDelegate::CreateLambda([]()
+		{
+			for (int32 Stage = 0; Stage < static_cast<int32>(EStage::Num); ++Stage)
+			{
+				UE_LOG(LogMover, Log, TEXT("Input latency %s"), *Describe(StageNames[Stage], Stats[Stage]));
+			}
+			UE_LOG(LogMover, Log, TEXT("Input latency %s"), *Describe(TEXT("Event -> Transform"), TotalStats));
+		}));
+}
+
+#endif // MOONSHOT_INPUT_LATENCY
+
+void FMoonshotMoverInputLatency::MarkProduceInput(FMoonshotMoverInputLatencyStamp& Stamp, double InputEventSeconds)
+{
+#if MOONSHOT_INPUT_LATENCY
+	Stamp.InputEventSeconds = InputEventSeconds;
+	Stamp.ProducedSeconds = FPlatformTime::Seconds();
+
+	if (InputEventSeconds > 0.0)
+	{
+		MoonshotInputLatency::Record(EStage::ProduceInput, (Stamp.ProducedSeconds - InputEventSeconds) * 1000.0);
+	}
+#endif
+}
+
+void FMoonshotMoverInputLatency::MarkGenerateMove(const UMoverComponent* MoverComponent, const FMoverTimeStep& TimeStep, const FMoonshotMoverInputLatencyStamp& Stamp)
+{
+#if MOONSHOT_INPUT_LATENCY
+	using namespace MoonshotInputLatency;
+
+	// Resimulated frames replay old commands; the server's commands came over the network without a stamp
+	if (!MoverComponent || TimeStep.bIsResimulating || Stamp.ProducedSeconds <= 0.0)
+	{
+		return;
+	}
+
+	FComponentState& State = FindOrAdd(MoverComponent);
+	if (State.LastMeasuredProducedSeconds == Stamp.ProducedSeconds)
+	{
+		return;
+	}
+
+	const double Now = FPlatformTime::Seconds();
+	Record(EStage::GenerateMove, (Now - Stamp.ProducedSeconds) * 1000.0);
+
+	State.ServerFrame = TimeStep.ServerFrame;
+	State.InputEventSeconds = Stamp.InputEventSeconds;
+	State.ProducedSeconds = Stamp.ProducedSeconds;
+	State.GenerateMoveSeconds = Now;
+	State.SimulationTickSeconds = 0.0;
+	State.LastMeasuredProducedSeconds = Stamp.ProducedSeconds;
+#endif
+}
+
+void FMoonshotMoverInputLatency::MarkSimulationTick(const UMoverComponent* MoverComponent, int32 ServerFrame)
+{
+#if MOONSHOT_INPUT_LATENCY
+	using namespace MoonshotInputLatency;
+
+	FComponentState* State = States.Find(MoverComponent);
+	if (!State || State->ServerFrame != ServerFrame || State->GenerateMoveSeconds <= 0.0)
+	{
+		return;
+	}
+
+	State->SimulationTickSeconds = FPlatformTime::Seconds();
+	Record(EStage::SimulationTick, (State->SimulationTickSeconds - State->GenerateMoveSeconds) * 1000.0);
+	State->GenerateMoveSeconds = 0.0;
+#endif
+}
+
+void FMoonshotMoverInputLatency::MarkTransformApplied(const UMoverComponent* MoverComponent, int32 ServerFrame)
+{
+#if MOONSHOT_INPUT_LATENCY
+	using namespace MoonshotInputLatency;
+
+	FComponentState* State = States.Find(MoverComponent);
+	if (!State || State->ServerFrame != ServerFrame || State->SimulationTickSeconds <= 0.0)
+	{
+		return;
+	}
+
+	const double Now = FPlatformTime::Seconds();
+	Record(EStage::TransformApplied, (Now - State->SimulationTickSeconds) * 1000.0);
+	if (State->InputEventSeconds > 0.0)
+	{
+		RecordTotal((Now - State->InputEventSeconds) * 1000.0);
+	}
+
+	State->ServerFrame = INDEX_NONE;
+	State->SimulationTickSeconds = 0.0;
+#endif
+}
+
+FMoonshotMoverInputLatency::FStageStats FMoonshotMoverInputLatency::GetStats(EStage Stage)
+{
+#if MOONSHOT_INPUT_LATENCY
+	if (Stage < EStage::Num)
+	{
+		return MoonshotInputLatency::Stats[static_cast<int32>(Stage)];
+	}
+#endif
+	return FStageStats();
+}
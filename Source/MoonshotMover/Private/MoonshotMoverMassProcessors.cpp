@@ -0,0 +1,376 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "MoonshotMoverMassProcessors.h"
+#include "MoonshotMoverMassFragments.h"
+#include "MoonshotMoverUtils.h"
+#include "MoonshotMoverZeroGMode.h"
+#include "MassCommonFragments.h"
+#include "MassCommonTypes.h"
+#include "MassExecutionContext.h"
+#include "Mover/Public/MoveLibrary/MovementUtils.h"
+#include "Engine/World.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(MoonshotMoverMassProcessors)
+
+
+namespace MoonshotMassMover
+{
+	/** Queues the tag swap for a mode change requested by the entity's input, and consumes the request */
+	template<typename FromTagType>
+	static void ApplyRequestedMode(FMassExecutionContext& Context, int32 EntityIndex, FMoonshotMassMoverInputFragment& Input)
+	{
+		const EMoonshotMassMoverMode RequestedMode = Input.RequestedMode;
+		Input.RequestedMode = EMoonshotMassMoverMode::None;
+
+		const FMassEntityHandle Entity = Context.GetEntity(EntityIndex);
+		switch (RequestedMode)
+		{
+		case EMoonshotMassMoverMode::ZeroG:
+			if constexpr (!std::is_same_v<FromTagType, FMoonshotMassZeroGTag>)
+			{
+				Context.Defer().SwapTags<FromTagType, FMoonshotMassZeroGTag>(Entity);
+			}
+			break;
+		case EMoonshotMassMoverMode::Attaching:
+			if constexpr (!std::is_same_v<FromTagType, FMoonshotMassAttachingTag>)
+			{
+				Context.Defer().SwapTags<FromTagType, FMoonshotMassAttachingTag>(Entity);
+			}
+			break;
+		case EMoonshotMassMoverMode::SurfaceWalking:
+			if constexpr (!std::is_same_v<FromTagType, FMoonshotMassSurfaceWalkingTag>)
+			{
+				Context.Defer().SwapTags<FromTagType, FMoonshotMassSurfaceWalkingTag>(Entity);
+			}
+			break;
+		default:
+			break;
+		}
+	}
+
+	/** Turns Orient about Up toward IntentDir, limited by TurningRate (degrees per second, negative snaps) */
+	static FQuat TurnToward(const FQuat& Orient, const FVector& Up, const FVector& IntentDir, float TurningRate, float DeltaSeconds)
+	{
+		const FVector Forward = FVector::VectorPlaneProject(IntentDir, Up).GetSafeNormal();
+		if (Forward.IsNearlyZero())
+		{
+			return Orient;
+		}
+
+		const FQuat TargetQuat = FRotationMatrix::MakeFromZX(Up, Forward).ToQuat();
+		if (TurningRate < 0.0f)
+		{
+			return TargetQuat;
+		}
+
+		const double MaxAngle = FMath::DegreesToRadians(TurningRate * DeltaSeconds);
+		const double Angle = Orient.AngularDistance(TargetQuat);
+		return (Angle <= MaxAngle) ? TargetQuat : FQuat::Slerp(Orient, TargetQuat, MaxAngle / Angle);
+	}
+
+	static bool TraceSurface(const UWorld* World, const FVector& Start, const FVector& End, ECollisionChannel TraceChannel, FHitResult& OutHit)
+	{
+		static const FName TraceTag(TEXT("MoonshotMassSurface"));
+		return World->LineTraceSingleByChannel(OutHit, Start, End, TraceChannel, FCollisionQueryParams(TraceTag, false));
+	}
+}
+
+//----------------------------------------------------------------------//
+// UMoonshotMassZeroGProcessor
+//----------------------------------------------------------------------//
+
+UMoonshotMassZeroGProcessor::UMoonshotMassZeroGProcessor()
+	: EntityQuery(*this)
+{
+	ExecutionFlags = int32(EProcessorExecutionFlags::Server | EProcessorExecutionFlags::Standalone);
+	ExecutionOrder.ExecuteInGroup = UE::Mass::ProcessorGroupNames::Movement;
+}
+
+void UMoonshotMassZeroGProcessor::ConfigureQueries()
+{
+	EntityQuery.AddRequirement<FTransformFragment>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddRequirement<FMoonshotMassMoverInputFragment>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddRequirement<FMoonshotMassMoverStateFragment>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddConstSharedRequirement<FMoonshotMassMoverSettingsFragment>();
+	EntityQuery.AddTagRequirement<FMoonshotMassZeroGTag>(EMassFragmentPresence::All);
+}
+
+void UMoonshotMassZeroGProcessor::Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context)
+{
+	EntityQuery.ForEachEntityChunk(EntityManager, Context, [this](FMassExecutionContext& Context)
+	{
+		const FMoonshotMassMoverSettingsFragment& Settings = Context.GetConstSharedFragment<FMoonshotMassMoverSettingsFragment>();
+		const UMoonshotMoverCommonMovementSettings* CommonMovementSettings = Settings.CommonMovementSettings;
+		if (!CommonMovementSettings)
+		{
+			return;
+		}
+
+		const int32 NumEntities = Context.GetNumEntities();
+		const float DeltaSeconds = Context.GetDeltaTimeSeconds();
+		const TArrayView<FTransformFragment> Transforms = Context.GetMutableFragmentView<FTransformFragment>();
+		const TArrayView<FMoonshotMassMoverInputFragment> Inputs = Context.GetMutableFragmentView<FMoonshotMassMoverInputFragment>();
+		const TArrayView<FMoonshotMassMoverStateFragment> States = Context.GetMutableFragmentView<FMoonshotMassMoverStateFragment>();
+
+		// Same parameters UMoonshotMoverZeroGMode::OnGenerateMove builds from character inputs
+		Batch.SetNum(NumEntities);
+		for (int32 EntityIndex = 0; EntityIndex < NumEntities; ++EntityIndex)
+		{
+			const FMoonshotMassMoverInputFragment& Input = Inputs[EntityIndex];
+
+			FZeroGModeParams Params;
+			Params.MoveInput = Input.MoveInput;
+			Params.AngularVelocity = Input.AngularVelocity;
+			if (FMath::Abs(Params.AngularVelocity.Roll) > 180.0f)
+			{
+				Params.AngularVelocity.Roll -= 360.0f;
+			}
+			if (FMath::Abs(Params.AngularVelocity.Pitch) > 180.0f)
+			{
+				Params.AngularVelocity.Pitch -= 360.0f;
+			}
+			if (FMath::Abs(Params.AngularVelocity.Yaw) > 180.0f)
+			{
+				Params.AngularVelocity.Yaw -= 360.0f;
+			}
+			Params.Deceleration = Input.bIsJumpPressed ? CommonMovementSettings->LinearBrakingScale : CommonMovementSettings->ZeroGDeceleration;
+			Params.PriorVelocity = States[EntityIndex].Velocity;
+			Params.TurningRate = CommonMovementSettings->ZeroGTurningRate;
+			Params.MaxSpeed = CommonMovementSettings->ZeroGMaxSpeed;
+			Params.Acceleration = CommonMovementSettings->ZeroGLinearAcceleration;
+			Params.DeltaSeconds = DeltaSeconds;
+
+			Batch.SetMover(EntityIndex, Params);
+		}
+
+		UZeroGModeUtils::ComputeControlledFreeMoveBatch(Batch);
+
+		for (int32 EntityIndex = 0; EntityIndex < NumEntities; ++EntityIndex)
+		{
+			const FProposedMove ProposedMove = Batch.GetProposedMove(EntityIndex);
+			FTransform& Transform = Transforms[EntityIndex].GetMutableTransform();
+
+			FQuat OrientQuat = Transform.GetRotation();
+			if (!ProposedMove.AngularVelocity.IsZero())
+			{
+				OrientQuat = OrientQuat * (ProposedMove.AngularVelocity * DeltaSeconds).Quaternion();
+			}
+			OrientQuat.Normalize();
+
+			Transform.SetRotation(OrientQuat);
+			Transform.AddToTranslation(ProposedMove.LinearVelocity * DeltaSeconds);
+			States[EntityIndex].Velocity = ProposedMove.LinearVelocity;
+
+			MoonshotMassMover::ApplyRequestedMode<FMoonshotMassZeroGTag>(Context, EntityIndex, Inputs[EntityIndex]);
+		}
+	});
+}
+
+//----------------------------------------------------------------------//
+// UMoonshotMassAttachingProcessor
+//----------------------------------------------------------------------//
+
+UMoonshotMassAttachingProcessor::UMoonshotMassAttachingProcessor()
+	: EntityQuery(*this)
+{
+	ExecutionFlags = int32(EProcessorExecutionFlags::Server | EProcessorExecutionFlags::Standalone);
+	ExecutionOrder.ExecuteInGroup = UE::Mass::ProcessorGroupNames::Movement;
+}
+
+void UMoonshotMassAttachingProcessor::ConfigureQueries()
+{
+	EntityQuery.AddRequirement<FTransformFragment>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddRequirement<FMoonshotMassMoverInputFragment>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddRequirement<FMoonshotMassMoverStateFragment>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddConstSharedRequirement<FMoonshotMassMoverSettingsFragment>();
+	EntityQuery.AddTagRequirement<FMoonshotMassAttachingTag>(EMassFragmentPresence::All);
+}
+
+void UMoonshotMassAttachingProcessor::Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context)
+{
+	const UWorld* World = EntityManager.GetWorld();
+	check(World);
+
+	EntityQuery.ForEachEntityChunk(EntityManager, Context, [World](FMassExecutionContext& Context)
+	{
+		const FMoonshotMassMoverSettingsFragment& Settings = Context.GetConstSharedFragment<FMoonshotMassMoverSettingsFragment>();
+		const UMoonshotMoverCommonMovementSettings* CommonMovementSettings = Settings.CommonMovementSettings;
+		if (!CommonMovementSettings)
+		{
+			return;
+		}
+
+		const int32 NumEntities = Context.GetNumEntities();
+		const float DeltaSeconds = Context.GetDeltaTimeSeconds();
+		const TArrayView<FTransformFragment> Transforms = Context.GetMutableFragmentView<FTransformFragment>();
+		const TArrayView<FMoonshotMassMoverInputFragment> Inputs = Context.GetMutableFragmentView<FMoonshotMassMoverInputFragment>();
+		const TArrayView<FMoonshotMassMoverStateFragment> States = Context.GetMutableFragmentView<FMoonshotMassMoverStateFragment>();
+
+		for (int32 EntityIndex = 0; EntityIndex < NumEntities; ++EntityIndex)
+		{
+			FMoonshotMassMoverInputFragment& Input = Inputs[EntityIndex];
+			FMoonshotMassMoverStateFragment& State = States[EntityIndex];
+			FTransform& Transform = Transforms[EntityIndex].GetMutableTransform();
+
+			if (Input.RequestedMode != EMoonshotMassMoverMode::None)
+			{
+				MoonshotMassMover::ApplyRequestedMode<FMoonshotMassAttachingTag>(Context, EntityIndex, Input);
+				continue;
+			}
+
+			const FVector Location = Transform.GetLocation();
+			const FVector CurrentUp = Transform.GetRotation().GetUpVector();
+
+			// Same velocity model as UMoonshotMoverAttachingMode::OnGenerateMove
+			const FVector GravityAcceleration = Input.GravityAcceleration.IsNearlyZero() ? -980.0f * CurrentUp : Input.GravityAcceleration;
+			const FVector Acceleration = Settings.AirControlPercentage * CommonMovementSettings->ZeroGLinearAcceleration * Input.MoveInput;
+			const FVector Velocity = State.Velocity.GetClampedToMaxSize(CommonMovementSettings->ZeroGMaxSpeed) + (Acceleration + GravityAcceleration) * DeltaSeconds;
+
+			// Look for the surface we are falling toward; without one there is nothing to attach to
+			FHitResult Hit(1.f);
+			if (!MoonshotMassMover::TraceSurface(World, Location, Location - CurrentUp * CommonMovementSettings->MaxAttachDistance, Settings.SurfaceTraceChannel, Hit))
+			{
+				State.Velocity = Velocity;
+				Context.Defer().SwapTags<FMoonshotMassAttachingTag, FMoonshotMassZeroGTag>(Context.GetEntity(EntityIndex));
+				continue;
+			}
+
+			const FVector GravityUp = Hit.ImpactNormal;
+			FQuat OrientQuat = FQuat::FindBetweenNormals(CurrentUp, GravityUp) * Transform.GetRotation();
+			OrientQuat = MoonshotMassMover::TurnToward(OrientQuat, GravityUp, Input.OrientationIntent, CommonMovementSettings->ZeroGTurningRate, DeltaSeconds);
+			OrientQuat.Normalize();
+			Transform.SetRotation(OrientQuat);
+
+			// Entity transforms sit at the feet, so we land once this tick's approach covers the remaining distance
+			const FVector MoveDelta = Velocity * DeltaSeconds;
+			const double Approach = FMath::Max(0.0, MoveDelta | -GravityUp);
+			if (Hit.Distance <= Approach + UMoonshotMoverUtils::MAX_FLOOR_DIST
+				&& UMoonshotMoverUtils::IsHitSurfaceWalkableForUp(Hit, CommonMovementSettings->MaxWalkSlopeCosine, OrientQuat.GetUpVector()))
+			{
+				Transform.SetLocation(Hit.ImpactPoint);
+				State.Velocity = FVector::VectorPlaneProject(Velocity, GravityUp);
+				State.SurfaceNormal = GravityUp;
+				Context.Defer().SwapTags<FMoonshotMassAttachingTag, FMoonshotMassSurfaceWalkingTag>(Context.GetEntity(EntityIndex));
+				continue;
+			}
+
+			Transform.SetLocation(Location + MoveDelta);
+			State.Velocity = Velocity;
+			State.SurfaceNormal = GravityUp;
+		}
+	});
+}
+
+//----------------------------------------------------------------------//
+// UMoonshotMassSurfaceWalkingProcessor
+//----------------------------------------------------------------------//
+
+UMoonshotMassSurfaceWalkingProcessor::UMoonshotMassSurfaceWalkingProcessor()
+	: EntityQuery(*this)
+{
+	ExecutionFlags = int32(EProcessorExecutionFlags::Server | EProcessorExecutionFlags::Standalone);
+	ExecutionOrder.ExecuteInGroup = UE::Mass::ProcessorGroupNames::Movement;
+}
+
+void UMoonshotMassSurfaceWalkingProcessor::ConfigureQueries()
+{
+	EntityQuery.AddRequirement<FTransformFragment>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddRequirement<FMoonshotMassMoverInputFragment>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddRequirement<FMoonshotMassMoverStateFragment>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddConstSharedRequirement<FMoonshotMassMoverSettingsFragment>();
+	EntityQuery.AddTagRequirement<FMoonshotMassSurfaceWalkingTag>(EMassFragmentPresence::All);
+}
+
+void UMoonshotMassSurfaceWalkingProcessor::Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context)
+{
+	const UWorld* World = EntityManager.GetWorld();
+	check(World);
+
+	EntityQuery.ForEachEntityChunk(EntityManager, Context, [World](FMassExecutionContext& Context)
+	{
+		const FMoonshotMassMoverSettingsFragment& Settings = Context.GetConstSharedFragment<FMoonshotMassMoverSettingsFragment>();
+		const UMoonshotMoverCommonMovementSettings* CommonMovementSettings = Settings.CommonMovementSettings;
+		if (!CommonMovementSettings)
+		{
+			return;
+		}
+
+		const int32 NumEntities = Context.GetNumEntities();
+		const float DeltaSeconds = Context.GetDeltaTimeSeconds();
+		const TArrayView<FTransformFragment> Transforms = Context.GetMutableFragmentView<FTransformFragment>();
+		const TArrayView<FMoonshotMassMoverInputFragment> Inputs = Context.GetMutableFragmentView<FMoonshotMassMoverInputFragment>();
+		const TArrayView<FMoonshotMassMoverStateFragment> States = Context.GetMutableFragmentView<FMoonshotMassMoverStateFragment>();
+
+		for (int32 EntityIndex = 0; EntityIndex < NumEntities; ++EntityIndex)
+		{
+			FMoonshotMassMoverInputFragment& Input = Inputs[EntityIndex];
+			FMoonshotMassMoverStateFragment& State = States[EntityIndex];
+			FTransform& Transform = Transforms[EntityIndex].GetMutableTransform();
+
+			if (Input.RequestedMode != EMoonshotMassMoverMode::None)
+			{
+				MoonshotMassMover::ApplyRequestedMode<FMoonshotMassSurfaceWalkingTag>(Context, EntityIndex, Input);
+				continue;
+			}
+
+			const FVector MovementNormal = Input.GravityAcceleration.IsNearlyZero() ? State.SurfaceNormal : -Input.GravityAcceleration.GetSafeNormal();
+			const FVector PriorVelocity = FVector::VectorPlaneProject(State.Velocity, MovementNormal);
+
+			if (Input.bIsJumpPressed)
+			{
+				State.Velocity = PriorVelocity + MovementNormal * CommonMovementSettings->JumpUpwardsSpeed;
+				Transform.AddToTranslation(State.Velocity * DeltaSeconds);
+				Context.Defer().SwapTags<FMoonshotMassSurfaceWalkingTag, FMoonshotMassAttachingTag>(Context.GetEntity(EntityIndex));
+				continue;
+			}
+
+			// Same velocity model as UMoonshotMoverSurfaceWalkingMode::OnGenerateMove
+			const FVector MoveInput = FVector::VectorPlaneProject(Input.MoveInput, MovementNormal);
+
+			FComputeVelocityParams ComputeVelocityParams;
+			ComputeVelocityParams.DeltaSeconds = DeltaSeconds;
+			ComputeVelocityParams.InitialVelocity = PriorVelocity;
+			ComputeVelocityParams.MoveDirectionIntent = MoveInput;
+			ComputeVelocityParams.MaxSpeed = CommonMovementSettings->MaxSpeed;
+			ComputeVelocityParams.TurningBoost = CommonMovementSettings->TurningBoost;
+			ComputeVelocityParams.Deceleration = CommonMovementSettings->Deceleration;
+			ComputeVelocityParams.Acceleration = CommonMovementSettings->Acceleration;
+
+			if (MoveInput.SizeSquared() > 0.f && !UMovementUtils::IsExceedingMaxSpeed(PriorVelocity, CommonMovementSettings->MaxSpeed))
+			{
+				ComputeVelocityParams.Friction = CommonMovementSettings->GroundFriction;
+			}
+			else
+			{
+				ComputeVelocityParams.Friction = CommonMovementSettings->bUseSeparateBrakingFriction ? CommonMovementSettings->BrakingFriction : CommonMovementSettings->GroundFriction;
+				ComputeVelocityParams.Friction *= CommonMovementSettings->BrakingFrictionFactor;
+			}
+
+			const FVector Velocity = FVector::VectorPlaneProject(UMovementUtils::ComputeVelocity(ComputeVelocityParams), MovementNormal);
+			const FVector TargetLocation = Transform.GetLocation() + Velocity * DeltaSeconds;
+
+			// Follow the surface within step height; walking off an edge or onto an unwalkable slope drops us back into Attaching
+			const float MaxStepHeight = CommonMovementSettings->MaxStepHeight;
+			FHitResult Hit(1.f);
+			if (MoonshotMassMover::TraceSurface(World, TargetLocation + MovementNormal * MaxStepHeight, TargetLocation - MovementNormal * (MaxStepHeight + UMoonshotMoverUtils::MAX_FLOOR_DIST), Settings.SurfaceTraceChannel, Hit)
+				&& UMoonshotMoverUtils::IsHitSurfaceWalkableForUp(Hit, CommonMovementSettings->MaxWalkSlopeCosine, MovementNormal))
+			{
+				const FVector SurfaceNormal = Hit.ImpactNormal;
+				FQuat OrientQuat = FQuat::FindBetweenNormals(Transform.GetRotation().GetUpVector(), SurfaceNormal) * Transform.GetRotation();
+				OrientQuat = MoonshotMassMover::TurnToward(OrientQuat, SurfaceNormal, Input.OrientationIntent, CommonMovementSettings->TurningRate, DeltaSeconds);
+				OrientQuat.Normalize();
+
+				Transform.SetRotation(OrientQuat);
+				Transform.SetLocation(Hit.ImpactPoint);
+				State.Velocity = FVector::VectorPlaneProject(Velocity, SurfaceNormal);
+				State.SurfaceNormal = SurfaceNormal;
+			}
+			else
+			{
+				Transform.SetLocation(TargetLocation);
+				State.Velocity = Velocity;
+				Context.Defer().SwapTags<FMoonshotMassSurfaceWalkingTag, FMoonshotMassAttachingTag>(Context.GetEntity(EntityIndex));
+			}
+		}
+	});
+}
@@ -0,0 +1,38 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "MoonshotMoverMassTrait.h"
+#include "MassCommonFragments.h"
+#include "MassEntityTemplateRegistry.h"
+#include "MassEntityUtils.h"
+#include "Engine/World.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(MoonshotMoverMassTrait)
+
+
+void UMoonshotMoverMassTrait::BuildTemplate(FMassEntityTemplateBuildContext& BuildContext, const UWorld& World) const
+{
+	FMassEntityManager& EntityManager = UE::Mass::Utils::GetEntityManagerChecked(World);
+
+	BuildContext.AddFragment<FTransformFragment>();
+	BuildContext.AddFragment<FMoonshotMassMoverInputFragment>();
+	BuildContext.AddFragment<FMoonshotMassMoverStateFragment>();
+
+	FMoonshotMassMoverSettingsFragment Settings;
+	Settings.CommonMovementSettings = MovementSettings ? MovementSettings.Get() : GetDefault<UMoonshotMoverCommonMovementSettings>();
+	Settings.AirControlPercentage = AirControlPercentage;
+	Settings.SurfaceTraceChannel = SurfaceTraceChannel;
+	BuildContext.AddConstSharedFragment(EntityManager.GetOrCreateConstSharedFragment(Settings));
+
+	switch (StartingMode)
+	{
+	case EMoonshotMassMoverMode::Attaching:
+		BuildContext.AddTag<FMoonshotMassAttachingTag>();
+		break;
+	case EMoonshotMassMoverMode::SurfaceWalking:
+		BuildContext.AddTag<FMoonshotMassSurfaceWalkingTag>();
+		break;
+	default:
+		BuildContext.AddTag<FMoonshotMassZeroGTag>();
+		break;
+	}
+}
@@ -0,0 +1,108 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "MoonshotMoverModeRegistry.h"
+#include "Mover/Public/MoverTypes.h"
+
+
+FMoonshotMoverModeRegistry::FMoonshotMoverModeRegistry()
+{
+	// Order must match MoonshotModeHandles
+	const FName BuiltInNames[MoonshotModeHandles::NumBuiltIn] =
+	{
+		NAME_None,
+		DefaultModeNames::Walking,
+		DefaultModeNames::Falling,
+		DefaultModeNames::Flying,
+		DefaultModeNames::Swimming,
+		MoonshotModeNames::ZeroG,
+	};
+
+	for (const FName& Name : BuiltInNames)
+	{
+		NameToIndex.Add(Name, static_cast<uint8>(Names.Add(Name)));
+	}
+}
+
+FMoonshotMoverModeRegistry& FMoonshotMoverModeRegistry::Get()
+{
+	static FMoonshotMoverModeRegistry Registry;
+	return Registry;
+}
+
+FMoonshotMoverModeHandle FMoonshotMoverModeRegistry::Register(FName ModeName)
+{
+	{
+		FReadScopeLock ReadLock(Lock);
+		if (const uint8* Index = NameToIndex.Find(ModeName))
+		{
+			return FMoonshotMoverModeHandle(*Index);
+		}
+	}
+
+	FWriteScopeLock WriteLock(Lock);
+	if (const uint8* Index = NameToIndex.Find(ModeName))
+	{
+		return FMoonshotMoverModeHandle(*Index);
+	}
+
+	if (!ensureMsgf(Names.Num() < EscapeIndex, TEXT("Too many movement modes registered (max %d). %s will be compared by name."), int32(EscapeIndex), *ModeName.ToString()))
+	{
+		return FMoonshotMoverModeHandle();
+	}
+
+	const uint8 NewIndex = static_cast<uint8>(Names.Add(ModeName));
+	NameToIndex.Add(ModeName, NewIndex);
+	return FMoonshotMoverModeHandle(NewIndex);
+}
+
+FMoonshotMoverModeHandle FMoonshotMoverModeRegistry::Find(FName ModeName) const
+{
+	FReadScopeLock ReadLock(Lock);
+	const uint8* Index = NameToIndex.Find(ModeName);
+	return Index ? FMoonshotMoverModeHandle(*Index) : FMoonshotMoverModeHandle();
+}
+
+FName FMoonshotMoverModeRegistry::GetName(FMoonshotMoverModeHandle Handle) const
+{
+	FReadScopeLock ReadLock(Lock);
+	return Names.IsValidIndex(Handle.GetIndex()) ? Names[Handle.GetIndex()] : NAME_None;
+}
+
+int32 FMoonshotMoverModeRegistry::Num() const
+{
+	FReadScopeLock ReadLock(Lock);
+	return Names.Num();
+}
+
+FName FMoonshotMoverModeHandle::GetName() const
+{
+	return FMoonshotMoverModeRegistry::Get().GetName(*this);
+}
+
+FMoonshotMoverModeHandle FMoonshotMoverModeHandle::Find(FName ModeName)
+{
+	return FMoonshotMoverModeRegistry::Get().Find(ModeName);
+}
+
+void FMoonshotMoverModeHandle::NetSerializeModeName(FArchive& Ar, FName& ModeName)
+{
+	uint32 WireIndex = 0;
+
+	if (Ar.IsSaving())
+	{
+		const FMoonshotMoverModeHandle Handle = Find(ModeName);
+		const bool bIsBuiltIn = Handle.GetIndex() < MoonshotModeHandles::NumBuiltIn && (Handle.IsValid() || ModeName.IsNone());
+		WireIndex = bIsBuiltIn ? Handle.GetIndex() : FMoonshotMoverModeRegistry::EscapeIndex;
+	}
+
+	Ar.SerializeBits(&WireIndex, FMoonshotMoverModeRegistry::NumBits);
+
+	if (WireIndex == FMoonshotMoverModeRegistry::EscapeIndex)
+	{
+		Ar << ModeName;
+	}
+	else if (Ar.IsLoading())
+	{
+		ModeName = (WireIndex < MoonshotModeHandles::NumBuiltIn) ? FMoonshotMoverModeHandle(static_cast<uint8>(WireIndex)).GetName() : NAME_None;
+	}
+}
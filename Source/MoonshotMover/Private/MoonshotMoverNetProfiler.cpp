@@ -0,0 +1,313 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "MoonshotMoverNetProfiler.h"
+#include "Engine/NetConnection.h"
+#include "Engine/PackageMapClient.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/BitReader.h"
+#include "Serialization/BitWriter.h"
+#include "UObject/CoreNet.h"
+#include "UObject/ObjectKey.h"
+#include "Mover/Public/MoverDataModelTypes.h"
+#include "Mover/Public/MoverLog.h"
+
+namespace MoonshotNetProfiler
+{
+	static bool bNetProfile = false;
+	static FAutoConsoleVariableRef CVarNetProfile(
+		TEXT("moonshot.Mover.NetProfile"),
+		bNetProfile,
+		TEXT("Count the bits each field of the MoonshotMover net structs costs, per connection and 60 sim frames. Dump with moonshot.Mover.NetProfileDump."));
+
+	// Rows are bucketed by sim frame rather than wall clock, so the same input produces the same CSV on any machine
+	constexpr int32 FramesPerBucket = 60;
+
+	// Buckets kept before the oldest are dropped
+	constexpr int32 MaxBuckets = 600;
+
+	const TCHAR* TotalField = TEXT("(total)");
+
+	struct FCounter
+	{
+		uint64 Bits = 0;
+		uint64 Count = 0;
+	};
+
+	// Keyed by the CSV columns "Connection,Direction,Struct,Field", which also makes sorted output diffable
+	using FBucket = TMap<FString, FCounter>;
+
+	struct FFrameBucket
+	{
+		int32 FirstFrame = 0;
+		FBucket Bucket;
+	};
+
+	FCriticalSection Lock;
+	FBucket Totals;
+	FBucket Current;
+	TArray<FFrameBucket> History;
+	int32 CurrentFirstFrame = 0;
+	TMap<TObjectKey<UPackageMap>, FString> ConnectionLabels;
+	int32 NumConnections = 0;
+
+	thread_local FMoonshotMoverNetProfiler::FStructScope* InnermostStruct = nullptr;
+
+	// Only bit streams know their position in bits. FBitWriter and FBitReader (and the FNetBitWriter/FNetBitReader the net
+	// driver uses) are the only archives that flag themselves as net archives; a proxy forwards that flag from the archive it
+	// wraps without being a bit stream itself, so anything that is not its own innermost state is skipped too.
+	int64 GetBitPosition(FArchive& Ar)
+	{
+		if (!Ar.IsNetArchive() || &Ar.GetInnermostState() != static_cast<FArchiveState*>(&Ar))
+		{
+			return INDEX_NONE;
+		}
+
+		if (Ar.IsSaving())
+		{
+			return static_cast<FBitWriter&>(Ar).GetNumBits();
+		}
+		if (Ar.IsLoading())
+		{
+			return static_cast<FBitReader&>(Ar).GetPosBits();
+		}
+		return INDEX_NONE;
+	}
+
+	const FString& GetConnectionLabel(const UPackageMap* Map)
+	{
+		if (const FString* Existing = ConnectionLabels.Find(Map))
+		{
+			return *Existing;
+		}
+
+		// Numbered in the order they are first seen, so labels do not depend on ports or addresses and runs can be diffed
+		const UPackageMapClient* Client = Cast<UPackageMapClient>(Map);
+		const UNetConnection* Connection = Client ? Client->GetConnection() : nullptr;
+		if (!Connection)
+		{
+			return ConnectionLabels.Add(Map, TEXT("None"));
+		}
+
+		return ConnectionLabels.Add(Map, FString::Printf(TEXT("Connection%d"), NumConnections++));
+	}
+
+	void AdvanceBucket(int32 Frame)
+	{
+		const int32 FirstFrame = Frame - (Frame % FramesPerBucket);
+		if (FirstFrame == CurrentFirstFrame)
+		{
+			return;
+		}
+
+		if (Current.Num() > 0)
+		{
+			if (History.Num() >= MaxBuckets)
+			{
+				History.RemoveAt(0);
+			}
+			History.Add({ CurrentFirstFrame, MoveTemp(Current) });
+			Current.Reset();
+		}
+		CurrentFirstFrame = FirstFrame;
+	}
+
+	void Record(const FString& Connection, bool bSending, const TCHAR* StructName, const TCHAR* FieldName, int64 Bits)
+	{
+		const FString Key = FString::Printf(TEXT("%s,%s,%s,%s"), *Connection, bSending ? TEXT("Send") : TEXT("Receive"), StructName, FieldName);
+
+		FScopeLock ScopeLock(&Lock);
+		for (FBucket* Bucket : { &Current, &Totals })
+		{
+			FCounter& Counter = Bucket->FindOrAdd(Key);
+			Counter.Bits += Bits;
+			++Counter.Count;
+		}
+	}
+
+	void AppendRows(FString& Out, const FString& Frame, const FBucket& Bucket)
+	{
+		TArray<FString> Keys;
+		Bucket.GetKeys(Keys);
+		Keys.Sort();
+
+		for (const FString& Key : Keys)
+		{
+			const FCounter& Counter = Bucket.FindChecked(Key);
+			Out += FString::Printf(TEXT("%s,%s,%llu,%llu,%.2f\n"), *Frame, *Key, Counter.Count, Counter.Bits, Counter.Count ? double(Counter.Bits) / Counter.Count : 0.0);
+		}
+	}
+
+	static FAutoConsoleCommand CmdDump(
+		TEXT("moonshot.Mover.NetProfileDump"),
+		TEXT("Write the MoonshotMover net profile to a CSV. Optional argument: file name, otherwise one is made up in the profiling directory."),
+		FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			const FString Filename = Args.Num() > 0
+				? Args[0]
+				: FPaths::ProfilingDir() / TEXT("MoonshotNetProfile") / FString::Printf(TEXT("NetProfile-%s.csv"), *FDateTime::Now().ToString());
+
+			if (FMoonshotMoverNetProfiler::WriteCsv(Filename))
+			{
+				UE_LOG(LogMover, Log, TEXT("Wrote MoonshotMover net profile to %s"), *Filename);
+			}
+			else
+			{
+				UE_LOG(LogMover, Warning, TEXT("Could not write MoonshotMover net profile to %s"), *Filename);
+			}
+		}));
+
+	static FAutoConsoleCommand CmdReset(
+		TEXT("moonshot.Mover.NetProfileReset"),
+		TEXT("Clear everything the MoonshotMover net profile has recorded."),
+		FConsoleCommandDelegate::CreateStatic(&FMoonshotMoverNetProfiler::Reset));
+}
+
+FMoonshotMoverNetProfiler::FStructScope::FStructScope(FArchive& InAr, const UPackageMap* InMap, const TCHAR* InStructName)
+{
+	using namespace MoonshotNetProfiler;
+
+	if (!bNetProfile)
+	{
+		return;
+	}
+
+	const int64 Position = GetBitPosition(InAr);
+	if (Position == INDEX_NONE)
+	{
+		return;
+	}
+
+	Ar = &InAr;
+	Map = InMap;
+	StructName = InStructName;
+	StartBits = Position;
+	Outer = InnermostStruct;
+	InnermostStruct = this;
+}
+
+FMoonshotMoverNetProfiler::FStructScope::~FStructScope()
+{
+	using namespace MoonshotNetProfiler;
+
+	if (!Ar)
+	{
+		return;
+	}
+
+	InnermostStruct = Outer;
+
+	FString Connection;
+	{
+		FScopeLock ScopeLock(&Lock);
+		Connection = GetConnectionLabel(Map);
+	}
+	Record(Connection, Ar->IsSaving(), StructName, TotalField, GetBitPosition(*Ar) - StartBits);
+}
+
+FMoonshotMoverNetProfiler::FFieldScope::FFieldScope(FArchive& Ar, const TCHAR* InFieldName)
+{
+	using namespace MoonshotNetProfiler;
+
+	// Fields are only attributed inside a struct scope on the same archive
+	if (!InnermostStruct || InnermostStruct->Ar != &Ar)
+	{
+		return;
+	}
+
+	Struct = InnermostStruct;
+	FieldName = InFieldName;
+	StartBits = GetBitPosition(Ar);
+}
+
+FMoonshotMoverNetProfiler::FFieldScope::~FFieldScope()
+{
+	using namespace MoonshotNetProfiler;
+
+	if (!Struct)
+	{
+		return;
+	}
+
+	FString Connection;
+	{
+		FScopeLock ScopeLock(&Lock);
+		Connection = GetConnectionLabel(Struct->Map);
+	}
+	Record(Connection, Struct->Ar->IsSaving(), Struct->StructName, FieldName, GetBitPosition(*Struct->Ar) - StartBits);
+}
+
+bool FMoonshotMoverNetProfiler::IsEnabled()
+{
+	return MoonshotNetProfiler::bNetProfile;
+}
+
+void FMoonshotMoverNetProfiler::SetSimFrame(int32 ServerFrame)
+{
+	using namespace MoonshotNetProfiler;
+
+	if (!bNetProfile || ServerFrame < 0)
+	{
+		return;
+	}
+
+	FScopeLock ScopeLock(&Lock);
+	AdvanceBucket(ServerFrame);
+}
+
+void FMoonshotMoverNetProfiler::SampleSyncState(const FMoverDefaultSyncState& SyncState)
+{
+	using namespace MoonshotNetProfiler;
+
+	if (!bNetProfile)
+	{
+		return;
+	}
+
+	// Without a package map an object reference cannot be written, so based states are measured as their world-space equivalent
+	FMoverDefaultSyncState Copy = SyncState;
+	if (Copy.GetMovementBase())
+	{
+		Copy.SetTransforms_WorldSpace(SyncState.GetLocation_WorldSpace(), SyncState.GetOrientation_WorldSpace(), SyncState.GetVelocity_WorldSpace(), nullptr);
+	}
+
+	FNetBitWriter Writer(nullptr, 0);
+	bool bSuccess = true;
+	Copy.NetSerialize(Writer, nullptr, bSuccess);
+
+	Record(TEXT("(sampled)"), true, TEXT("FMoverDefaultSyncState"), TotalField, Writer.GetNumBits());
+}
+
+bool FMoonshotMoverNetProfiler::WriteCsv(const FString& Filename)
+{
+	using namespace MoonshotNetProfiler;
+
+	FString Csv = TEXT("Frame,Connection,Direction,Struct,Field,Count,Bits,AvgBits\n");
+	{
+		FScopeLock ScopeLock(&Lock);
+
+		for (const FFrameBucket& Bucket : History)
+		{
+			AppendRows(Csv, FString::FromInt(Bucket.FirstFrame), Bucket.Bucket);
+		}
+		AppendRows(Csv, FString::FromInt(CurrentFirstFrame), Current);
+		AppendRows(Csv, TEXT("Total"), Totals);
+	}
+
+	return FFileHelper::SaveStringToFile(Csv, *Filename);
+}
+
+void FMoonshotMoverNetProfiler::Reset()
+{
+	using namespace MoonshotNetProfiler;
+
+	FScopeLock ScopeLock(&Lock);
+	Totals.Reset();
+	Current.Reset();
+	History.Reset();
+	ConnectionLabels.Reset();
+	NumConnections = 0;
+	CurrentFirstFrame = 0;
+}
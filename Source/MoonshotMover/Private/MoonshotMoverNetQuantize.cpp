@@ -0,0 +1,341 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "MoonshotMoverNetQuantize.h"
+#include "Mover/Public/LayeredMove.h"
+#include "Mover/Public/MoverLog.h"
+
+namespace MoonshotNetQuantize
+{
+	enum class EGravityMagnitude : uint32
+	{
+		Zero,
+		Standard,
+		Fixed,	// 16 bit, 0.1 cm/s^2 steps
+		Full,
+	};
+
+	enum class EDuration : uint32
+	{
+		Zero,
+		WholeMs,	// 16 bit
+		Full,
+	};
+
+	constexpr float FixedMagnitudeScale = 10.f;
+	constexpr float RotatorZeroTolerance = 1.e-3f;
+
+	float SignNotZero(float Value)
+	{
+		return (Value >= 0.f) ? 1.f : -1.f;
+	}
+
+	uint32 QuantizeSigned(float Value, uint32 MaxValue)
+	{
+		return static_cast<uint32>(FMath::RoundToInt32((FMath::Clamp(Value, -1.f, 1.f) * 0.5f + 0.5f) * MaxValue));
+	}
+
+	float DequantizeSigned(uint32 Value, uint32 MaxValue)
+	{
+		return (static_cast<float>(Value) / MaxValue) * 2.f - 1.f;
+	}
+}
+
+void FMoonshotMoverNetQuantize::SerializeOctahedralUnitVector(FArchive& Ar, FVector& InOutDirection, int32 BitsPerAxis)
+{
+	using namespace MoonshotNetQuantize;
+
+	const uint32 MaxValue = (1u << BitsPerAxis) - 1;
+	uint32 U = 0;
+	uint32 V = 0;
+
+	if (Ar.IsSaving())
+	{
+		// Project onto the octahedron |x|+|y|+|z| = 1 and fold the lower half over the upper one
+		const float L1Norm = FMath::Abs(InOutDirection.X) + FMath::Abs(InOutDirection.Y) + FMath::Abs(InOutDirection.Z);
+		float X = 0.f;
+		float Y = 0.f;
+		if (L1Norm > UE_SMALL_NUMBER)
+		{
+			X = InOutDirection.X / L1Norm;
+			Y = InOutDirection.Y / L1Norm;
+			if (InOutDirection.Z < 0.)
+			{
+				const float FoldedX = (1.f - FMath::Abs(Y)) * SignNotZero(X);
+				const float FoldedY = (1.f - FMath::Abs(X)) * SignNotZero(Y);
+				X = FoldedX;
+				Y = FoldedY;
+			}
+		}
+
+		U = QuantizeSigned(X, MaxValue);
+		V = QuantizeSigned(Y, MaxValue);
+	}
+
+	Ar.SerializeBits(&U, BitsPerAxis);
+	Ar.SerializeBits(&V, BitsPerAxis);
+
+	if (Ar.IsLoading())
+	{
+		float X = DequantizeSigned(U, MaxValue);
+		float Y = DequantizeSigned(V, MaxValue);
+		const float Z = 1.f - FMath::Abs(X) - FMath::Abs(Y);
+		if (Z < 0.f)
+		{
+			const float UnfoldedX = (1.f - FMath::Abs(Y)) * SignNotZero(X);
+			const float UnfoldedY = (1.f - FMath::Abs(X)) * SignNotZero(Y);
+			X = UnfoldedX;
+			Y = UnfoldedY;
+		}
+
+		InOutDirection = FVector(X, Y, Z).GetSafeNormal(UE_SMALL_NUMBER, FVector::UpVector);
+	}
+}
+
+void FMoonshotMoverNetQuantize::SerializeGravity(FArchive& Ar, FVector& InOutGravity)
+{
+	using namespace MoonshotNetQuantize;
+
+	uint32 MagnitudeIndex = 0;
+	float Magnitude = 0.f;
+
+	if (Ar.IsSaving())
+	{
+		Magnitude = InOutGravity.Size();
+		const float FixedMagnitude = FMath::RoundToFloat(Magnitude * FixedMagnitudeScale);
+
+		if (Magnitude < UE_KINDA_SMALL_NUMBER)
+		{
+			MagnitudeIndex = static_cast<uint32>(EGravityMagnitude::Zero);
+		}
+		else if (FMath::IsNearlyEqual(Magnitude, StandardGravityMagnitude, 0.05f))
+		{
+			MagnitudeIndex = static_cast<uint32>(EGravityMagnitude::Standard);
+		}
+		else if (FixedMagnitude <= MAX_uint16)
+		{
+			MagnitudeIndex = static_cast<uint32>(EGravityMagnitude::Fixed);
+		}
+		else
+		{
+			MagnitudeIndex = static_cast<uint32>(EGravityMagnitude::Full);
+		}
+	}
+
+	Ar.SerializeBits(&MagnitudeIndex, 2);
+
+	switch (static_cast<EGravityMagnitude>(MagnitudeIndex))
+	{
+	case EGravityMagnitude::Zero:
+		if (Ar.IsLoading())
+		{
+			InOutGravity = FVector::ZeroVector;
+		}
+		return;
+
+	case EGravityMagnitude::Standard:
+		Magnitude = StandardGravityMagnitude;
+		break;
+
+	case EGravityMagnitude::Fixed:
+	{
+		uint16 FixedMagnitude = Ar.IsSaving() ? static_cast<uint16>(FMath::RoundToInt32(Magnitude * FixedMagnitudeScale)) : 0;
+		Ar << FixedMagnitude;
+		Magnitude = FixedMagnitude / FixedMagnitudeScale;
+		break;
+	}
+
+	default:
+		Ar << Magnitude;
+		break;
+	}
+
+	FVector Direction = InOutGravity;
+	SerializeOctahedralUnitVector(Ar, Direction);
+
+	if (Ar.IsLoading())
+	{
+		InOutGravity = Direction * Magnitude;
+	}
+}
+
+void FMoonshotMoverNetQuantize::SerializeGravityRelativeRotation(FArchive& Ar, FRotator& InOutRotation, const FVector& Gravity)
+{
+	using namespace MoonshotNetQuantize;
+
+	const bool bHasGravityFrame = !Gravity.IsNearlyZero();
+	const FQuat GravityFrame = GetGravityFrame(Gravity);
+
+	uint16 Pitch = 0;
+	uint16 Yaw = 0;
+	uint16 Roll = 0;
+	bool bHasRoll = false;
+
+	if (Ar.IsSaving())
+	{
+		const FRotator Local = bHasGravityFrame ? (GravityFrame.Inverse() * InOutRotation.Quaternion()).Rotator() : InOutRotation;
+		Pitch = FRotator::CompressAxisToShort(Local.Pitch);
+		Yaw = FRotator::CompressAxisToShort(Local.Yaw);
+		Roll = FRotator::CompressAxisToShort(Local.Roll);
+		bHasRoll = (Roll != 0);
+	}
+
+	Ar << Pitch;
+	Ar << Yaw;
+	Ar.SerializeBits(&bHasRoll, 1);
+	if (bHasRoll)
+	{
+		Ar << Roll;
+	}
+
+	if (Ar.IsLoading())
+	{
+		const FRotator Local(FRotator::DecompressAxisFromShort(Pitch), FRotator::DecompressAxisFromShort(Yaw), bHasRoll ? FRotator::DecompressAxisFromShort(Roll) : 0.f);
+		InOutRotation = bHasGravityFrame ? (GravityFrame * Local.Quaternion()).Rotator() : Local;
+	}
+}
+
+void FMoonshotMoverNetQuantize::SerializeRotatorWithZeroFlag(FArchive& Ar, FRotator& InOutRotator)
+{
+	bool bIsZero = Ar.IsSaving() && InOutRotator.IsNearlyZero(MoonshotNetQuantize::RotatorZeroTolerance);
+	Ar.SerializeBits(&bIsZero, 1);
+
+	if (!bIsZero)
+	{
+		InOutRotator.SerializeCompressedShort(Ar);
+	}
+	else if (Ar.IsLoading())
+	{
+		InOutRotator = FRotator::ZeroRotator;
+	}
+}
+
+void FMoonshotMoverNetQuantize::SerializeDirectionWithZeroFlag(FArchive& Ar, FVector& InOutVector)
+{
+	bool bIsZero = Ar.IsSaving() && InOutVector.IsNearlyZero();
+	Ar.SerializeBits(&bIsZero, 1);
+
+	if (bIsZero)
+	{
+		if (Ar.IsLoading())
+		{
+			InOutVector = FVector::ZeroVector;
+		}
+		return;
+	}
+
+	float Size = Ar.IsSaving() ? InOutVector.Size() : 1.f;
+	bool bIsUnit = Ar.IsSaving() && FMath::IsNearlyEqual(Size, 1.f, 1.e-3f);
+	Ar.SerializeBits(&bIsUnit, 1);
+	if (!bIsUnit)
+	{
+		Ar << Size;
+	}
+
+	FVector Direction = InOutVector;
+	SerializeOctahedralUnitVector(Ar, Direction);
+
+	if (Ar.IsLoading())
+	{
+		InOutVector = Direction * (bIsUnit ? 1.f : Size);
+	}
+}
+
+FQuat FMoonshotMoverNetQuantize::GetGravityFrame(const FVector& Gravity)
+{
+	const FVector GravityUp = -Gravity.GetSafeNormal();
+	return GravityUp.IsZero() ? FQuat::Identity : FQuat::FindBetweenNormals(FVector::UpVector, GravityUp);
+}
+
+void FMoonshotMoverNetQuantize::SerializeLayeredMoveBase(FArchive& Ar, FLayeredMoveBase& InOutMove)
+{
+	using namespace MoonshotNetQuantize;
+
+	uint32 MixMode = static_cast<uint32>(InOutMove.MixMode);
+	Ar.SerializeBits(&MixMode, 2);
+
+	bool bHasPriority = (InOutMove.Priority != 0);
+	Ar.SerializeBits(&bHasPriority, 1);
+	uint8 Priority = bHasPriority ? InOutMove.Priority : 0;
+	if (bHasPriority)
+	{
+		Ar << Priority;
+	}
+
+	uint32 DurationKind = static_cast<uint32>(EDuration::Full);
+	if (Ar.IsSaving())
+	{
+		const float Duration = InOutMove.DurationMs;
+		if (Duration == 0.f)
+		{
+			DurationKind = static_cast<uint32>(EDuration::Zero);
+		}
+		else if (Duration > 0.f && Duration <= float(MAX_uint16) && Duration == FMath::RoundToFloat(Duration))
+		{
+			DurationKind = static_cast<uint32>(EDuration::WholeMs);
+		}
+	}
+	Ar.SerializeBits(&DurationKind, 2);
+
+	float DurationMs = InOutMove.DurationMs;
+	if (DurationKind == static_cast<uint32>(EDuration::WholeMs))
+	{
+		uint16 WholeMs = static_cast<uint16>(DurationMs);
+		Ar << WholeMs;
+		DurationMs = WholeMs;
+	}
+	else if (DurationKind == static_cast<uint32>(EDuration::Full))
+	{
+		Ar << DurationMs;
+	}
+	else
+	{
+		DurationMs = 0.f;
+	}
+
+	if (Ar.IsLoading())
+	{
+		InOutMove.MixMode = static_cast<EMoveMixMode>(MixMode);
+		InOutMove.Priority = Priority;
+		InOutMove.DurationMs = DurationMs;
+	}
+
+	// Absolute sim time: any rounding here would shift when the move starts and ends
+	Ar << InOutMove.StartSimTimeMs;
+
+	InOutMove.FinishVelocitySettings.NetSerialize(Ar);
+}
+
+void FMoonshotMoverNetQuantize::SerializeTableValue(FArchive& Ar, float& InOutValue, TConstArrayView<float> Table)
+{
+	const int32 MaxEntries = 1 << MaxTableBits;
+
+	uint32 Index = 0;
+	bool bInTable = false;
+	if (Ar.IsSaving())
+	{
+		const int32 Found = Table.Find(InOutValue);
+		bInTable = (Found != INDEX_NONE && Found < MaxEntries);
+		Index = bInTable ? Found : 0;
+	}
+
+	Ar.SerializeBits(&bInTable, 1);
+	if (!bInTable)
+	{
+		Ar << InOutValue;
+		return;
+	}
+
+	Ar.SerializeBits(&Index, MaxTableBits);
+	if (Ar.IsLoading())
+	{
+		// Corrupt or hostile data, or a table that differs between machines: reject the value rather than read out of bounds
+		if (!Table.IsValidIndex(Index))
+		{
+			UE_LOG(LogMover, Warning, TEXT("Received table index %u but the table has %d entries. Check that the configs match."), Index, Table.Num());
+			Ar.SetError();
+			InOutValue = 0.f;
+			return;
+		}
+		InOutValue = Table[Index];
+	}
+}
@@ -0,0 +1,109 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "MoonshotMoverProxySimulation.h"
+#include "MoonshotMoverCommonMovementSettings.h"
+#include "MoonshotMoverDataModelTypes.h"
+#include "MoonshotMoverDeterministicMath.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "Mover/Public/MoverComponent.h"
+#include "Mover/Public/MoverDataModelTypes.h"
+#include "Mover/Public/MoverSimulationTypes.h"
+#include "Mover/Public/MoverTypes.h"
+#include "Mover/Public/MoveLibrary/MoverBlackboard.h"
+
+namespace MoonshotProxySimulation
+{
+	// How recently a proxy must have been drawn to count as visible
+	constexpr float VisibleWithinSeconds = 0.2f;
+}
+
+bool FMoonshotMoverProxySimulation::ShouldExtrapolate(const UMoverComponent* MoverComponent, const UPrimitiveComponent* UpdatedPrimitive, const FMoverDefaultSyncState& StartSyncState, const UMoonshotMoverCommonMovementSettings& Settings)
+{
+	if (!Settings.bExtrapolateDistantProxies || !MoverComponent || !UpdatedPrimitive || MoverComponent->GetOwnerRole() != ROLE_SimulatedProxy)
+	{
+		return false;
+	}
+
+	// Based movement is relative to something that may itself be moving; leave that to the full sim
+	if (StartSyncState.GetMovementBase())
+	{
+		return false;
+	}
+
+	const UWorld* World = MoverComponent->GetWorld();
+	if (!World)
+	{
+		return false;
+	}
+
+	// Nearest view of any local player, so split screen keeps full sim around each of them
+	double DistSquared = TNumericLimits<double>::Max();
+	bool bHasLocalView = false;
+	for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* Controller = It->Get();
+		if (!Controller || !Controller->IsLocalController())
+		{
+			continue;
+		}
+
+		FVector ViewLocation;
+		FRotator ViewRotation;
+		Controller->GetPlayerViewPoint(ViewLocation, ViewRotation);
+		DistSquared = FMath::Min(DistSquared, FVector::DistSquared(ViewLocation, StartSyncState.GetLocation_WorldSpace()));
+		bHasLocalView = true;
+	}
+
+	if (!bHasLocalView || DistSquared < FMath::Square(Settings.ProxyFullSimDistance))
+	{
+		return false;
+	}
+
+	// Proxies on screen keep full collision further out, so scoped-in views do not show them clipping through geometry
+	if (DistSquared < FMath::Square(Settings.ProxyVisibleFullSimDistance) && UpdatedPrimitive->WasRecentlyRendered(MoonshotProxySimulation::VisibleWithinSeconds))
+	{
+		return false;
+	}
+
+	return true;
+}
+
+void FMoonshotMoverProxySimulation::GenerateMove(const FMoverDefaultSyncState& StartSyncState, const FRotator& AngularVelocity, FProposedMove& OutProposedMove)
+{
+	OutProposedMove.LinearVelocity = StartSyncState.GetVelocity_WorldSpace();
+	OutProposedMove.AngularVelocity = AngularVelocity;
+	OutProposedMove.DirectionIntent = StartSyncState.MoveDirectionIntent;
+	OutProposedMove.bHasDirIntent = !OutProposedMove.DirectionIntent.IsNearlyZero();
+}
+
+void FMoonshotMoverProxySimulation::Extrapolate(USceneComponent* UpdatedComponent, const FMoverDefaultSyncState& StartSyncState, const FProposedMove& ProposedMove, float DeltaSeconds, const UMoonshotMoverCommonMovementSettings& Settings, UMoverBlackboard* SimBlackboard, FMoverDefaultSyncState& OutputSyncState)
+{
+	const FMoonshotMoverMath Math(Settings.bUseDeterministicMath);
+
+	FQuat OrientQuat = Math.RotatorToQuat(StartSyncState.GetOrientation_WorldSpace());
+	if (!ProposedMove.AngularVelocity.IsZero())
+	{
+		OrientQuat = Math.GetNormalized(Math.Multiply(OrientQuat, Math.RotatorToQuat(ProposedMove.AngularVelocity * DeltaSeconds)));
+	}
+
+	const FVector Velocity = ProposedMove.LinearVelocity;
+	const FVector Location = StartSyncState.GetLocation_WorldSpace() + Velocity * DeltaSeconds;
+
+	UpdatedComponent->SetWorldLocationAndRotation(Location, OrientQuat, /*bSweep*/ false, nullptr, ETeleportType::None);
+	UpdatedComponent->ComponentVelocity = Velocity;
+
+	OutputSyncState.MoveDirectionIntent = (ProposedMove.bHasDirIntent ? ProposedMove.DirectionIntent : FVector::ZeroVector);
+	OutputSyncState.SetTransforms_WorldSpace(UpdatedComponent->GetComponentLocation(),
+											 UpdatedComponent->GetComponentRotation(),
+											 Velocity,
+											 nullptr); // no movement base
+
+	if (SimBlackboard)
+	{
+		SimBlackboard->Invalidate(CommonBlackboard::LastFloorResult);
+		SimBlackboard->Invalidate(CommonBlackboard::LastFoundDynamicMovementBase);
+		SimBlackboard->Invalidate(MoonshotBlackboard::PredictedContact);
+	}
+}
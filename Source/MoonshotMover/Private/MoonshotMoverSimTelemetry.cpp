@@ -0,0 +1,280 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "MoonshotMoverSimTelemetry.h"
+#include "MoonshotMoverInputLatency.h"
+#include "MoonshotMoverNetProfiler.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "UObject/ObjectKey.h"
+#include "Mover/Public/MoverComponent.h"
+#include "Mover/Public/MoverLog.h"
+#include "Mover/Public/MoverSimulationTypes.h"
+
+DECLARE_CYCLE_STAT(TEXT("Forward Sim Tick"), STAT_MoonshotMover_ForwardTick, STATGROUP_MoonshotMover);
+DECLARE_CYCLE_STAT(TEXT("Resim Tick"), STAT_MoonshotMover_ResimTick, STATGROUP_MoonshotMover);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Corrections"), STAT_MoonshotMover_Corrections, STATGROUP_MoonshotMover);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Reduced Cost Corrections"), STAT_MoonshotMover_ReducedCostCorrections, STATGROUP_MoonshotMover);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Resim Frames"), STAT_MoonshotMover_ResimFrames, STATGROUP_MoonshotMover);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Correction Error (cm)"), STAT_MoonshotMover_CorrectionError, STATGROUP_MoonshotMover);
+
+namespace MoonshotSimTelemetry
+{
+	static bool bEnableSimTelemetry = !UE_BUILD_SHIPPING;
+	static FAutoConsoleVariableRef CVarEnableSimTelemetry(
+		TEXT("moonshot.Mover.EnableSimTelemetry"),
+		bEnableSimTelemetry,
+		TEXT("Track corrections, resimulation cost and prediction error in every Moonshot sim tick. Off in shipping builds; a ResimBudgetMs above 0 keeps it on for the components it applies to."));
+
+	static bool bLogSimTelemetry = false;
+	static FAutoConsoleVariableRef CVarLogSimTelemetry(
+		TEXT("moonshot.Mover.LogSimTelemetry"),
+		bLogSimTelemetry,
+		TEXT("Log Moonshot correction and resimulation rates once a second."));
+
+	constexpr int32 NumPredictionSlots = 64;
+
+	// Weight of the newest resim tick in the running cost estimate the budget uses
+	constexpr double ResimCostSmoothing = 0.1;
+
+	struct FPredictionSlot
+	{
+		FVector Location = FVector::ZeroVector;
+		int32 ServerFrame = INDEX_NONE;
+	};
+
+	struct FComponentState
+	{
+		TWeakObjectPtr<const UMoverComponent> MoverComponent;
+		FPredictionSlot Predictions[NumPredictionSlots];
+		int32 LastServerFrame = INDEX_NONE;
+		int32 NewestForwardFrame = INDEX_NONE;
+		bool bWasResimulating = false;
+		bool bReducedCost = false;
+	};
+
+	TMap<TObjectKey<UMoverComponent>, FComponentState> States;
+
+	FMoonshotMoverSimTelemetry::FStats Totals;
+	FMoonshotMoverSimTelemetry::FStats Window;
+	double WindowStartSeconds = 0.0;
+	double AverageResimTickMs = 0.0;
+
+	FComponentState& FindOrAdd(const UMoverComponent* MoverComponent)
+	{
+		if (FComponentState* Existing = States.Find(MoverComponent))
+		{
+			return *Existing;
+		}
+
+		// New components are rare, so drop the state of destroyed ones here
+		for (auto It = States.CreateIterator(); It; ++It)
+		{
+			if (!It.Value().MoverComponent.IsValid())
+			{
+				It.RemoveCurrent();
+			}
+		}
+
+		FComponentState& NewState = States.Add(MoverComponent);
+		NewState.MoverComponent = MoverComponent;
+		return NewState;
+	}
+
+	void AddToBoth(TFunctionRef<void(FMoonshotMoverSimTelemetry::FStats&)> Update)
+	{
+		Update(Totals);
+		Update(Window);
+	}
+
+	void RecordCorrection(FComponentState& State, const FMoverTimeStep& TimeStep, const FMoverDefaultSyncState& StartSyncState, float ResimBudgetMs)
+	{
+		INC_DWORD_STAT(STAT_MoonshotMover_Corrections);
+
+		// We were rolled back to the authority's state; our own output for the frame before is what it replaced
+		const FPredictionSlot& Prediction = State.Predictions[(TimeStep.ServerFrame - 1 + NumPredictionSlots) % NumPredictionSlots];
+		const bool bHasPrediction = (Prediction.ServerFrame == TimeStep.ServerFrame - 1);
+		const double ErrorCm = bHasPrediction ? FVector::Dist(StartSyncState.GetLocation_WorldSpace(), Prediction.Location) : 0.0;
+
+		if (bHasPrediction)
+		{
+			SET_FLOAT_STAT(STAT_MoonshotMover_CorrectionError, ErrorCm);
+		}
+
+		const int32 FramesToResim = FMath::Max(1, State.NewestForwardFrame - TimeStep.ServerFrame + 1);
+		State.bReducedCost = ResimBudgetMs > 0.f && FramesToResim * AverageResimTickMs > ResimBudgetMs;
+
+		if (State.bReducedCost)
+		{
+			INC_DWORD_STAT(STAT_MoonshotMover_ReducedCostCorrections);
+		}
+
+		AddToBoth([&](FMoonshotMoverSimTelemetry::FStats& Stats)
+		{
+			++Stats.Corrections;
+			Stats.ReducedCostCorrections += State.bReducedCost ? 1 : 0;
+			if (bHasPrediction)
+			{
+				++Stats.MeasuredCorrections;
+				Stats.TotalErrorCm += ErrorCm;
+				Stats.MaxErrorCm = FMath::Max(Stats.MaxErrorCm, ErrorCm);
+			}
+		});
+	}
+
+	void FlushWindow()
+	{
+		const double Now = FPlatformTime::Seconds();
+		const double Elapsed = Now - WindowStartSeconds;
+		if (Elapsed < 1.0)
+		{
+			return;
+		}
+
+		if (bLogSimTelemetry && WindowStartSeconds > 0.0)
+		{
+			UE_LOG(LogMover, Log, TEXT("Sim telemetry: %.1f corrections/s (%.1f reduced cost), %.1f resim frames/s, %.1f frames/correction, forward %.2f ms/s, resim %.2f ms/s, error avg %.2f cm max %.2f cm"),
+				Window.Corrections / Elapsed,
+				Window.ReducedCostCorrections / Elapsed,
+				Window.ResimFrames / Elapsed,
+				Window.Corrections ? double(Window.ResimFrames) / Window.Corrections : 0.0,
+				Window.ForwardTickMs / Elapsed,
+				Window.ResimTickMs / Elapsed,
+				Window.MeasuredCorrections ? Window.TotalErrorCm / Window.MeasuredCorrections : 0.0,
+				Window.MaxErrorCm);
+		}
+
+		Window = FMoonshotMoverSimTelemetry::FStats();
+		WindowStartSeconds = Now;
+	}
+
+	static FAutoConsoleCommand CmdLogTotals(
+		TEXT("moonshot.Mover.SimTelemetry"),
+		TEXT("Log Moonshot correction and resimulation totals since startup."),
+		FConsoleCommandDelegate::CreateLambda([]()
+		{
+			const FMoonshotMoverSimTelemetry::FStats Stats = FMoonshotMoverSimTelemetry::GetStats();
+			UE_LOG(LogMover, Log, TEXT("Sim telemetry totals: %llu corrections (%llu reduced cost), %llu resim frames, %llu forward frames, forward %.1f ms, resim %.1f ms, error avg %.2f cm max %.2f cm"),
+				Stats.Corrections,
+				Stats.ReducedCostCorrections,
+				Stats.ResimFrames,
+				Stats.ForwardFrames,
+				Stats.ForwardTickMs,
+				Stats.ResimTickMs,
+				Stats.MeasuredCorrections ? Stats.TotalErrorCm / Stats.MeasuredCorrections : 0.0,
+				Stats.MaxErrorCm);
+		}));
+}
+
+FMoonshotMoverSimTelemetry::FStats FMoonshotMoverSimTelemetry::GetStats()
+{
+	return MoonshotSimTelemetry::Totals;
+}
+
+FMoonshotMoverSimTickScope::FMoonshotMoverSimTickScope(const UMoverComponent* InMoverComponent, const FMoverTimeStep& TimeStep, const FMoverDefaultSyncState& StartSyncState, const FMoverDefaultSyncState& InOutputSyncState, float ResimBudgetMs)
+	: MoverComponent(InMoverComponent)
+	, OutputSyncState(InOutputSyncState)
+	, ServerFrame(TimeStep.ServerFrame)
+	, StartCycles(0)
+	, bIsResimulating(TimeStep.bIsResimulating)
+	, CycleCounter(TimeStep.bIsResimulating ? GET_STATID(STAT_MoonshotMover_ResimTick) : GET_STATID(STAT_MoonshotMover_ForwardTick))
+{
+	using namespace MoonshotSimTelemetry;
+
+	if (!MoverComponent)
+	{
+		return;
+	}
+
+	if (!bIsResimulating)
+	{
+		FMoonshotMoverInputLatency::MarkSimulationTick(MoverComponent, ServerFrame);
+	}
+
+	// The budget estimates resim cost from the same bookkeeping, so it needs it even with telemetry off
+	bIsTracking = bEnableSimTelemetry || ResimBudgetMs > 0.f;
+	if (!bIsTracking)
+	{
+		return;
+	}
+
+	StartCycles = FPlatformTime::Cycles64();
+	FlushWindow();
+
+	FComponentState& State = FindOrAdd(MoverComponent);
+
+	// A mode change can tick twice in one frame, so only a switch into resim or a step back in time is a new correction
+	const bool bIsNewFrame = (ServerFrame != State.LastServerFrame || bIsResimulating != State.bWasResimulating);
+	if (bIsResimulating && (!State.bWasResimulating || ServerFrame < State.LastServerFrame))
+	{
+		RecordCorrection(State, TimeStep, StartSyncState, ResimBudgetMs);
+	}
+
+	if (bIsNewFrame)
+	{
+		if (bIsResimulating)
+		{
+			INC_DWORD_STAT(STAT_MoonshotMover_ResimFrames);
+		}
+		AddToBoth([this](FMoonshotMoverSimTelemetry::FStats& Stats)
+		{
+			++(bIsResimulating ? Stats.ResimFrames : Stats.ForwardFrames);
+		});
+	}
+
+	if (!bIsResimulating)
+	{
+		State.NewestForwardFrame = ServerFrame;
+		State.bReducedCost = false;
+	}
+
+	State.LastServerFrame = ServerFrame;
+	State.bWasResimulating = bIsResimulating;
+	bReducedCost = State.bReducedCost;
+}
+
+FMoonshotMoverSimTickScope::~FMoonshotMoverSimTickScope()
+{
+	using namespace MoonshotSimTelemetry;
+
+	if (!MoverComponent)
+	{
+		return;
+	}
+
+	// The mode has moved the updated component by now
+	if (!bIsResimulating)
+	{
+		FMoonshotMoverInputLatency::MarkTransformApplied(MoverComponent, ServerFrame);
+	}
+
+	if (bIsTracking)
+	{
+		const uint64 EndCycles = FPlatformTime::Cycles64();
+		const double TickMs = FPlatformTime::ToMilliseconds64(EndCycles - StartCycles);
+
+		if (bIsResimulating)
+		{
+			AverageResimTickMs = (AverageResimTickMs > 0.0) ? FMath::Lerp(AverageResimTickMs, TickMs, ResimCostSmoothing) : TickMs;
+		}
+
+		AddToBoth([this, TickMs](FMoonshotMoverSimTelemetry::FStats& Stats)
+		{
+			(bIsResimulating ? Stats.ResimTickMs : Stats.ForwardTickMs) += TickMs;
+		});
+
+		FPredictionSlot& Prediction = FindOrAdd(MoverComponent).Predictions[(ServerFrame + NumPredictionSlots) % NumPredictionSlots];
+		Prediction.ServerFrame = ServerFrame;
+		Prediction.Location = OutputSyncState.GetLocation_WorldSpace();
+	}
+
+	if (!bIsResimulating && FMoonshotMoverNetProfiler::IsEnabled())
+	{
+		FMoonshotMoverNetProfiler::SetSimFrame(ServerFrame);
+
+		// The server's output is what goes out as sync state
+		if (MoverComponent->GetOwnerRole() == ROLE_Authority)
+		{
+			FMoonshotMoverNetProfiler::SampleSyncState(OutputSyncState);
+		}
+	}
+}
@@ -2,6 +2,14 @@
 
 #include "MoonshotMoverSurfaceWalkingMode.h"
 #include "MoonshotMoverDataModelTypes.h"
+#include "MoonshotMoverDeterministicMath.h"
+#include "MoonshotMoverInputBaselines.h"
+#include "MoonshotMoverInputLatency.h"
+#include "MoonshotMoverModeRegistry.h"
+#include "MoonshotMoverNetProfiler.h"
+#include "MoonshotMoverNetQuantize.h"
+#include "MoonshotMoverProxySimulation.h"
+#include "MoonshotMoverSimTelemetry.h"
 #include "MoonshotMoverUtils.h"
 #include "Kismet/KismetSystemLibrary.h"
 #include "Kismet/BlueprintFunctionLibrary.h"
@@ -29,10 +37,23 @@ UMoonshotMoverSurfaceWalkingMode::UMoonshotMoverSurfaceWalkingMode(const FObject
 void UMoonshotMoverSurfaceWalkingMode::OnGenerateMove(const FMoverTickStartData& StartState, const FMoverTimeStep& TimeStep, FProposedMove& OutProposedMove) const
 {
 	const UMoverComponent* MoverComp = GetMoverComponent();
-    const FMoonshotMoverCharacterInputs* CharacterInputs = StartState.InputCmd.InputCollection.FindDataByType<FMoonshotMoverCharacterInputs>();
+    FMoonshotMoverCharacterInputs RepairedInputs;
+    const FMoonshotMoverCharacterInputs* CharacterInputs = FMoonshotMoverInputRepair::Resolve(GetMoverComponent(), GetBlackboard_Mutable(), TimeStep,
+    	StartState.InputCmd.InputCollection.FindDataByType<FMoonshotMoverCharacterInputs>(), RepairedInputs);
+    if (CharacterInputs)
+    {
+    	FMoonshotMoverInputLatency::MarkGenerateMove(GetMoverComponent(), TimeStep, CharacterInputs->LatencyStamp);
+    }
 	const FMoverDefaultSyncState* StartingSyncState = StartState.SyncState.SyncStateCollection.FindDataByType<FMoverDefaultSyncState>();
 	check(StartingSyncState);
 
+	// Distant, unseen proxies skip move generation as well as the collision in OnSimulationTick
+	if (FMoonshotMoverProxySimulation::ShouldExtrapolate(GetMoverComponent(), Cast<UPrimitiveComponent>(GetMoverComponent()->GetUpdatedComponent()), *StartingSyncState, *CommonMovementSettings))
+	{
+		FMoonshotMoverProxySimulation::GenerateMove(*StartingSyncState, FRotator::ZeroRotator, OutProposedMove);
+		return;
+	}
+
     const float DeltaSeconds = TimeStep.StepMs * 0.001f;
 	FFloorCheckResult LastFloorResult;
 	FVector MovementNormal;
@@ -46,7 +67,10 @@ void UMoonshotMoverSurfaceWalkingMode::OnGenerateMove(const FMoverTickStartData&
 	}
 	else
 	{
-		MovementNormal = MoverComp->GetOwner()->GetActorUpVector();
+		FMoonshotMoverFloorHandoff FloorHandoff;
+		MovementNormal = FMoonshotMoverFloorHandoff::TryGetValid(SimBlackboard, MoverComp->GetOwner()->GetActorLocation(), CommonMovementSettings->FloorHandoffTolerance, FloorHandoff)
+			? FloorHandoff.ContactNormal
+			: MoverComp->GetOwner()->GetActorUpVector();
 	}
 
 	FSurfaceWalkingModeParams Params;
@@ -56,14 +80,19 @@ void UMoonshotMoverSurfaceWalkingMode::OnGenerateMove(const FMoverTickStartData&
 		//Params.MoveInput = CharacterInputs->GetMoveInput();
         Params.MoveInput = CharacterInputs->GetMoveInput_WorldSpace();
         Params.ControlRotation = CharacterInputs->ControlRotation;
-        Params.GravityAcceleration = CharacterInputs->GravityAcceleration;
-        MovementNormal = -CharacterInputs->GravityAcceleration.GetSafeNormal();
 	}
 	else
 	{
 		Params.MoveInputType = EMoveInputType::Invalid;
 		Params.MoveInput = FVector::ZeroVector;
 	}
+
+	// Derived gravity is along our own down, so only an accepted input override replaces the floor-based movement normal
+	Params.GravityAcceleration = FMoonshotMoverGravity::Resolve(*StartingSyncState, CharacterInputs, *CommonMovementSettings);
+	if (FMoonshotMoverGravity::IsInputAuthored(CharacterInputs, *CommonMovementSettings))
+	{
+		MovementNormal = -Params.GravityAcceleration.GetSafeNormal();
+	}
 	Params.PriorVelocity = FVector::VectorPlaneProject(StartingSyncState->GetVelocity_WorldSpace(), MovementNormal);
 	Params.PriorOrientation = StartingSyncState->GetOrientation_WorldSpace();
 	Params.TurningRate = CommonMovementSettings->TurningRate;
@@ -83,6 +112,8 @@ void UMoonshotMoverSurfaceWalkingMode::OnGenerateMove(const FMoverTickStartData&
 		Params.Friction *= CommonMovementSettings->BrakingFrictionFactor;
 	}
 
+    const FMoonshotMoverMath Math(CommonMovementSettings->bUseDeterministicMath);
+
     FRotator IntendedOrientation_WorldSpace;
     if (!CharacterInputs || CharacterInputs->OrientationIntent.IsNearlyZero())
     {
@@ -91,8 +122,7 @@ void UMoonshotMoverSurfaceWalkingMode::OnGenerateMove(const FMoverTickStartData&
 
     } else
     {
-		FVector InOrient = CharacterInputs->GetOrientationIntentDir_WorldSpace();
-        IntendedOrientation_WorldSpace = CharacterInputs->GetOrientationIntentDir_WorldSpace().ToOrientationRotator();
+        IntendedOrientation_WorldSpace = Math.VectorToRotator(CharacterInputs->GetOrientationIntentDir_WorldSpace());
     }
 
     Params.OrientationIntent = IntendedOrientation_WorldSpace;
@@ -131,20 +161,22 @@ void UMoonshotMoverSurfaceWalkingMode::OnGenerateMove(const FMoverTickStartData&
 
     if (Params.DeltaSeconds > 0.0f)
     {
-        Params.OrientationIntent = Params.OrientationIntent.Vector().ToOrientationRotator();
-        Params.PriorOrientation = Params.PriorOrientation.Vector().ToOrientationRotator();
+        Params.OrientationIntent = Math.VectorToRotator(Math.RotatorToVector(Params.OrientationIntent));
+        Params.PriorOrientation = Math.VectorToRotator(Math.RotatorToVector(Params.PriorOrientation));
 
-        Params.OrientationIntent = GetMoverComponent()->GetOwner()->GetActorTransform().InverseTransformRotation(Params.OrientationIntent.Quaternion()).Rotator();
-        Params.PriorOrientation = GetMoverComponent()->GetOwner()->GetActorTransform().InverseTransformRotation(Params.PriorOrientation.Quaternion()).Rotator();
+        const FQuat InverseActorQuat = GetMoverComponent()->GetOwner()->GetActorQuat().Inverse();
 
-        FQuat DeltaQuat = FQuat::FindBetweenNormals(Params.PriorOrientation.Vector(), Params.OrientationIntent.Vector());
-        FRotator AngularDelta = DeltaQuat.Rotator();
+        Params.OrientationIntent = Math.QuatToRotator(Math.Multiply(InverseActorQuat, Math.RotatorToQuat(Params.OrientationIntent)));
+        Params.PriorOrientation = Math.QuatToRotator(Math.Multiply(InverseActorQuat, Math.RotatorToQuat(Params.PriorOrientation)));
+
+        FQuat DeltaQuat = Math.FindBetweenNormals(Math.RotatorToVector(Params.PriorOrientation), Math.RotatorToVector(Params.OrientationIntent));
+        FRotator AngularDelta = Math.QuatToRotator(DeltaQuat);
 
         //UE_LOG(LogTemp, Display, TEXT("Delta: %s"), *AngularDelta.ToString());
 
         FRotator Winding, Remainder;
 
-        AngularDelta.GetWindingAndRemainder(Winding, Remainder);
+        Math.GetWindingAndRemainder(AngularDelta, Winding, Remainder);
 
         AngularVelocityDpS = Remainder * (1.0f / Params.DeltaSeconds);
 
@@ -177,11 +209,14 @@ void UMoonshotMoverSurfaceWalkingMode::OnSimulationTick(const FSimulationTickPar
 		return;
 	}
 
-    const FMoonshotMoverCharacterInputs* CharacterInputs = StartState.InputCmd.InputCollection.FindDataByType<FMoonshotMoverCharacterInputs>();
+    FMoonshotMoverCharacterInputs RepairedInputs;
+    const FMoonshotMoverCharacterInputs* CharacterInputs = FMoonshotMoverInputRepair::Resolve(GetMoverComponent(), GetBlackboard_Mutable(), Params.TimeStep,
+    	StartState.InputCmd.InputCollection.FindDataByType<FMoonshotMoverCharacterInputs>(), RepairedInputs);
 	const FMoverDefaultSyncState* StartingSyncState = StartState.SyncState.SyncStateCollection.FindDataByType<FMoverDefaultSyncState>();
 	check(StartingSyncState);
 
 	FMoverDefaultSyncState& OutputSyncState = OutputState.SyncState.SyncStateCollection.FindOrAddMutableDataByType<FMoverDefaultSyncState>();
+	const FMoonshotMoverSimTickScope TickScope(GetMoverComponent(), Params.TimeStep, *StartingSyncState, OutputSyncState, CommonMovementSettings->ResimBudgetMs);
 
 	const float DeltaSeconds = Params.TimeStep.StepMs * 0.001f;
     float PctTimeApplied = 0.f;
@@ -197,6 +232,13 @@ void UMoonshotMoverSurfaceWalkingMode::OnSimulationTick(const FSimulationTickPar
 		return;
 	}
 
+	// Distant, unseen proxies only need to look plausible until the next server update
+	if (FMoonshotMoverProxySimulation::ShouldExtrapolate(GetMoverComponent(), UpdatedPrimitive, *StartingSyncState, *CommonMovementSettings))
+	{
+		FMoonshotMoverProxySimulation::Extrapolate(UpdatedComponent, *StartingSyncState, ProposedMove, DeltaSeconds, *CommonMovementSettings, GetBlackboard_Mutable(), OutputSyncState);
+		return;
+	}
+
 	TObjectPtr<AActor> OwnerActor = UpdatedComponent->GetOwner();
 	check(OwnerActor);
 
@@ -207,12 +249,25 @@ void UMoonshotMoverSurfaceWalkingMode::OnSimulationTick(const FSimulationTickPar
     FFloorCheckResult CurrentFloor;
 	UMoverBlackboard* SimBlackboard = GetBlackboard_Mutable();
 
-	// If we don't have cached floor information, we need to search for it again
-	if (!SimBlackboard->TryGet(CommonBlackboard::LastFloorResult, CurrentFloor))
+	// If we don't have cached floor information, reuse a floor handed off by the previous mode, or search for it again
+	const bool bHasCachedFloor = SimBlackboard->TryGet(CommonBlackboard::LastFloorResult, CurrentFloor);
+	if (!bHasCachedFloor)
 	{
-		UMoonshotMoverUtils::FindFloor(UpdatedComponent, UpdatedPrimitive,
-			CommonMovementSettings->FloorSweepDistance, CommonMovementSettings->MaxWalkSlopeCosine,
-			UpdatedPrimitive->GetComponentLocation(), CurrentFloor);
+		FMoonshotMoverFloorHandoff FloorHandoff;
+		if (FMoonshotMoverFloorHandoff::TryGetValid(SimBlackboard, UpdatedPrimitive->GetComponentLocation(), CommonMovementSettings->FloorHandoffTolerance, FloorHandoff))
+		{
+			CurrentFloor = FloorHandoff.Floor;
+			if (FloorHandoff.BaseInfo.HasRelativeInfo())
+			{
+				SimBlackboard->Set(CommonBlackboard::LastFoundDynamicMovementBase, FloorHandoff.BaseInfo);
+			}
+		}
+		else
+		{
+			UMoonshotMoverUtils::FindFloor(UpdatedComponent, UpdatedPrimitive,
+				CommonMovementSettings->FloorSweepDistance, CommonMovementSettings->MaxWalkSlopeCosine,
+				UpdatedPrimitive->GetComponentLocation(), CurrentFloor);
+		}
 	}
  
 	OutputSyncState.MoveDirectionIntent = (ProposedMove.bHasDirIntent ? ProposedMove.DirectionIntent : FVector::ZeroVector);
@@ -220,12 +275,14 @@ void UMoonshotMoverSurfaceWalkingMode::OnSimulationTick(const FSimulationTickPar
 	// Use the orientation intent directly. If no intent is provided, use last frame's orientation. Note that we are assuming rotation changes can't fail. 
 	const FRotator StartingOrient = StartingSyncState->GetOrientation_WorldSpace();
 
+    const FMoonshotMoverMath Math(CommonMovementSettings->bUseDeterministicMath);
+
     // Apply orientation changes (if any)
-    FQuat OrientQuat = StartingOrient.Quaternion();
+    FQuat OrientQuat = Math.RotatorToQuat(StartingOrient);
 	if (!ProposedMove.AngularVelocity.IsZero())
 	{
-        FQuat AngularVelocityQuat = (ProposedMove.AngularVelocity * DeltaSeconds).Quaternion();
-        OrientQuat = OrientQuat * AngularVelocityQuat;
+        FQuat AngularVelocityQuat = Math.RotatorToQuat(ProposedMove.AngularVelocity * DeltaSeconds);
+        OrientQuat = Math.Multiply(OrientQuat, AngularVelocityQuat);
 	}
 
     // Get gravity-relative up direction for adjusting orientation
@@ -242,14 +299,10 @@ void UMoonshotMoverSurfaceWalkingMode::OnSimulationTick(const FSimulationTickPar
         return;
     }
 
-    FQuat GravityQuat = FQuat::FindBetweenNormals(CurrentUp, GravityUp);
-    OrientQuat = GravityQuat * OrientQuat;
-
+    FQuat GravityQuat = Math.FindBetweenNormals(CurrentUp, GravityUp);
+    OrientQuat = Math.Multiply(GravityQuat, OrientQuat);
 
-	/// TODO: Remove debug slerp
-	OrientQuat = FQuat::Slerp(StartingOrient.Quaternion(), OrientQuat, 1.0f);
-
-    OrientQuat.Normalize();
+    OrientQuat = Math.GetNormalized(OrientQuat);
 	
     const FVector OrigMoveDelta = ProposedMove.LinearVelocity * DeltaSeconds;
 
@@ -358,15 +411,23 @@ void UMoonshotMoverSurfaceWalkingMode::OnSimulationTick(const FSimulationTickPar
 			OutputState.MovementEndState.RemainingMs = Params.TimeStep.StepMs - (Params.TimeStep.StepMs * PercentTimeAppliedSoFar);
 			MoveRecord.SetDeltaSeconds((Params.TimeStep.StepMs - OutputState.MovementEndState.RemainingMs) * 0.001f);
 			CaptureFinalState(UpdatedComponent, bDidAttemptMovement, CurrentFloor, MoveRecord, OutputSyncState);
+			FMoonshotDeterministicMath::LogSyncStateChecksum(GetMoverComponent(), Params.TimeStep, OutputSyncState);
 			return;
 		}
 	}
     else
     {
-        // If the actor isn't moving we still need to check if they have a valid floor
-		UMoonshotMoverUtils::FindFloor(UpdatedComponent, UpdatedPrimitive,
-			CommonMovementSettings->FloorSweepDistance, CommonMovementSettings->MaxWalkSlopeCosine,
-			UpdatedPrimitive->GetComponentLocation(), CurrentFloor);
+        // If the actor isn't moving we still need to check if they have a valid floor. An over-budget resim trusts last tick's floor
+        // instead when it is static geometry, since standing still on it cannot change it.
+        const UPrimitiveComponent* CachedFloorComponent = CurrentFloor.HitResult.GetComponent();
+        const bool bReuseStaticFloor = TickScope.IsReducedCost() && bHasCachedFloor && CurrentFloor.IsWalkableFloor()
+            && !CurrentFloor.HitResult.bStartPenetrating && CachedFloorComponent && CachedFloorComponent->Mobility == EComponentMobility::Static;
+        if (!bReuseStaticFloor)
+        {
+            UMoonshotMoverUtils::FindFloor(UpdatedComponent, UpdatedPrimitive,
+                CommonMovementSettings->FloorSweepDistance, CommonMovementSettings->MaxWalkSlopeCosine,
+                UpdatedPrimitive->GetComponentLocation(), CurrentFloor);
+        }
         
         FHitResult Hit(CurrentFloor.HitResult);
         if (Hit.bStartPenetrating)
@@ -384,6 +445,7 @@ void UMoonshotMoverSurfaceWalkingMode::OnSimulationTick(const FSimulationTickPar
     }
 
     CaptureFinalState(UpdatedComponent, bDidAttemptMovement, CurrentFloor, MoveRecord, OutputSyncState);
+    FMoonshotDeterministicMath::LogSyncStateChecksum(GetMoverComponent(), Params.TimeStep, OutputSyncState);
 }
 
 bool UMoonshotMoverSurfaceWalkingMode::AttemptJump(float JumpSpeed, FMoverTickEndData& OutputState)
@@ -413,6 +475,7 @@ bool UMoonshotMoverSurfaceWalkingMode::AttemptTeleport(USceneComponent* UpdatedC
 		{
 			SimBlackboard->Invalidate(CommonBlackboard::LastFloorResult);
 			SimBlackboard->Invalidate(CommonBlackboard::LastFoundDynamicMovementBase);
+			SimBlackboard->Invalidate(MoonshotBlackboard::FloorHandoff);
 		}
 
 		return true;
@@ -433,6 +496,7 @@ void UMoonshotMoverSurfaceWalkingMode::CaptureFinalState(USceneComponent* Update
 	const bool bHasPriorBaseInfo = SimBlackboard->TryGet(CommonBlackboard::LastFoundDynamicMovementBase, PriorBaseInfo);
 
 	FRelativeBaseInfo CurrentBaseInfo = UpdateFloorAndBaseInfo(FloorResult);
+	FMoonshotMoverFloorHandoff::Publish(SimBlackboard, CommonMovementSettings->GroundMovementModeName, FloorResult, CurrentBaseInfo, UpdatedComponent->GetComponentLocation());
 
 	// If we're on a dynamic base and we're not trying to move, keep using the same relative actor location. This prevents slow relative 
 	//  drifting that can occur from repeated floor sampling as the base moves through the world.
@@ -487,6 +551,9 @@ void UMoonshotMoverSurfaceWalkingMode::OnRegistered(const FName ModeName)
 {
 	Super::OnRegistered(ModeName);
 
+	// Resolve our handle now so mode checks elsewhere never touch the name table
+	FMoonshotMoverModeRegistry::Get().Register(ModeName);
+
 	CommonMovementSettings = GetMoverComponent()->FindSharedSettings<UMoonshotMoverCommonMovementSettings>();
 	ensureMsgf(CommonMovementSettings, TEXT("Failed to find instance of MoonshotMoverCommonMovementSettings on %s. Movement may not function properly."), *GetPathNameSafe(this));
 }
@@ -1071,9 +1138,20 @@ FLayeredMoveBase* FLayeredMove_SurfaceWalkingModeJumpImpulse::Clone() const
 
 void FLayeredMove_SurfaceWalkingModeJumpImpulse::NetSerialize(FArchive& Ar)
 {
-	Super::NetSerialize(Ar);
+	FMoonshotMoverNetProfiler::FStructScope ProfileScope(Ar, nullptr, TEXT("FLayeredMove_SurfaceWalkingModeJumpImpulse"));
+	{
+		FMoonshotMoverNetProfiler::FFieldScope ProfileField(Ar, TEXT("Base"));
+		FMoonshotMoverNetQuantize::SerializeLayeredMoveBase(Ar, *this);
+	}
+	FMoonshotMoverNetProfiler::FFieldScope ProfileField(Ar, TEXT("UpwardsSpeed"));
+	FMoonshotMoverNetQuantize::SerializeTableValue(Ar, UpwardsSpeed, GetDefault<UMoonshotMoverCommonMovementSettings>()->NetJumpSpeedTable);
+}
 
-	Ar << UpwardsSpeed;
+bool FLayeredMove_SurfaceWalkingModeJumpImpulse::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	NetSerialize(Ar);
+	bOutSuccess = !Ar.IsError();
+	return true;
 }
 
 UScriptStruct* FLayeredMove_SurfaceWalkingModeJumpImpulse::GetScriptStruct() const
@@ -9,6 +9,11 @@
 
 
 bool UMoonshotMoverUtils::IsHitSurfaceWalkable(const FHitResult& Hit, float MaxWalkSlopeCosine, const USceneComponent* UpdatedComponent)
+{
+	return IsHitSurfaceWalkableForUp(Hit, MaxWalkSlopeCosine, UpdatedComponent->GetUpVector());
+}
+
+bool UMoonshotMoverUtils::IsHitSurfaceWalkableForUp(const FHitResult& Hit, float MaxWalkSlopeCosine, const FVector& ComponentUp)
 {
 	if (!Hit.IsValidBlockingHit())
 	{
@@ -36,7 +41,6 @@ bool UMoonshotMoverUtils::IsHitSurfaceWalkable(const FHitResult& Hit, float MaxW
 		TestWalkableZ = SlopeOverride.ModifyWalkableFloorZ(TestWalkableZ);
 	}
 
-    FVector ComponentUp = UpdatedComponent->GetUpVector();
 	// Can't walk on this surface if it is too steep.
 	//if (Hit.ImpactNormal.Z < TestWalkableZ)
     if (FVector::DotProduct(Hit.ImpactNormal, ComponentUp) < TestWalkableZ)
@@ -228,4 +232,39 @@ bool UMoonshotMoverUtils::IsWithinEdgeTolerance(const FVector& CapsuleLocation,
 	const float DistFromCenterSq = (TestImpactPoint - CapsuleLocation).SizeSquared2D();
 	const float ReducedRadiusSq = FMath::Square(FMath::Max(SWEEP_EDGE_REJECT_DISTANCE + UE_KINDA_SMALL_NUMBER, CapsuleRadius - SWEEP_EDGE_REJECT_DISTANCE));
 	return DistFromCenterSq < ReducedRadiusSq;
-}
\ No newline at end of file
+}
+
+int32 UMoonshotMoverUtils::ComputeNumSubsteps(const FVector& MoveDelta, const UPrimitiveComponent* UpdatedPrimitive, float RadiusFraction, int32 MaxSubsteps)
+{
+	if (!UpdatedPrimitive || MaxSubsteps <= 1)
+	{
+		return 1;
+	}
+
+	const FCollisionShape CollisionShape = UpdatedPrimitive->GetCollisionShape();
+	float Radius;
+	if (CollisionShape.IsCapsule())
+	{
+		Radius = CollisionShape.GetCapsuleRadius();
+	}
+	else if (CollisionShape.IsSphere())
+	{
+		Radius = CollisionShape.GetSphereRadius();
+	}
+	else if (CollisionShape.IsBox())
+	{
+		Radius = CollisionShape.GetBox().GetMin();
+	}
+	else
+	{
+		Radius = UpdatedPrimitive->Bounds.SphereRadius;
+	}
+
+	const float MaxSubstepDistance = Radius * RadiusFraction;
+	if (MaxSubstepDistance <= UE_KINDA_SMALL_NUMBER)
+	{
+		return 1;
+	}
+
+	return FMath::Clamp(FMath::CeilToInt32(MoveDelta.Size() / MaxSubstepDistance), 1, MaxSubsteps);
+}
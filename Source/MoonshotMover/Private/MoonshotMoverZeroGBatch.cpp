@@ -0,0 +1,240 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "MoonshotMoverZeroGBatch.h"
+#include "MoonshotMoverZeroGMode.h"
+#include "Math/VectorRegister.h"
+
+
+namespace MoonshotZeroGBatch
+{
+	static FORCEINLINE VectorRegister4Double Splat(double Value)
+	{
+		return MakeVectorRegisterDouble(Value, Value, Value, Value);
+	}
+
+	static FORCEINLINE VectorRegister4Double SizeSquared(const VectorRegister4Double& X, const VectorRegister4Double& Y, const VectorRegister4Double& Z)
+	{
+		// Same evaluation order as FVector::SizeSquared: (X*X + Y*Y) + Z*Z
+		return VectorAdd(VectorAdd(VectorMultiply(X, X), VectorMultiply(Y, Y)), VectorMultiply(Z, Z));
+	}
+
+	/** Lane-wise FVector::GetSafeNormal with the default tolerance */
+	static FORCEINLINE void GetSafeNormal(VectorRegister4Double& X, VectorRegister4Double& Y, VectorRegister4Double& Z)
+	{
+		const VectorRegister4Double SquareSum = SizeSquared(X, Y, Z);
+		const VectorRegister4Double Scale = VectorDivide(VectorOneDouble(), VectorSqrt(SquareSum));
+		const VectorRegister4Double bIsUnit = VectorCompareEQ(SquareSum, VectorOneDouble());
+		const VectorRegister4Double bIsTiny = VectorCompareLT(SquareSum, Splat(UE_SMALL_NUMBER));
+
+		X = VectorSelect(bIsUnit, X, VectorSelect(bIsTiny, VectorZeroDouble(), VectorMultiply(X, Scale)));
+		Y = VectorSelect(bIsUnit, Y, VectorSelect(bIsTiny, VectorZeroDouble(), VectorMultiply(Y, Scale)));
+		Z = VectorSelect(bIsUnit, Z, VectorSelect(bIsTiny, VectorZeroDouble(), VectorMultiply(Z, Scale)));
+	}
+
+	/** Lane-wise FMath::Clamp(Value, Min, Max) */
+	static FORCEINLINE VectorRegister4Double Clamp(const VectorRegister4Double& Value, const VectorRegister4Double& Min, const VectorRegister4Double& Max)
+	{
+		return VectorSelect(VectorCompareLT(Value, Min), Min, VectorSelect(VectorCompareLT(Value, Max), Value, Max));
+	}
+}
+
+void FZeroGModeBatch::SetNum(int32 InNum)
+{
+	check(InNum >= 0);
+
+	NumMovers = InNum;
+	const int32 PaddedNum = Align(InNum, LaneWidth);
+
+	auto ResetArray = [PaddedNum](auto& Array)
+	{
+		Array.SetNumZeroed(PaddedNum);
+	};
+
+	ResetArray(MoveInputX); ResetArray(MoveInputY); ResetArray(MoveInputZ);
+	ResetArray(PriorVelocityX); ResetArray(PriorVelocityY); ResetArray(PriorVelocityZ);
+	ResetArray(AngularVelocityPitch); ResetArray(AngularVelocityYaw); ResetArray(AngularVelocityRoll);
+	ResetArray(MaxSpeed);
+	ResetArray(Acceleration);
+	ResetArray(Deceleration);
+	ResetArray(TurningRate);
+	ResetArray(DeltaSeconds);
+
+	ResetArray(DirectionIntentX); ResetArray(DirectionIntentY); ResetArray(DirectionIntentZ);
+	ResetArray(bHasDirIntent);
+	ResetArray(LinearVelocityX); ResetArray(LinearVelocityY); ResetArray(LinearVelocityZ);
+	ResetArray(OutAngularVelocityPitch); ResetArray(OutAngularVelocityYaw); ResetArray(OutAngularVelocityRoll);
+
+	// Padding lanes must stay idle even if the batch shrank
+	for (int32 Lane = InNum; Lane < PaddedNum; ++Lane)
+	{
+		MoveInputX[Lane] = MoveInputY[Lane] = MoveInputZ[Lane] = 0.0;
+		PriorVelocityX[Lane] = PriorVelocityY[Lane] = PriorVelocityZ[Lane] = 0.0;
+		AngularVelocityPitch[Lane] = AngularVelocityYaw[Lane] = AngularVelocityRoll[Lane] = 0.0;
+		MaxSpeed[Lane] = Acceleration[Lane] = Deceleration[Lane] = TurningRate[Lane] = DeltaSeconds[Lane] = 0.f;
+	}
+}
+
+void FZeroGModeBatch::SetMover(int32 Index, const FZeroGModeParams& Params)
+{
+	check(Index >= 0 && Index < NumMovers);
+
+	MoveInputX[Index] = Params.MoveInput.X;
+	MoveInputY[Index] = Params.MoveInput.Y;
+	MoveInputZ[Index] = Params.MoveInput.Z;
+	PriorVelocityX[Index] = Params.PriorVelocity.X;
+	PriorVelocityY[Index] = Params.PriorVelocity.Y;
+	PriorVelocityZ[Index] = Params.PriorVelocity.Z;
+	AngularVelocityPitch[Index] = Params.AngularVelocity.Pitch;
+	AngularVelocityYaw[Index] = Params.AngularVelocity.Yaw;
+	AngularVelocityRoll[Index] = Params.AngularVelocity.Roll;
+	MaxSpeed[Index] = Params.MaxSpeed;
+	Acceleration[Index] = Params.Acceleration;
+	Deceleration[Index] = Params.Deceleration;
+	TurningRate[Index] = Params.TurningRate;
+	DeltaSeconds[Index] = Params.DeltaSeconds;
+}
+
+FProposedMove FZeroGModeBatch::GetProposedMove(int32 Index) const
+{
+	check(Index >= 0 && Index < NumMovers);
+
+	FProposedMove OutMove;
+	OutMove.DirectionIntent = FVector(DirectionIntentX[Index], DirectionIntentY[Index], DirectionIntentZ[Index]);
+	OutMove.bHasDirIntent = bHasDirIntent[Index] != 0;
+	OutMove.LinearVelocity = FVector(LinearVelocityX[Index], LinearVelocityY[Index], LinearVelocityZ[Index]);
+	OutMove.AngularVelocity = FRotator(OutAngularVelocityPitch[Index], OutAngularVelocityYaw[Index], OutAngularVelocityRoll[Index]);
+	return OutMove;
+}
+
+void UZeroGModeUtils::ComputeControlledFreeMoveBatch(FZeroGModeBatch& Batch)
+{
+	using namespace MoonshotZeroGBatch;
+	constexpr int32 LaneWidth = FZeroGModeBatch::LaneWidth;
+
+	const int32 PaddedNum = Batch.GetPaddedNum();
+	check(PaddedNum % LaneWidth == 0);
+
+	const VectorRegister4Double KindaSmall = Splat(UE_KINDA_SMALL_NUMBER);
+	const VectorRegister4Double Ten = Splat(10.0f);
+
+	for (int32 Base = 0; Base < PaddedNum; Base += LaneWidth)
+	{
+		// The scalar path mixes float settings into double math; reproduce each float intermediate per lane before widening
+		alignas(32) double MaxSpeedLane[LaneWidth];
+		alignas(32) double MaxSpeedSqFloatLane[LaneWidth];
+		alignas(32) double MaxSpeedSqLane[LaneWidth];
+		alignas(32) double AccelerationLane[LaneWidth];
+		alignas(32) double DecelScaleLane[LaneWidth];
+		alignas(32) double DeltaSecondsLane[LaneWidth];
+		alignas(32) double InvDeltaSecondsLane[LaneWidth];
+		alignas(32) double TurningRateLane[LaneWidth];
+
+		for (int32 Lane = 0; Lane < LaneWidth; ++Lane)
+		{
+			const int32 Index = Base + Lane;
+			const float LaneMaxSpeed = Batch.MaxSpeed[Index];
+			const float LaneDeltaSeconds = Batch.DeltaSeconds[Index];
+
+			MaxSpeedLane[Lane] = LaneMaxSpeed;
+			MaxSpeedSqFloatLane[Lane] = FMath::Square(LaneMaxSpeed);
+			MaxSpeedSqLane[Lane] = FMath::Square(static_cast<double>(LaneMaxSpeed));
+			AccelerationLane[Lane] = Batch.Acceleration[Index];
+			DecelScaleLane[Lane] = 1.0f - Batch.Deceleration[Index];
+			DeltaSecondsLane[Lane] = LaneDeltaSeconds;
+			InvDeltaSecondsLane[Lane] = LaneDeltaSeconds > 0.0f ? 1.0f / LaneDeltaSeconds : 0.0f;
+			TurningRateLane[Lane] = Batch.TurningRate[Index];
+		}
+
+		const VectorRegister4Double MaxSpeedV = VectorLoadAligned(MaxSpeedLane);
+		const VectorRegister4Double MaxSpeedSqFloatV = VectorLoadAligned(MaxSpeedSqFloatLane);
+		const VectorRegister4Double DeltaSecondsV = VectorLoadAligned(DeltaSecondsLane);
+
+		// Direction intent
+		VectorRegister4Double MoveX = VectorLoad(&Batch.MoveInputX[Base]);
+		VectorRegister4Double MoveY = VectorLoad(&Batch.MoveInputY[Base]);
+		VectorRegister4Double MoveZ = VectorLoad(&Batch.MoveInputZ[Base]);
+
+		VectorRegister4Double DirX = MoveX, DirY = MoveY, DirZ = MoveZ;
+		GetSafeNormal(DirX, DirY, DirZ);
+		VectorStore(DirX, &Batch.DirectionIntentX[Base]);
+		VectorStore(DirY, &Batch.DirectionIntentY[Base]);
+		VectorStore(DirZ, &Batch.DirectionIntentZ[Base]);
+
+		const VectorRegister4Double bDirNearlyZero = VectorBitwiseAnd(
+			VectorBitwiseAnd(VectorCompareLE(VectorAbs(DirX), KindaSmall), VectorCompareLE(VectorAbs(DirY), KindaSmall)),
+			VectorCompareLE(VectorAbs(DirZ), KindaSmall));
+		const int32 NearlyZeroBits = VectorMaskBits(bDirNearlyZero);
+		for (int32 Lane = 0; Lane < LaneWidth; ++Lane)
+		{
+			Batch.bHasDirIntent[Base + Lane] = (NearlyZeroBits & (1 << Lane)) ? 0 : 1;
+		}
+
+		// Linear velocity
+		const VectorRegister4Double AccelerationV = VectorLoadAligned(AccelerationLane);
+		const VectorRegister4Double AccX = VectorMultiply(AccelerationV, MoveX);
+		const VectorRegister4Double AccY = VectorMultiply(AccelerationV, MoveY);
+		const VectorRegister4Double AccZ = VectorMultiply(AccelerationV, MoveZ);
+
+		VectorRegister4Double VelX = VectorLoad(&Batch.PriorVelocityX[Base]);
+		VectorRegister4Double VelY = VectorLoad(&Batch.PriorVelocityY[Base]);
+		VectorRegister4Double VelZ = VectorLoad(&Batch.PriorVelocityZ[Base]);
+
+		const VectorRegister4Double bBelowMax = VectorCompareLT(SizeSquared(VelX, VelY, VelZ), MaxSpeedSqFloatV);
+		const VectorRegister4Double bHasAccel = VectorCompareGT(SizeSquared(AccX, AccY, AccZ), VectorZeroDouble());
+		const VectorRegister4Double bAccelerate = VectorBitwiseAnd(bHasAccel, bBelowMax);
+
+		if (VectorMaskBits(bAccelerate))
+		{
+			VectorRegister4Double NewX = VectorAdd(VelX, VectorMultiply(AccX, DeltaSecondsV));
+			VectorRegister4Double NewY = VectorAdd(VelY, VectorMultiply(AccY, DeltaSecondsV));
+			VectorRegister4Double NewZ = VectorAdd(VelZ, VectorMultiply(AccZ, DeltaSecondsV));
+
+			const VectorRegister4Double bOverMax = VectorCompareGT(SizeSquared(NewX, NewY, NewZ), MaxSpeedSqFloatV);
+			VectorRegister4Double NormX = NewX, NormY = NewY, NormZ = NewZ;
+			GetSafeNormal(NormX, NormY, NormZ);
+			NewX = VectorSelect(bOverMax, VectorMultiply(NormX, MaxSpeedV), NewX);
+			NewY = VectorSelect(bOverMax, VectorMultiply(NormY, MaxSpeedV), NewY);
+			NewZ = VectorSelect(bOverMax, VectorMultiply(NormZ, MaxSpeedV), NewZ);
+
+			VelX = VectorSelect(bAccelerate, NewX, VelX);
+			VelY = VectorSelect(bAccelerate, NewY, VelY);
+			VelZ = VectorSelect(bAccelerate, NewZ, VelZ);
+		}
+
+		// FVector::GetClampedToMaxSize
+		{
+			const VectorRegister4Double VSq = SizeSquared(VelX, VelY, VelZ);
+			const VectorRegister4Double Scale = VectorMultiply(MaxSpeedV, VectorDivide(VectorOneDouble(), VectorSqrt(VSq)));
+			const VectorRegister4Double bClamp = VectorCompareGT(VSq, VectorLoadAligned(MaxSpeedSqLane));
+			const VectorRegister4Double bZero = VectorCompareLT(MaxSpeedV, KindaSmall);
+
+			VelX = VectorSelect(bZero, VectorZeroDouble(), VectorSelect(bClamp, VectorMultiply(VelX, Scale), VelX));
+			VelY = VectorSelect(bZero, VectorZeroDouble(), VectorSelect(bClamp, VectorMultiply(VelY, Scale), VelY));
+			VelZ = VectorSelect(bZero, VectorZeroDouble(), VectorSelect(bClamp, VectorMultiply(VelZ, Scale), VelZ));
+		}
+
+		const VectorRegister4Double DecelScaleV = VectorLoadAligned(DecelScaleLane);
+		VectorStore(VectorMultiply(DecelScaleV, VelX), &Batch.LinearVelocityX[Base]);
+		VectorStore(VectorMultiply(DecelScaleV, VelY), &Batch.LinearVelocityY[Base]);
+		VectorStore(VectorMultiply(DecelScaleV, VelZ), &Batch.LinearVelocityZ[Base]);
+
+		// Angular velocity
+		const VectorRegister4Double InvDeltaSecondsV = VectorLoadAligned(InvDeltaSecondsLane);
+		const VectorRegister4Double TurningRateV = VectorLoadAligned(TurningRateLane);
+		const VectorRegister4Double bHasDeltaTime = VectorCompareGT(DeltaSecondsV, VectorZeroDouble());
+		const VectorRegister4Double bClampTurning = VectorCompareGE(TurningRateV, VectorZeroDouble());
+		const VectorRegister4Double MinTurningRateV = VectorNegate(TurningRateV);
+
+		VectorRegister4Double Pitch = VectorMultiply(VectorLoad(&Batch.AngularVelocityPitch[Base]), InvDeltaSecondsV);
+		VectorRegister4Double Yaw = VectorMultiply(VectorLoad(&Batch.AngularVelocityYaw[Base]), InvDeltaSecondsV);
+		VectorRegister4Double Roll = VectorMultiply(VectorLoad(&Batch.AngularVelocityRoll[Base]), InvDeltaSecondsV);
+
+		Pitch = VectorSelect(bClampTurning, VectorMultiply(Ten, Clamp(Pitch, MinTurningRateV, TurningRateV)), Pitch);
+		Yaw = VectorSelect(bClampTurning, VectorMultiply(Ten, Clamp(Yaw, MinTurningRateV, TurningRateV)), Yaw);
+		Roll = VectorSelect(bClampTurning, Clamp(Roll, MinTurningRateV, TurningRateV), Roll);
+
+		VectorStore(VectorSelect(bHasDeltaTime, Pitch, VectorZeroDouble()), &Batch.OutAngularVelocityPitch[Base]);
+		VectorStore(VectorSelect(bHasDeltaTime, Yaw, VectorZeroDouble()), &Batch.OutAngularVelocityYaw[Base]);
+		VectorStore(VectorSelect(bHasDeltaTime, Roll, VectorZeroDouble()), &Batch.OutAngularVelocityRoll[Base]);
+	}
+}
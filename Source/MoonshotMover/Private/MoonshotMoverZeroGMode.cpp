@@ -2,6 +2,14 @@
 
 #include "MoonshotMoverZeroGMode.h"
 #include "MoonshotMoverDataModelTypes.h"
+#include "MoonshotMoverDeterministicMath.h"
+#include "MoonshotMoverInputBaselines.h"
+#include "MoonshotMoverInputLatency.h"
+#include "MoonshotMoverModeRegistry.h"
+#include "MoonshotMoverProxySimulation.h"
+#include "MoonshotMoverSimTelemetry.h"
+#include "MoonshotMoverUtils.h"
+#include "MoonshotMoverFallAlongSurface.h"
 #include "Kismet/BlueprintFunctionLibrary.h"
 #include "Mover/Public/MoverComponent.h"
 #include "Mover/Public/MoveLibrary/FloorQueryUtils.h"
@@ -18,10 +26,23 @@ UMoonshotMoverZeroGMode::UMoonshotMoverZeroGMode(const FObjectInitializer& Objec
 void UMoonshotMoverZeroGMode::OnGenerateMove(const FMoverTickStartData& StartState, const FMoverTimeStep& TimeStep, FProposedMove& OutProposedMove) const
 {
 	//const FCharacterDefaultInputs* CharacterInputs = StartState.InputCmd.InputCollection.FindDataByType<FCharacterDefaultInputs>();
-    const FMoonshotMoverCharacterInputs* CharacterInputs = StartState.InputCmd.InputCollection.FindDataByType<FMoonshotMoverCharacterInputs>();
+    FMoonshotMoverCharacterInputs RepairedInputs;
+    const FMoonshotMoverCharacterInputs* CharacterInputs = FMoonshotMoverInputRepair::Resolve(GetMoverComponent(), GetBlackboard_Mutable(), TimeStep,
+    	StartState.InputCmd.InputCollection.FindDataByType<FMoonshotMoverCharacterInputs>(), RepairedInputs);
+    if (CharacterInputs)
+    {
+    	FMoonshotMoverInputLatency::MarkGenerateMove(GetMoverComponent(), TimeStep, CharacterInputs->LatencyStamp);
+    }
 	const FMoverDefaultSyncState* StartingSyncState = StartState.SyncState.SyncStateCollection.FindDataByType<FMoverDefaultSyncState>();
 	check(StartingSyncState);
 
+	// Distant, unseen proxies skip move generation as well as the collision in OnSimulationTick
+	if (FMoonshotMoverProxySimulation::ShouldExtrapolate(GetMoverComponent(), Cast<UPrimitiveComponent>(GetMoverComponent()->GetUpdatedComponent()), *StartingSyncState, *CommonMovementSettings))
+	{
+		FMoonshotMoverProxySimulation::GenerateMove(*StartingSyncState, CharacterInputs ? CharacterInputs->AngularVelocity.GetNormalized() : FRotator::ZeroRotator, OutProposedMove);
+		return;
+	}
+
 	const float DeltaSeconds = TimeStep.StepMs * 0.001f;
 
 	FZeroGModeParams Params;
@@ -91,11 +112,14 @@ void UMoonshotMoverZeroGMode::OnSimulationTick(const FSimulationTickParams& Para
 	FProposedMove ProposedMove = Params.ProposedMove;
 
 	//const FCharacterDefaultInputs* CharacterInputs = StartState.InputCmd.InputCollection.FindDataByType<FCharacterDefaultInputs>();
-    const FMoonshotMoverCharacterInputs* CharacterInputs = StartState.InputCmd.InputCollection.FindDataByType<FMoonshotMoverCharacterInputs>();
+    FMoonshotMoverCharacterInputs RepairedInputs;
+    const FMoonshotMoverCharacterInputs* CharacterInputs = FMoonshotMoverInputRepair::Resolve(GetMoverComponent(), GetBlackboard_Mutable(), Params.TimeStep,
+    	StartState.InputCmd.InputCollection.FindDataByType<FMoonshotMoverCharacterInputs>(), RepairedInputs);
 	const FMoverDefaultSyncState* StartingSyncState = StartState.SyncState.SyncStateCollection.FindDataByType<FMoverDefaultSyncState>();
 	check(StartingSyncState);
 
 	FMoverDefaultSyncState& OutputSyncState = OutputState.SyncState.SyncStateCollection.FindOrAddMutableDataByType<FMoverDefaultSyncState>();
+	const FMoonshotMoverSimTickScope TickScope(GetMoverComponent(), Params.TimeStep, *StartingSyncState, OutputSyncState, CommonMovementSettings->ResimBudgetMs);
 
 	const float DeltaSeconds = Params.TimeStep.StepMs * 0.001f;
 
@@ -106,6 +130,13 @@ void UMoonshotMoverZeroGMode::OnSimulationTick(const FSimulationTickParams& Para
 		return;
 	}
 
+	// Distant, unseen proxies only need to look plausible until the next server update
+	if (FMoonshotMoverProxySimulation::ShouldExtrapolate(GetMoverComponent(), UpdatedPrimitive, *StartingSyncState, *CommonMovementSettings))
+	{
+		FMoonshotMoverProxySimulation::Extrapolate(UpdatedComponent, *StartingSyncState, ProposedMove, DeltaSeconds, *CommonMovementSettings, GetBlackboard_Mutable(), OutputSyncState);
+		return;
+	}
+
 	FMovementRecord MoveRecord;
 	MoveRecord.SetDeltaSeconds(DeltaSeconds);
 
@@ -113,6 +144,7 @@ void UMoonshotMoverZeroGMode::OnSimulationTick(const FSimulationTickParams& Para
 
 	SimBlackboard->Invalidate(CommonBlackboard::LastFloorResult);	// flying = no valid floor
 	SimBlackboard->Invalidate(CommonBlackboard::LastFoundDynamicMovementBase);
+	SimBlackboard->Invalidate(MoonshotBlackboard::PredictedContact);
 
 	OutputSyncState.MoveDirectionIntent = (ProposedMove.bHasDirIntent ? ProposedMove.DirectionIntent : FVector::ZeroVector);
 
@@ -124,35 +156,53 @@ void UMoonshotMoverZeroGMode::OnSimulationTick(const FSimulationTickParams& Para
 
     //FQuat AngularQuat = FQuat::MakeFromEuler((ProposedMove.AngularVelocity * DeltaSeconds).Euler());
 
+	const FMoonshotMoverMath Math(CommonMovementSettings->bUseDeterministicMath);
+
 	// Apply orientation changes (if any)
-	FQuat OrientQuat = StartingOrient.Quaternion();
+	const FQuat StartQuat = Math.RotatorToQuat(StartingOrient);
+	FQuat OrientQuat = StartQuat;
 	if (!ProposedMove.AngularVelocity.IsZero())
 	{
-		FQuat AngularQuat = (ProposedMove.AngularVelocity * DeltaSeconds).Quaternion();
-		OrientQuat = OrientQuat * AngularQuat;
+		FQuat AngularQuat = Math.RotatorToQuat(ProposedMove.AngularVelocity * DeltaSeconds);
+		OrientQuat = Math.Multiply(OrientQuat, AngularQuat);
 	}
 	
 	FVector MoveDelta = ProposedMove.LinearVelocity * DeltaSeconds;
 	//FQuat OrientQuat = TargetOrient.Quaternion() * AngularQuat;
-    OrientQuat.Normalize();
+    OrientQuat = Math.GetNormalized(OrientQuat);
 
 	FHitResult Hit(1.f);
 
 	if (!MoveDelta.IsNearlyZero() || !ProposedMove.AngularVelocity.IsNearlyZero())
 	{
-		UMovementUtils::TrySafeMoveUpdatedComponent(UpdatedComponent, UpdatedPrimitive, MoveDelta, OrientQuat, true, Hit, ETeleportType::None, MoveRecord);
-	}
+		// Fast moves are split so each sweep covers at most a fraction of our collider; slow moves stay a single sweep
+		const int32 NumSubsteps = CommonMovementSettings->bEnableAdaptiveSubstepping && !TickScope.IsReducedCost()
+			? UMoonshotMoverUtils::ComputeNumSubsteps(MoveDelta, UpdatedPrimitive, CommonMovementSettings->SubstepDistanceRadiusFraction, CommonMovementSettings->MaxSubsteps)
+			: 1;
+		const FVector SubstepDelta = MoveDelta / NumSubsteps;
 
-	if (Hit.IsValidBlockingHit())
-	{
-		UMoverComponent* MoverComponent = GetMoverComponent();
-		FMoverOnImpactParams ImpactParams(DefaultModeNames::Flying, Hit, MoveDelta);
-		MoverComponent->HandleImpact(ImpactParams);
-		// Try to slide the remaining distance along the surface.
-		UMovementUtils::TryMoveToSlideAlongSurface(UpdatedComponent, UpdatedPrimitive, MoverComponent, MoveDelta, 1.f - Hit.Time, OrientQuat, Hit.Normal, Hit, true, MoveRecord);
+		for (int32 Substep = 0; Substep < NumSubsteps; ++Substep)
+		{
+			const bool bIsLastSubstep = (Substep == NumSubsteps - 1);
+			const FQuat SubstepQuat = bIsLastSubstep ? OrientQuat : Math.Slerp(StartQuat, OrientQuat, float(Substep + 1) / NumSubsteps);
+
+			UMovementUtils::TrySafeMoveUpdatedComponent(UpdatedComponent, UpdatedPrimitive, SubstepDelta, SubstepQuat, true, Hit, ETeleportType::None, MoveRecord);
+
+			if (Hit.IsValidBlockingHit())
+			{
+				UMoverComponent* MoverComponent = GetMoverComponent();
+				FMoverOnImpactParams ImpactParams(DefaultModeNames::Flying, Hit, MoveDelta);
+				MoverComponent->HandleImpact(ImpactParams);
+				// Try to slide the remaining distance of the whole tick along the surface.
+				const float PctOfDeltaRemaining = (float(NumSubsteps - Substep) - Hit.Time) / NumSubsteps;
+				UMovementUtils::TryMoveToSlideAlongSurface(UpdatedComponent, UpdatedPrimitive, MoverComponent, MoveDelta, PctOfDeltaRemaining, OrientQuat, Hit.Normal, Hit, true, MoveRecord);
+				break;
+			}
+		}
 	}
 
 	CaptureFinalState(UpdatedComponent, MoveRecord, *StartingSyncState, OutputSyncState, DeltaSeconds);
+	FMoonshotDeterministicMath::LogSyncStateChecksum(GetMoverComponent(), Params.TimeStep, OutputSyncState);
 }
 
 
@@ -170,6 +220,7 @@ bool UMoonshotMoverZeroGMode::AttemptTeleport(USceneComponent* UpdatedComponent,
 		UpdatedComponent->ComponentVelocity = StartingSyncState.GetVelocity_WorldSpace();
 
 		GetBlackboard_Mutable()->Invalidate(CommonBlackboard::LastFloorResult);
+		GetBlackboard_Mutable()->Invalidate(MoonshotBlackboard::FloorHandoff);
 
 		return true;
 	}
@@ -198,6 +249,9 @@ void UMoonshotMoverZeroGMode::OnRegistered(const FName ModeName)
 {
 	Super::OnRegistered(ModeName);
 
+	// Resolve our handle now so mode checks elsewhere never touch the name table
+	FMoonshotMoverModeRegistry::Get().Register(ModeName);
+
 	CommonMovementSettings = GetMoverComponent()->FindSharedSettings<UMoonshotMoverCommonMovementSettings>();
 	ensureMsgf(CommonMovementSettings, TEXT("Failed to find instance of MoonshotMoverCommonMovementSettings on %s. Movement may not function properly."), *GetPathNameSafe(this));
 }
@@ -266,98 +320,10 @@ FProposedMove UZeroGModeUtils::ComputeControlledFreeMove(const FZeroGModeParams&
 
 bool UZeroGModeUtils::IsValidLandingSpot(USceneComponent* UpdatedComponent, UPrimitiveComponent* UpdatedPrimitive, const FVector& Location, const FHitResult& Hit, float FloorSweepDistance, float WalkableFloorZ, FFloorCheckResult& OutFloorResult)
 {
-	OutFloorResult.Clear();
-
-	if (!Hit.bBlockingHit)
-	{
-		return false;
-	}
-
-	if (Hit.bStartPenetrating)
-	{
-		return false;
-	}
-
-	// Reject unwalkable floor normals.
-	if (!UFloorQueryUtils::IsHitSurfaceWalkable(Hit, WalkableFloorZ))
-	{
-		return false;
-	}
-
-	// Make sure floor test passes here.
-	UFloorQueryUtils::FindFloor(UpdatedComponent, UpdatedPrimitive, 
-		FloorSweepDistance, WalkableFloorZ,
-		Location, OutFloorResult);
-
-	if (!OutFloorResult.IsWalkableFloor())
-	{
-		return false;
-	}
-
-	return true;
+	return FZeroGFallAlongSurface::IsValidLandingSpot(UpdatedComponent, UpdatedPrimitive, Location, Hit, FloorSweepDistance, WalkableFloorZ, OutFloorResult);
 }
 
 float UZeroGModeUtils::TryMoveToFallAlongSurface(USceneComponent* UpdatedComponent, UPrimitiveComponent* UpdatedPrimitive, UMoverComponent* MoverComponent, const FVector& Delta, float PctOfDeltaToMove, const FQuat Rotation, const FVector& Normal, FHitResult& Hit, bool bHandleImpact, float FloorSweepDistance, float MaxWalkSlopeCosine, FFloorCheckResult& OutFloorResult, FMovementRecord& MoveRecord)
 {
-	OutFloorResult.Clear();
-
-	if (!Hit.bBlockingHit)
-	{
-		return 0.f;
-	}
-
-	float PctOfTimeUsed = 0.f;
-	const FVector OldHitNormal = Normal;
-
-	FVector SlideDelta = UMovementUtils::ComputeSlideDelta(Delta, PctOfDeltaToMove, Normal, Hit);
-
-	if ((SlideDelta | Delta) > 0.f)
-	{
-		// First sliding attempt along surface
-		UMovementUtils::TrySafeMoveUpdatedComponent(UpdatedComponent, UpdatedPrimitive, SlideDelta, Rotation, true, Hit, ETeleportType::None, MoveRecord);
-
-		PctOfTimeUsed = Hit.Time;
-		if (Hit.IsValidBlockingHit())
-		{
-			// Notify first impact
-			if (MoverComponent && bHandleImpact)
-			{
-				FMoverOnImpactParams ImpactParams(NAME_None, Hit, SlideDelta);
-				MoverComponent->HandleImpact(ImpactParams);
-			}
-
-			// Check if we landed
-			if (!IsValidLandingSpot(UpdatedComponent, UpdatedPrimitive, UpdatedPrimitive->GetComponentLocation(),
-				Hit, FloorSweepDistance, MaxWalkSlopeCosine, OutFloorResult))
-			{
-				// We've hit another surface during our first move, so let's try to slide along both of them together
-
-				// Compute new slide normal when hitting multiple surfaces.
-				SlideDelta = UMovementUtils::ComputeTwoWallAdjustedDelta(SlideDelta, Hit, OldHitNormal);
-
-				// Only proceed if the new direction is of significant length and not in reverse of original attempted move.
-				if (!SlideDelta.IsNearlyZero(SMALL_MOVE_DISTANCE) && (SlideDelta | Delta) > 0.f)
-				{
-					// Perform second move, taking 2 walls into account
-					UMovementUtils::TrySafeMoveUpdatedComponent(UpdatedComponent, UpdatedPrimitive, SlideDelta, Rotation, true, Hit, ETeleportType::None, MoveRecord);
-					PctOfTimeUsed += (Hit.Time * (1.f - PctOfTimeUsed));
-
-					// Notify second impact
-					if (MoverComponent && bHandleImpact && Hit.bBlockingHit)
-					{
-						FMoverOnImpactParams ImpactParams(NAME_None, Hit, SlideDelta);
-						MoverComponent->HandleImpact(ImpactParams);
-					}
-
-					// Check if we've landed, to acquire floor result
-					IsValidLandingSpot(UpdatedComponent, UpdatedPrimitive, UpdatedPrimitive->GetComponentLocation(),
-						Hit, FloorSweepDistance, MaxWalkSlopeCosine, OutFloorResult);
-				}
-			}
-		}
-
-		return FMath::Clamp(PctOfTimeUsed, 0.f, 1.f);
-	}
-
-	return 0.f;
+	return FZeroGFallAlongSurface::TryMoveToFallAlongSurface(UpdatedComponent, UpdatedPrimitive, MoverComponent, Delta, PctOfDeltaToMove, Rotation, Normal, Hit, bHandleImpact, FloorSweepDistance, MaxWalkSlopeCosine, OutFloorResult, MoveRecord);
 }
\ No newline at end of file
@@ -0,0 +1,489 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "MoonshotMoverDataModelTypes.h"
+#include "MoonshotMoverInputBaselines.h"
+#include "MoonshotMoverModeRegistry.h"
+#include "MoonshotMoverNetQuantize.h"
+#include "MoonshotMoverTestHelpers.h"
+#include "UObject/CoreNet.h"
+#include "UObject/Package.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMoonshotMoverInputChangeMaskTest, "Moonshot.Mover.InputStream.ChangeMask",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMoonshotMoverInputDeltaTest, "Moonshot.Mover.InputStream.DeltaAgainstAck",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMoonshotMoverInputMissingBaselineTest, "Moonshot.Mover.InputStream.MissingBaseline",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMoonshotMoverInputSequenceWrapTest, "Moonshot.Mover.InputStream.SequenceWrap",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMoonshotMoverInputLostAckTest, "Moonshot.Mover.InputStream.LostAck",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMoonshotMoverInputRedundancyTest, "Moonshot.Mover.InputStream.RedundantWindow",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMoonshotMoverInputUnackedStreamTest, "Moonshot.Mover.InputStream.NoWindowWithoutAck",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+namespace MoonshotMoverInputStreamTest
+{
+	using MoonshotMoverTest::FScopedCVar;
+
+	// Compact flag, header with a baseline, an empty change mask, jump flags and movement base flag
+	constexpr int64 UnchangedDeltaBits = 1 + (8 + 3 + 1 + 8) + 6 + 2 + 1;
+
+	// The compact header, read back from the front of a written input
+	struct FHeader
+	{
+		uint32 Sequence = 0;
+		uint32 NumRedundant = 0;
+		bool bHasBaseline = false;
+		uint32 BaselineSequence = 0;
+	};
+
+	struct FResult
+	{
+		FHeader Header;
+		int64 Bits = 0;
+		bool bDecoded = false;
+	};
+
+	// A command that changes some field every frame, and sometimes several
+	FMoonshotMoverCharacterInputs MakeInput(int32 Frame)
+	{
+		FMoonshotMoverCharacterInputs Input;
+		Input.InputSequence = static_cast<uint8>(Frame);
+		Input.ControlRotation = FRotator(0.0, static_cast<double>(Frame % 360), 0.0);
+		if (Frame % 5 == 0)
+		{
+			Input.SetMoveInput(EMoveInputType::DirectionalIntent, FVector(1.0, 0.0, 0.0));
+		}
+		if (Frame % 7 == 0)
+		{
+			Input.bIsJumpPressed = true;
+			Input.SuggestedMovementMode = MoonshotModeNames::ZeroG;
+		}
+		return Input;
+	}
+
+	// What the receiver should decode: the same command as a keyframe, without any history
+	FMoonshotMoverCharacterInputs DecodeAsKeyframe(const FMoonshotMoverCharacterInputs& Input)
+	{
+		FMoonshotMoverCharacterInputs Sent = Input;
+		FNetBitWriter Writer(nullptr, 0);
+		bool bSuccess = true;
+		Sent.NetSerialize(Writer, nullptr, bSuccess);
+
+		FNetBitReader Reader(nullptr, Writer.GetData(), Writer.GetNumBits());
+		FMoonshotMoverCharacterInputs Decoded;
+		Decoded.NetSerialize(Reader, nullptr, bSuccess);
+		return Decoded;
+	}
+
+	bool IsSameCommand(const FMoonshotMoverCharacterInputs& A, const FMoonshotMoverCharacterInputs& B)
+	{
+		return A.InputSequence == B.InputSequence
+			&& A.GravityAcceleration == B.GravityAcceleration
+			&& A.GetMoveInputType() == B.GetMoveInputType()
+			&& A.GetMoveInput() == B.GetMoveInput()
+			&& A.OrientationIntent == B.OrientationIntent
+			&& A.ControlRotation == B.ControlRotation
+			&& A.AngularVelocity == B.AngularVelocity
+			&& A.SuggestedMovementMode == B.SuggestedMovementMode
+			&& A.bIsJumpPressed == B.bIsJumpPressed
+			&& A.bIsJumpJustPressed == B.bIsJumpJustPressed
+			&& A.bUsingMovementBase == B.bUsingMovementBase;
+	}
+
+	// One client-to-server input stream. The client's package map keys the sent history, the server's the received one.
+	struct FLink
+	{
+		UPackageMap* ClientMap = NewObject<UPackageMap>(GetTransientPackage());
+		UPackageMap* ServerMap = NewObject<UPackageMap>(GetTransientPackage());
+
+		// Serializes Input on the client and, unless the packet is lost, decodes it on the server into OutReceived
+		FResult Send(const FMoonshotMoverCharacterInputs& Input, FMoonshotMoverCharacterInputs& OutReceived, bool bDeliver = true)
+		{
+			FResult Result;
+
+			FMoonshotMoverCharacterInputs Sent = Input;
+			FNetBitWriter Writer(ClientMap, 0);
+			bool bSuccess = true;
+			Sent.NetSerialize(Writer, ClientMap, bSuccess);
+			Result.Bits = Writer.GetNumBits();
+
+			FNetBitReader HeaderReader(nullptr, Writer.GetData(), Writer.GetNumBits());
+			bool bCompact = false;
+			HeaderReader.SerializeBits(&bCompact, 1);
+			HeaderReader.SerializeBits(&Result.Header.Sequence, FMoonshotMoverInputBaselines::SequenceBits);
+			HeaderReader.SerializeBits(&Result.Header.NumRedundant, 3);
+			HeaderReader.SerializeBits(&Result.Header.bHasBaseline, 1);
+			if (Result.Header.bHasBaseline)
+			{
+				HeaderReader.SerializeBits(&Result.Header.BaselineSequence, FMoonshotMoverInputBaselines::SequenceBits);
+			}
+
+			if (bDeliver)
+			{
+				FNetBitReader Reader(ServerMap, Writer.GetData(), Writer.GetNumBits());
+				OutReceived = FMoonshotMoverCharacterInputs();
+				OutReceived.NetSerialize(Reader, ServerMap, bSuccess);
+				Result.bDecoded = bSuccess && !Reader.IsError() && Reader.AtEnd();
+			}
+			return Result;
+		}
+
+		// The server acks its newest decoded command, as AMoonshotBasePlayerController does. Returns the acked sequence, if any.
+		TOptional<uint8> Ack(bool bDeliver = true)
+		{
+			uint8 Sequence = 0;
+			if (!FMoonshotMoverInputBaselines::ConsumeSequenceToAcknowledge(ServerMap, Sequence))
+			{
+				return {};
+			}
+
+			if (bDeliver)
+			{
+				FMoonshotMoverInputBaselines::Acknowledge(ClientMap, Sequence);
+			}
+			return Sequence;
+		}
+	};
+}
+
+bool FMoonshotMoverInputChangeMaskTest::RunTest(const FString& Parameters)
+{
+	using namespace MoonshotMoverInputStreamTest;
+
+	const FScopedCVar CompactInputs(TEXT("moonshot.Mover.CompactInputs"), true);
+	const FScopedCVar DeltaInputs(TEXT("moonshot.Mover.DeltaInputs"), true);
+	const FScopedCVar SendInputGravity(TEXT("moonshot.Mover.SendInputGravity"), true);
+	const FScopedCVar Redundancy(TEXT("moonshot.Mover.InputRedundancy"), TEXT("0"));
+
+	FLink Link;
+	FMoonshotMoverCharacterInputs Input = MakeInput(1);
+	Input.GravityAcceleration = FVector(0.0, 0.0, -FMoonshotMoverNetQuantize::StandardGravityMagnitude);
+	FMoonshotMoverCharacterInputs Received;
+	Link.Send(Input, Received);
+	Link.Ack();
+
+	// Each step changes one field (gravity also resends the control rotation, which is encoded relative to it)
+	struct FStep
+	{
+		const TCHAR* Name;
+		TFunction<void(FMoonshotMoverCharacterInputs&)> Change;
+		int64 ExtraBits;
+	};
+	const FStep Steps[] = {
+		{ TEXT("Nothing"), [](FMoonshotMoverCharacterInputs&) {}, 0 },
+		{ TEXT("AngularVelocity"), [](FMoonshotMoverCharacterInputs& In) { In.AngularVelocity = FRotator(0.0, 45.0, 0.0); }, 1 + 1 + 17 + 1 },
+		{ TEXT("OrientationIntent"), [](FMoonshotMoverCharacterInputs& In) { In.OrientationIntent = FVector::ForwardVector; }, 1 + 1 + 24 },
+		{ TEXT("SuggestedMode"), [](FMoonshotMoverCharacterInputs& In) { In.SuggestedMovementMode = MoonshotModeNames::ZeroG; }, INDEX_NONE },
+		{ TEXT("MoveInput"), [](FMoonshotMoverCharacterInputs& In) { In.SetMoveInput(EMoveInputType::DirectionalIntent, FVector(0.0, 1.0, 0.0)); }, INDEX_NONE },
+		{ TEXT("ControlRotation"), [](FMoonshotMoverCharacterInputs& In) { In.ControlRotation.Yaw += 10.0; }, 16 + 16 + 1 },
+		{ TEXT("Gravity"), [](FMoonshotMoverCharacterInputs& In) { In.GravityAcceleration = FVector(0.0, -FMoonshotMoverNetQuantize::StandardGravityMagnitude, 0.0); }, INDEX_NONE },
+	};
+
+	for (const FStep& Step : Steps)
+	{
+		Step.Change(Input);
+		++Input.InputSequence;
+
+		const FResult Result = Link.Send(Input, Received);
+		Link.Ack();
+
+		const FString What = FString::Printf(TEXT("Changing %s"), Step.Name);
+		TestTrue(*(What + TEXT(" decodes")), Result.bDecoded);
+		TestTrue(*(What + TEXT(" is a delta")), Result.Header.bHasBaseline);
+		TestTrue(*(What + TEXT(" decodes like a keyframe")), IsSameCommand(Received, DecodeAsKeyframe(Input)));
+		if (Step.ExtraBits != INDEX_NONE)
+		{
+			TestEqual(*(What + TEXT(" bits")), Result.Bits, UnchangedDeltaBits + Step.ExtraBits);
+		}
+		else
+		{
+			TestTrue(*(What + TEXT(" sends more than an unchanged command")), Result.Bits > UnchangedDeltaBits);
+		}
+	}
+
+	return true;
+}
+
+bool FMoonshotMoverInputDeltaTest::RunTest(const FString& Parameters)
+{
+	using namespace MoonshotMoverInputStreamTest;
+
+	const FScopedCVar CompactInputs(TEXT("moonshot.Mover.CompactInputs"), true);
+	const FScopedCVar DeltaInputs(TEXT("moonshot.Mover.DeltaInputs"), true);
+	const FScopedCVar Redundancy(TEXT("moonshot.Mover.InputRedundancy"), TEXT("0"));
+
+	FLink Link;
+	FMoonshotMoverCharacterInputs Received;
+
+	// Nothing acked yet: a keyframe
+	FResult Result = Link.Send(MakeInput(10), Received);
+	TestTrue(TEXT("First input decodes"), Result.bDecoded);
+	TestFalse(TEXT("First input is a keyframe"), Result.Header.bHasBaseline);
+	TestTrue(TEXT("First input decodes like a keyframe"), IsSameCommand(Received, DecodeAsKeyframe(MakeInput(10))));
+
+	// Acked commands become the baseline, also when the ack trails a few commands behind
+	TestEqual(TEXT("Server acks input 10"), Link.Ack().Get(0), static_cast<uint8>(10));
+	for (int32 Frame = 11; Frame < 20; ++Frame)
+	{
+		Result = Link.Send(MakeInput(Frame), Received);
+		const FString What = FString::Printf(TEXT("Input %d"), Frame);
+		TestTrue(*(What + TEXT(" decodes")), Result.bDecoded);
+		TestTrue(*(What + TEXT(" is a delta")), Result.Header.bHasBaseline);
+		TestTrue(*(What + TEXT(" decodes like a keyframe")), IsSameCommand(Received, DecodeAsKeyframe(MakeInput(Frame))));
+
+		const uint32 ExpectedBaseline = (Frame < 15) ? 10 : 14;
+		TestEqual(*(What + TEXT(" baseline")), Result.Header.BaselineSequence, ExpectedBaseline);
+		if (Frame == 14)
+		{
+			Link.Ack();
+		}
+	}
+
+	// An ack older than the current baseline, arriving out of order, does not move it back
+	FMoonshotMoverInputBaselines::Acknowledge(Link.ClientMap, 12);
+	Result = Link.Send(MakeInput(20), Received);
+	TestEqual(TEXT("Out of order ack is ignored"), Result.Header.BaselineSequence, static_cast<uint32>(14));
+
+	// With delta inputs off, acks are still tracked but every input is a keyframe
+	{
+		const FScopedCVar NoDelta(TEXT("moonshot.Mover.DeltaInputs"), false);
+		Result = Link.Send(MakeInput(21), Received);
+		TestTrue(TEXT("Keyframe with delta inputs off decodes"), Result.bDecoded && IsSameCommand(Received, DecodeAsKeyframe(MakeInput(21))));
+		TestFalse(TEXT("Delta inputs off sends a keyframe"), Result.Header.bHasBaseline);
+	}
+
+	return true;
+}
+
+bool FMoonshotMoverInputMissingBaselineTest::RunTest(const FString& Parameters)
+{
+	using namespace MoonshotMoverInputStreamTest;
+
+	const FScopedCVar CompactInputs(TEXT("moonshot.Mover.CompactInputs"), true);
+	const FScopedCVar DeltaInputs(TEXT("moonshot.Mover.DeltaInputs"), true);
+	const FScopedCVar Redundancy(TEXT("moonshot.Mover.InputRedundancy"), TEXT("0"));
+
+	FLink Link;
+	FMoonshotMoverCharacterInputs Received;
+	Link.Send(MakeInput(1), Received);
+	Link.Ack();
+
+	// The server side loses the connection's history, e.g. after the receiving state was dropped
+	Link.ServerMap = NewObject<UPackageMap>(GetTransientPackage());
+
+	// Nothing is held at all: the delta still has to be read to the end, with unchanged fields zeroed
+	AddExpectedError(TEXT("no earlier input is held"), EAutomationExpectedErrorFlags::Contains, 1);
+	const FMoonshotMoverCharacterInputs Delta = MakeInput(2);
+	FResult Result = Link.Send(Delta, Received);
+	TestTrue(TEXT("Delta against a missing baseline is read to the end"), Result.Header.bHasBaseline && Result.bDecoded);
+	TestTrue(TEXT("Changed field still decodes"), Received.ControlRotation.Equals(DecodeAsKeyframe(Delta).ControlRotation, 0.f));
+	TestFalse(TEXT("Delta against a missing baseline is not recorded"), FMoonshotMoverInputBaselines::FindReceivedBaseline(Link.ServerMap, 2, Received));
+
+	// Some other command is held: unchanged fields come from it instead
+	FLink Other;
+	Other.ServerMap = Link.ServerMap;
+	FMoonshotMoverCharacterInputs Held = MakeInput(35);
+	Held.OrientationIntent = FVector::RightVector;
+	Other.Send(Held, Received);
+
+	AddExpectedError(TEXT("Unchanged fields are taken from input 35"), EAutomationExpectedErrorFlags::Contains, 1);
+	Result = Link.Send(MakeInput(3), Received);
+	TestTrue(TEXT("Delta against the newest held input is read to the end"), Result.Header.bHasBaseline && Result.bDecoded);
+	TestEqual(TEXT("Unchanged field comes from the newest held input"), Received.OrientationIntent, DecodeAsKeyframe(Held).OrientationIntent);
+	TestFalse(TEXT("Fallback decode is not recorded"), FMoonshotMoverInputBaselines::FindReceivedBaseline(Link.ServerMap, 3, Received));
+
+	return true;
+}
+
+bool FMoonshotMoverInputSequenceWrapTest::RunTest(const FString& Parameters)
+{
+	using namespace MoonshotMoverInputStreamTest;
+
+	const FScopedCVar CompactInputs(TEXT("moonshot.Mover.CompactInputs"), true);
+	const FScopedCVar DeltaInputs(TEXT("moonshot.Mover.DeltaInputs"), true);
+	const FScopedCVar Redundancy(TEXT("moonshot.Mover.InputRedundancy"), TEXT("0"));
+
+	// Three wraps of the 8-bit sequence, acking every third input so the baseline keeps straddling the wrap
+	FLink Link;
+	FMoonshotMoverCharacterInputs Received;
+	int32 NumDeltas = 0;
+	for (int32 Frame = 200; Frame < 200 + 3 * 256; ++Frame)
+	{
+		const FResult Result = Link.Send(MakeInput(Frame), Received);
+		if (!Result.bDecoded || !IsSameCommand(Received, DecodeAsKeyframe(MakeInput(Frame))))
+		{
+			AddError(FString::Printf(TEXT("Input %d (sequence %u) did not decode"), Frame, Result.Header.Sequence));
+			break;
+		}
+
+		if (Result.Header.bHasBaseline)
+		{
+			++NumDeltas;
+			TestTrue(*FString::Printf(TEXT("Input %d baseline is recent"), Frame), FMoonshotMoverInputBaselines::SequenceDelta(static_cast<uint8>(Frame), static_cast<uint8>(Result.Header.BaselineSequence)) <= 3);
+		}
+
+		if (Frame % 3 == 0)
+		{
+			Link.Ack();
+		}
+	}
+
+	TestTrue(TEXT("Everything after the first ack is a delta"), NumDeltas >= 3 * 256 - 3);
+	return true;
+}
+
+bool FMoonshotMoverInputLostAckTest::RunTest(const FString& Parameters)
+{
+	using namespace MoonshotMoverInputStreamTest;
+
+	const FScopedCVar CompactInputs(TEXT("moonshot.Mover.CompactInputs"), true);
+	const FScopedCVar DeltaInputs(TEXT("moonshot.Mover.DeltaInputs"), true);
+	const FScopedCVar Redundancy(TEXT("moonshot.Mover.InputRedundancy"), TEXT("0"));
+
+	FLink Link;
+	FMoonshotMoverCharacterInputs Received;
+	Link.Send(MakeInput(0), Received);
+	Link.Ack();
+
+	// Every ack is lost for a full wrap, so the acked command's sequence comes around again
+	int32 Frame = 1;
+	for (; Frame <= 256; ++Frame)
+	{
+		const FResult Result = Link.Send(MakeInput(Frame), Received);
+		Link.Ack(false);
+
+		const bool bBaselineStillHeld = Frame <= FMoonshotMoverInputBaselines::NumSlots - 2;
+		if (Result.Header.bHasBaseline != bBaselineStillHeld || !Result.bDecoded)
+		{
+			AddError(FString::Printf(TEXT("Input %d is %s with the only ack %d inputs old"), Frame, Result.Header.bHasBaseline ? TEXT("a delta") : TEXT("a keyframe"), Frame));
+			break;
+		}
+	}
+
+	// Sequence 0 is current again, but the ack for the old sequence 0 must not be taken for it
+	FMoonshotMoverCharacterInputs Baseline;
+	uint8 BaselineSequence = 0;
+	TestFalse(TEXT("Ack from a wrap ago is not a baseline"), FMoonshotMoverInputBaselines::FindSendBaseline(Link.ClientMap, Baseline, BaselineSequence));
+
+	// A late ack for a command the client no longer holds is ignored
+	FMoonshotMoverInputBaselines::Acknowledge(Link.ClientMap, static_cast<uint8>(Frame - FMoonshotMoverInputBaselines::NumSlots - 10));
+	TestFalse(TEXT("Stale ack is ignored"), FMoonshotMoverInputBaselines::FindSendBaseline(Link.ClientMap, Baseline, BaselineSequence));
+
+	// The stream recovers with the next ack that gets through
+	Link.Send(MakeInput(Frame), Received);
+	TestTrue(TEXT("Server acks the newest input"), Link.Ack().IsSet());
+	const FResult Result = Link.Send(MakeInput(Frame + 1), Received);
+	TestTrue(TEXT("Stream recovers with a delta"), Result.bDecoded && Result.Header.bHasBaseline && Result.Header.BaselineSequence == static_cast<uint8>(Frame));
+	TestTrue(TEXT("Recovered delta decodes like a keyframe"), IsSameCommand(Received, DecodeAsKeyframe(MakeInput(Frame + 1))));
+
+	// The server misses far more inputs than the 8 bits can count; it starts over rather than refusing them as old
+	for (int32 Lost = 0; Lost < 150; ++Lost)
+	{
+		++Frame;
+		Link.Send(MakeInput(Frame + 1), Received, false);
+	}
+	const FResult AfterGap = Link.Send(MakeInput(Frame + 2), Received);
+	TestTrue(TEXT("Input after a long gap decodes"), AfterGap.bDecoded && !AfterGap.Header.bHasBaseline);
+	TestEqual(TEXT("Input after a long gap is acked"), Link.Ack().Get(0), static_cast<uint8>(Frame + 2));
+
+	return true;
+}
+
+bool FMoonshotMoverInputRedundancyTest::RunTest(const FString& Parameters)
+{
+	using namespace MoonshotMoverInputStreamTest;
+
+	const FScopedCVar CompactInputs(TEXT("moonshot.Mover.CompactInputs"), true);
+	const FScopedCVar DeltaInputs(TEXT("moonshot.Mover.DeltaInputs"), true);
+	const FScopedCVar Redundancy(TEXT("moonshot.Mover.InputRedundancy"), TEXT("3"));
+
+	FLink Link;
+	FMoonshotMoverCharacterInputs Received;
+	Link.Send(MakeInput(0), Received);
+	Link.Ack();
+
+	// Three lost packets are all recovered from the next one
+	for (int32 Frame = 1; Frame <= 3; ++Frame)
+	{
+		Link.Send(MakeInput(Frame), Received, false);
+	}
+	FResult Result = Link.Send(MakeInput(4), Received);
+	TestTrue(TEXT("Input 4 decodes"), Result.bDecoded && IsSameCommand(Received, DecodeAsKeyframe(MakeInput(4))));
+	TestEqual(TEXT("Input 4 resends 1 to 3"), Result.Header.NumRedundant, static_cast<uint32>(3));
+	for (int32 Frame = 1; Frame <= 3; ++Frame)
+	{
+		FMoonshotMoverCharacterInputs Recovered;
+		TestTrue(*FString::Printf(TEXT("Input %d is recovered"), Frame), FMoonshotMoverInputBaselines::FindReceivedBaseline(Link.ServerMap, static_cast<uint8>(Frame), Recovered)
+			&& IsSameCommand(Recovered, DecodeAsKeyframe(MakeInput(Frame))));
+	}
+
+	// The window is capped at moonshot.Mover.InputRedundancy
+	for (int32 Frame = 5; Frame <= 9; ++Frame)
+	{
+		Link.Send(MakeInput(Frame), Received, false);
+	}
+	Result = Link.Send(MakeInput(10), Received);
+	TestEqual(TEXT("Input 10 resends 7 to 9"), Result.Header.NumRedundant, static_cast<uint32>(3));
+	FMoonshotMoverCharacterInputs Recovered;
+	TestFalse(TEXT("Input 6 is lost for good"), FMoonshotMoverInputBaselines::FindReceivedBaseline(Link.ServerMap, 6, Recovered));
+	TestTrue(TEXT("Input 7 is recovered"), FMoonshotMoverInputBaselines::FindReceivedBaseline(Link.ServerMap, 7, Recovered)
+		&& IsSameCommand(Recovered, DecodeAsKeyframe(MakeInput(7))));
+
+	// Nothing at or before the acked command is resent
+	Link.Ack();
+	Result = Link.Send(MakeInput(11), Received);
+	TestEqual(TEXT("Input 11 resends nothing once 10 is acked"), Result.Header.NumRedundant, static_cast<uint32>(0));
+	Result = Link.Send(MakeInput(12), Received);
+	TestEqual(TEXT("Input 12 resends only 11"), Result.Header.NumRedundant, static_cast<uint32>(1));
+
+	// Keyframes keep the window as long as the stream is acked
+	{
+		const FScopedCVar NoDelta(TEXT("moonshot.Mover.DeltaInputs"), false);
+		Result = Link.Send(MakeInput(13), Received);
+		TestTrue(TEXT("Keyframe with a window decodes"), Result.bDecoded && !Result.Header.bHasBaseline && IsSameCommand(Received, DecodeAsKeyframe(MakeInput(13))));
+		TestEqual(TEXT("Keyframe resends 10 to 12"), Result.Header.NumRedundant, static_cast<uint32>(3));
+	}
+
+	return true;
+}
+
+bool FMoonshotMoverInputUnackedStreamTest::RunTest(const FString& Parameters)
+{
+	using namespace MoonshotMoverInputStreamTest;
+
+	const FScopedCVar CompactInputs(TEXT("moonshot.Mover.CompactInputs"), true);
+	const FScopedCVar DeltaInputs(TEXT("moonshot.Mover.DeltaInputs"), true);
+	const FScopedCVar Redundancy(TEXT("moonshot.Mover.InputRedundancy"), TEXT("7"));
+
+	// Like the server sending two proxies' inputs down one connection: nothing is acked, and sequences interleave
+	FLink Link;
+	FMoonshotMoverCharacterInputs Received;
+	for (int32 Frame = 0; Frame < 20; ++Frame)
+	{
+		const int32 Sequence = (Frame % 2 == 0) ? Frame : 100 + Frame;
+		const FResult Result = Link.Send(MakeInput(Sequence), Received);
+		Link.Ack(false);
+
+		const FString What = FString::Printf(TEXT("Unacked input %d"), Sequence);
+		TestTrue(*(What + TEXT(" decodes")), Result.bDecoded && IsSameCommand(Received, DecodeAsKeyframe(MakeInput(Sequence))));
+		TestFalse(*(What + TEXT(" is a keyframe")), Result.Header.bHasBaseline);
+		TestEqual(*(What + TEXT(" resends nothing")), Result.Header.NumRedundant, static_cast<uint32>(0));
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
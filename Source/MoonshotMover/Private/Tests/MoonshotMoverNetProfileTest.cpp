@@ -0,0 +1,166 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "MoonshotMoverDataModelTypes.h"
+#include "MoonshotMoverModeRegistry.h"
+#include "MoonshotMoverNetProfiler.h"
+#include "MoonshotMoverTestHelpers.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "UObject/CoreNet.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMoonshotMoverNetProfileTest, "Moonshot.Mover.NetProfileGolden",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+namespace MoonshotMoverNetProfileTest
+{
+	constexpr int32 NumFrames = 120;
+
+	// Two alternating commands whose compact keyframes have a known size: 61 and 121 bits, compact flag included.
+	// Move input stays zero because packed vectors size themselves by value.
+	FMoonshotMoverCharacterInputs MakeInput(int32 Frame)
+	{
+		FMoonshotMoverCharacterInputs Input;
+		Input.InputSequence = static_cast<uint8>(Frame);
+		if (Frame % 2 == 0)
+		{
+			Input.ControlRotation = FRotator(0.0, 90.0, 0.0);
+		}
+		else
+		{
+			Input.OrientationIntent = FVector(1.0, 0.0, 0.0);
+			Input.ControlRotation = FRotator(10.0, 20.0, 30.0);
+			Input.AngularVelocity = FRotator(0.0, 45.0, 0.0);
+			Input.SuggestedMovementMode = MoonshotModeNames::ZeroG;
+			Input.bIsJumpPressed = true;
+		}
+		return Input;
+	}
+
+	// Without a package map there are no baselines or redundant commands, so every command is a keyframe
+	const TCHAR* GoldenCsv =
+		TEXT("Frame,Connection,Direction,Struct,Field,Count,Bits,AvgBits\n")
+		TEXT("0,None,Receive,FMoonshotMoverCharacterInputs,(total),60,5460,91.00\n")
+		TEXT("0,None,Receive,FMoonshotMoverCharacterInputs,AngularVelocity,60,630,10.50\n")
+		TEXT("0,None,Receive,FMoonshotMoverCharacterInputs,ControlRotation,60,2460,41.00\n")
+		TEXT("0,None,Receive,FMoonshotMoverCharacterInputs,Gravity,60,120,2.00\n")
+		TEXT("0,None,Receive,FMoonshotMoverCharacterInputs,Header,60,720,12.00\n")
+		TEXT("0,None,Receive,FMoonshotMoverCharacterInputs,Jump,60,120,2.00\n")
+		TEXT("0,None,Receive,FMoonshotMoverCharacterInputs,MoveInput,60,180,3.00\n")
+		TEXT("0,None,Receive,FMoonshotMoverCharacterInputs,MovementBase,60,60,1.00\n")
+		TEXT("0,None,Receive,FMoonshotMoverCharacterInputs,OrientationIntent,60,810,13.50\n")
+		TEXT("0,None,Receive,FMoonshotMoverCharacterInputs,SuggestedMode,60,300,5.00\n")
+		TEXT("0,None,Send,FMoonshotMoverCharacterInputs,(total),60,5460,91.00\n")
+		TEXT("0,None,Send,FMoonshotMoverCharacterInputs,AngularVelocity,60,630,10.50\n")
+		TEXT("0,None,Send,FMoonshotMoverCharacterInputs,ControlRotation,60,2460,41.00\n")
+		TEXT("0,None,Send,FMoonshotMoverCharacterInputs,Gravity,60,120,2.00\n")
+		TEXT("0,None,Send,FMoonshotMoverCharacterInputs,Header,60,720,12.00\n")
+		TEXT("0,None,Send,FMoonshotMoverCharacterInputs,Jump,60,120,2.00\n")
+		TEXT("0,None,Send,FMoonshotMoverCharacterInputs,MoveInput,60,180,3.00\n")
+		TEXT("0,None,Send,FMoonshotMoverCharacterInputs,MovementBase,60,60,1.00\n")
+		TEXT("0,None,Send,FMoonshotMoverCharacterInputs,OrientationIntent,60,810,13.50\n")
+		TEXT("0,None,Send,FMoonshotMoverCharacterInputs,SuggestedMode,60,300,5.00\n")
+		TEXT("60,None,Receive,FMoonshotMoverCharacterInputs,(total),60,5460,91.00\n")
+		TEXT("60,None,Receive,FMoonshotMoverCharacterInputs,AngularVelocity,60,630,10.50\n")
+		TEXT("60,None,Receive,FMoonshotMoverCharacterInputs,ControlRotation,60,2460,41.00\n")
+		TEXT("60,None,Receive,FMoonshotMoverCharacterInputs,Gravity,60,120,2.00\n")
+		TEXT("60,None,Receive,FMoonshotMoverCharacterInputs,Header,60,720,12.00\n")
+		TEXT("60,None,Receive,FMoonshotMoverCharacterInputs,Jump,60,120,2.00\n")
+		TEXT("60,None,Receive,FMoonshotMoverCharacterInputs,MoveInput,60,180,3.00\n")
+		TEXT("60,None,Receive,FMoonshotMoverCharacterInputs,MovementBase,60,60,1.00\n")
+		TEXT("60,None,Receive,FMoonshotMoverCharacterInputs,OrientationIntent,60,810,13.50\n")
+		TEXT("60,None,Receive,FMoonshotMoverCharacterInputs,SuggestedMode,60,300,5.00\n")
+		TEXT("60,None,Send,FMoonshotMoverCharacterInputs,(total),60,5460,91.00\n")
+		TEXT("60,None,Send,FMoonshotMoverCharacterInputs,AngularVelocity,60,630,10.50\n")
+		TEXT("60,None,Send,FMoonshotMoverCharacterInputs,ControlRotation,60,2460,41.00\n")
+		TEXT("60,None,Send,FMoonshotMoverCharacterInputs,Gravity,60,120,2.00\n")
+		TEXT("60,None,Send,FMoonshotMoverCharacterInputs,Header,60,720,12.00\n")
+		TEXT("60,None,Send,FMoonshotMoverCharacterInputs,Jump,60,120,2.00\n")
+		TEXT("60,None,Send,FMoonshotMoverCharacterInputs,MoveInput,60,180,3.00\n")
+		TEXT("60,None,Send,FMoonshotMoverCharacterInputs,MovementBase,60,60,1.00\n")
+		TEXT("60,None,Send,FMoonshotMoverCharacterInputs,OrientationIntent,60,810,13.50\n")
+		TEXT("60,None,Send,FMoonshotMoverCharacterInputs,SuggestedMode,60,300,5.00\n")
+		TEXT("Total,None,Receive,FMoonshotMoverCharacterInputs,(total),120,10920,91.00\n")
+		TEXT("Total,None,Receive,FMoonshotMoverCharacterInputs,AngularVelocity,120,1260,10.50\n")
+		TEXT("Total,None,Receive,FMoonshotMoverCharacterInputs,ControlRotation,120,4920,41.00\n")
+		TEXT("Total,None,Receive,FMoonshotMoverCharacterInputs,Gravity,120,240,2.00\n")
+		TEXT("Total,None,Receive,FMoonshotMoverCharacterInputs,Header,120,1440,12.00\n")
+		TEXT("Total,None,Receive,FMoonshotMoverCharacterInputs,Jump,120,240,2.00\n")
+		TEXT("Total,None,Receive,FMoonshotMoverCharacterInputs,MoveInput,120,360,3.00\n")
+		TEXT("Total,None,Receive,FMoonshotMoverCharacterInputs,MovementBase,120,120,1.00\n")
+		TEXT("Total,None,Receive,FMoonshotMoverCharacterInputs,OrientationIntent,120,1620,13.50\n")
+		TEXT("Total,None,Receive,FMoonshotMoverCharacterInputs,SuggestedMode,120,600,5.00\n")
+		TEXT("Total,None,Send,FMoonshotMoverCharacterInputs,(total),120,10920,91.00\n")
+		TEXT("Total,None,Send,FMoonshotMoverCharacterInputs,AngularVelocity,120,1260,10.50\n")
+		TEXT("Total,None,Send,FMoonshotMoverCharacterInputs,ControlRotation,120,4920,41.00\n")
+		TEXT("Total,None,Send,FMoonshotMoverCharacterInputs,Gravity,120,240,2.00\n")
+		TEXT("Total,None,Send,FMoonshotMoverCharacterInputs,Header,120,1440,12.00\n")
+		TEXT("Total,None,Send,FMoonshotMoverCharacterInputs,Jump,120,240,2.00\n")
+		TEXT("Total,None,Send,FMoonshotMoverCharacterInputs,MoveInput,120,360,3.00\n")
+		TEXT("Total,None,Send,FMoonshotMoverCharacterInputs,MovementBase,120,120,1.00\n")
+		TEXT("Total,None,Send,FMoonshotMoverCharacterInputs,OrientationIntent,120,1620,13.50\n")
+		TEXT("Total,None,Send,FMoonshotMoverCharacterInputs,SuggestedMode,120,600,5.00\n");
+}
+
+bool FMoonshotMoverNetProfileTest::RunTest(const FString& Parameters)
+{
+	using namespace MoonshotMoverNetProfileTest;
+	using MoonshotMoverTest::FScopedCVar;
+
+	const FScopedCVar NetProfile(TEXT("moonshot.Mover.NetProfile"), true);
+	const FScopedCVar CompactInputs(TEXT("moonshot.Mover.CompactInputs"), true);
+	const FScopedCVar SendInputGravity(TEXT("moonshot.Mover.SendInputGravity"), false);
+	if (!TestNotNull(TEXT("moonshot.Mover.NetProfile"), NetProfile.Variable))
+	{
+		return false;
+	}
+
+	FMoonshotMoverNetProfiler::Reset();
+
+	for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+	{
+		FMoonshotMoverNetProfiler::SetSimFrame(Frame);
+
+		FMoonshotMoverCharacterInputs Sent = MakeInput(Frame);
+		FNetBitWriter Writer(nullptr, 0);
+		bool bSuccess = true;
+		Sent.NetSerialize(Writer, nullptr, bSuccess);
+
+		FNetBitReader Reader(nullptr, Writer.GetData(), Writer.GetNumBits());
+		FMoonshotMoverCharacterInputs Received;
+		Received.NetSerialize(Reader, nullptr, bSuccess);
+		TestTrue(*FString::Printf(TEXT("Frame %d round trips"), Frame), bSuccess && Reader.AtEnd());
+	}
+
+	const FString Filename = FPaths::AutomationTransientDir() / TEXT("NetProfileGolden.csv");
+	FString Csv;
+	const bool bWritten = FMoonshotMoverNetProfiler::WriteCsv(Filename) && FFileHelper::LoadFileToString(Csv, *Filename);
+	FMoonshotMoverNetProfiler::Reset();
+
+	if (!TestTrue(TEXT("Profile written"), bWritten))
+	{
+		return false;
+	}
+
+	// Report the first row that differs rather than two 60-line blobs
+	TArray<FString> Rows, GoldenRows;
+	Csv.ParseIntoArrayLines(Rows);
+	FString(GoldenCsv).ParseIntoArrayLines(GoldenRows);
+	for (int32 Row = 0; Row < FMath::Max(Rows.Num(), GoldenRows.Num()); ++Row)
+	{
+		const FString Actual = Rows.IsValidIndex(Row) ? Rows[Row] : FString(TEXT("(missing)"));
+		const FString Expected = GoldenRows.IsValidIndex(Row) ? GoldenRows[Row] : FString(TEXT("(missing)"));
+		if (!Actual.Equals(Expected, ESearchCase::CaseSensitive))
+		{
+			AddError(FString::Printf(TEXT("Row %d is \"%s\", expected \"%s\""), Row, *Actual, *Expected));
+			break;
+		}
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
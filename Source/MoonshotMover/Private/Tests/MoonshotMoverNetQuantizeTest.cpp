@@ -0,0 +1,202 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "MoonshotMoverDataModelTypes.h"
+#include "MoonshotMoverModeRegistry.h"
+#include "MoonshotMoverNetQuantize.h"
+#include "MoonshotMoverTestHelpers.h"
+#include "Math/RandomStream.h"
+#include "UObject/CoreNet.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMoonshotMoverOctahedralTest, "Moonshot.Mover.NetQuantize.Octahedral",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMoonshotMoverGravityQuantizeTest, "Moonshot.Mover.NetQuantize.Gravity",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMoonshotMoverCompactKeyframeTest, "Moonshot.Mover.NetQuantize.CompactKeyframe",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+namespace MoonshotMoverNetQuantizeTest
+{
+	constexpr int32 NumRandomDirections = 4096;
+
+	// Matches the bound documented on FMoonshotMoverNetQuantize::OctahedralBitsPerAxis
+	constexpr double MaxOctahedralErrorDegrees = 0.05;
+
+	double AngleDegrees(const FVector& A, const FVector& B)
+	{
+		return FMath::RadiansToDegrees(FMath::Acos(FMath::Clamp(A.GetSafeNormal() | B.GetSafeNormal(), -1.0, 1.0)));
+	}
+
+	// Writes Value with Serialize, reads it back into OutValue, and returns the number of bits written or INDEX_NONE on a read error
+	template <typename T, typename FSerialize>
+	int64 RoundTrip(const T& Value, T& OutValue, FSerialize Serialize)
+	{
+		FNetBitWriter Writer(nullptr, 0);
+		T Sent = Value;
+		Serialize(Writer, Sent);
+
+		FNetBitReader Reader(nullptr, Writer.GetData(), Writer.GetNumBits());
+		Serialize(Reader, OutValue);
+		return (!Reader.IsError() && Reader.AtEnd()) ? Writer.GetNumBits() : INDEX_NONE;
+	}
+
+	TArray<FVector> MakeDirections()
+	{
+		// Axes, octant diagonals and the fold seam, where the lower hemisphere is most distorted
+		TArray<FVector> Directions = {
+			FVector::UpVector, -FVector::UpVector, FVector::ForwardVector, -FVector::ForwardVector, FVector::RightVector, -FVector::RightVector,
+			FVector(1, 1, 1), FVector(-1, 1, -1), FVector(1, -1, -1), FVector(-1, -1, -1),
+			FVector(1, 0, -1.e-4), FVector(0, -1, -1.e-4), FVector(0.5, 0.5, -1.e-6),
+		};
+
+		FRandomStream Random(0x0C7A);
+		for (int32 Index = 0; Index < NumRandomDirections; ++Index)
+		{
+			Directions.Add(Random.VRand());
+		}
+		return Directions;
+	}
+
+	void SerializeOctahedral(FArchive& Ar, FVector& Direction)
+	{
+		FMoonshotMoverNetQuantize::SerializeOctahedralUnitVector(Ar, Direction);
+	}
+
+	void SerializeGravity(FArchive& Ar, FVector& Gravity)
+	{
+		FMoonshotMoverNetQuantize::SerializeGravity(Ar, Gravity);
+	}
+}
+
+bool FMoonshotMoverOctahedralTest::RunTest(const FString& Parameters)
+{
+	using namespace MoonshotMoverNetQuantizeTest;
+
+	double WorstError = 0.0;
+	for (const FVector& Direction : MakeDirections())
+	{
+		FVector Decoded;
+		const int64 Bits = RoundTrip(Direction, Decoded, &SerializeOctahedral);
+		TestEqual(TEXT("Octahedral bits"), Bits, static_cast<int64>(2 * FMoonshotMoverNetQuantize::OctahedralBitsPerAxis));
+		TestTrue(*FString::Printf(TEXT("%s decodes to a unit vector"), *Direction.ToString()), Decoded.IsUnit());
+
+		const double Error = AngleDegrees(Direction, Decoded);
+		WorstError = FMath::Max(WorstError, Error);
+		if (Error > MaxOctahedralErrorDegrees)
+		{
+			AddError(FString::Printf(TEXT("%s decodes to %s, %.4f degrees off"), *Direction.ToString(), *Decoded.ToString(), Error));
+		}
+	}
+	AddInfo(FString::Printf(TEXT("Worst octahedral error: %.4f degrees"), WorstError));
+
+	// Documented fallback for zero
+	FVector Decoded;
+	RoundTrip(FVector::ZeroVector, Decoded, &SerializeOctahedral);
+	TestEqual(TEXT("Zero decodes as +Z"), Decoded, FVector::UpVector);
+
+	return true;
+}
+
+bool FMoonshotMoverGravityQuantizeTest::RunTest(const FString& Parameters)
+{
+	using namespace MoonshotMoverNetQuantizeTest;
+
+	constexpr int32 DirectionBits = 2 * FMoonshotMoverNetQuantize::OctahedralBitsPerAxis;
+
+	struct FCase
+	{
+		const TCHAR* Name;
+		float Magnitude;
+		int64 ExpectedBits;
+		float MagnitudeTolerance;
+	};
+
+	// One per magnitude encoding: standard, 16-bit fixed point and full float
+	const FCase Cases[] = {
+		{ TEXT("Standard"), FMoonshotMoverNetQuantize::StandardGravityMagnitude, 2 + DirectionBits, 0.f },
+		{ TEXT("Fixed"), 162.37f, 2 + 16 + DirectionBits, 0.05f },
+		{ TEXT("Full"), 10000.f, 2 + 32 + DirectionBits, 0.f },
+	};
+
+	FVector Decoded;
+	TestEqual(TEXT("Zero gravity bits"), RoundTrip(FVector::ZeroVector, Decoded, &SerializeGravity), static_cast<int64>(2));
+	TestEqual(TEXT("Zero gravity decodes as zero"), Decoded, FVector::ZeroVector);
+
+	const TArray<FVector> Directions = MakeDirections();
+	for (const FCase& Case : Cases)
+	{
+		for (int32 Index = 0; Index < Directions.Num(); Index += 16)
+		{
+			const FVector Gravity = Directions[Index].GetSafeNormal() * Case.Magnitude;
+			const int64 Bits = RoundTrip(Gravity, Decoded, &SerializeGravity);
+
+			const FString What = FString::Printf(TEXT("%s gravity %s"), Case.Name, *Gravity.ToString());
+			TestEqual(*(What + TEXT(" bits")), Bits, Case.ExpectedBits);
+			TestEqual(*(What + TEXT(" magnitude")), static_cast<float>(Decoded.Size()), Case.Magnitude, FMath::Max(Case.MagnitudeTolerance, Case.Magnitude * 1.e-6f));
+			TestTrue(*(What + TEXT(" direction")), AngleDegrees(Gravity, Decoded) <= MaxOctahedralErrorDegrees);
+		}
+	}
+
+	return true;
+}
+
+bool FMoonshotMoverCompactKeyframeTest::RunTest(const FString& Parameters)
+{
+	using namespace MoonshotMoverNetQuantizeTest;
+	using MoonshotMoverTest::FScopedCVar;
+
+	const FScopedCVar CompactInputs(TEXT("moonshot.Mover.CompactInputs"), true);
+	const FScopedCVar SendInputGravity(TEXT("moonshot.Mover.SendInputGravity"), true);
+
+	// Standing on a tilted surface, so the control rotation goes through the gravity frame
+	FMoonshotMoverCharacterInputs Sent;
+	Sent.InputSequence = 200;
+	Sent.GravityAcceleration = FVector(0.3, -0.2, -1.0).GetSafeNormal() * FMoonshotMoverNetQuantize::StandardGravityMagnitude;
+	Sent.SetMoveInput(EMoveInputType::DirectionalIntent, FVector(0.5, -0.25, 0.0));
+	Sent.OrientationIntent = FVector(0.6, 0.8, 0.0);
+	Sent.ControlRotation = FRotator(-12.5, 137.25, 3.0);
+	Sent.AngularVelocity = FRotator(0.0, 90.0, 0.0);
+	Sent.SuggestedMovementMode = MoonshotModeNames::ZeroG;
+	Sent.bIsJumpPressed = true;
+	Sent.bIsJumpJustPressed = true;
+
+	// Without a package map there is no baseline, so this is a keyframe
+	FNetBitWriter Writer(nullptr, 0);
+	bool bSuccess = true;
+	Sent.NetSerialize(Writer, nullptr, bSuccess);
+
+	FNetBitReader Reader(nullptr, Writer.GetData(), Writer.GetNumBits());
+	FMoonshotMoverCharacterInputs Received;
+	Received.NetSerialize(Reader, nullptr, bSuccess);
+	if (!TestTrue(TEXT("Keyframe round trips"), bSuccess && !Reader.IsError() && Reader.AtEnd()))
+	{
+		return false;
+	}
+
+	TestEqual(TEXT("InputSequence"), Received.InputSequence, Sent.InputSequence);
+	TestTrue(TEXT("Gravity direction"), AngleDegrees(Received.GravityAcceleration, Sent.GravityAcceleration) <= MaxOctahedralErrorDegrees);
+	TestEqual(TEXT("Gravity magnitude"), Received.GravityAcceleration.Size(), Sent.GravityAcceleration.Size(), 1.e-3);
+	TestTrue(TEXT("MoveInputType"), Received.GetMoveInputType() == Sent.GetMoveInputType());
+	TestEqual(TEXT("MoveInput"), Received.GetMoveInput(), Sent.GetMoveInput(), 0.01);
+	TestTrue(TEXT("OrientationIntent"), AngleDegrees(Received.OrientationIntent, Sent.OrientationIntent) <= MaxOctahedralErrorDegrees);
+	TestEqual(TEXT("OrientationIntent size"), Received.OrientationIntent.Size(), 1.0, 1.e-6);
+
+	// Short compression per axis plus the gravity direction error, see SerializeGravityRelativeRotation
+	const double RotationError = FMath::RadiansToDegrees(Received.ControlRotation.Quaternion().AngularDistance(Sent.ControlRotation.Quaternion()));
+	TestTrue(*FString::Printf(TEXT("ControlRotation is %.4f degrees off"), RotationError), RotationError <= 0.1);
+
+	TestTrue(TEXT("AngularVelocity"), Received.AngularVelocity.Equals(Sent.AngularVelocity, 0.01f));
+	TestEqual(TEXT("SuggestedMovementMode"), Received.SuggestedMovementMode, Sent.SuggestedMovementMode);
+	TestEqual(TEXT("bIsJumpPressed"), Received.bIsJumpPressed, Sent.bIsJumpPressed);
+	TestEqual(TEXT("bIsJumpJustPressed"), Received.bIsJumpJustPressed, Sent.bIsJumpJustPressed);
+	TestFalse(TEXT("bUsingMovementBase"), Received.bUsingMovementBase);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,220 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "MoonshotMoverAttachingMode.h"
+#include "MoonshotMoverCommonMovementSettings.h"
+#include "MoonshotMoverDataModelTypes.h"
+#include "MoonshotMoverDeterministicMath.h"
+#include "MoonshotMoverModeRegistry.h"
+#include "MoonshotMoverSurfaceWalkingMode.h"
+#include "MoonshotMoverZeroGMode.h"
+#include "Components/SphereComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Mover/Public/MoveLibrary/MoverBlackboard.h"
+#include "Mover/Public/MovementMode.h"
+#include "Mover/Public/MoverComponent.h"
+#include "Mover/Public/MoverSimulationTypes.h"
+#include "Mover/Public/MoverTypes.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMoonshotMoverReplayTest, "Moonshot.Mover.DeterministicReplay",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+namespace MoonshotMoverReplayTest
+{
+	constexpr int32 NumFrames = 300;
+	constexpr float StepMs = 1000.0f / 60.0f;
+
+	// Checksums are kept every CheckpointFrames frames and compared against the reference platform's
+	constexpr int32 CheckpointFrames = 30;
+
+	// Recorded on the reference platform and committed, so every other platform is checked against the same bits
+	FString GetGoldenFilename()
+	{
+		return FPaths::ProjectDir() / TEXT("Source/MoonshotMover/Private/Tests/DeterministicReplay.golden");
+	}
+
+	// Turning, accelerating and braking, so every mode's rotation and velocity math is exercised
+	FMoonshotMoverCharacterInputs MakeInput(int32 Frame)
+	{
+		const double Time = Frame * StepMs * 0.001;
+
+		FMoonshotMoverCharacterInputs Input;
+		Input.SetMoveInput(EMoveInputType::DirectionalIntent, FVector(FMath::Cos(Time * 0.7), FMath::Sin(Time * 1.3), 0.25 * FMath::Sin(Time)));
+		Input.OrientationIntent = FVector(FMath::Cos(Time * 0.4), FMath::Sin(Time * 0.4), 0.1);
+		Input.AngularVelocity = FRotator(20.0 * FMath::Sin(Time), 35.0 * FMath::Cos(Time * 0.5), 10.0);
+		Input.bIsJumpPressed = (Frame / 45) % 4 == 3;
+		Input.InputSequence = static_cast<uint8>(Frame);
+		return Input;
+	}
+
+	// The exact bits of what a sync state replicates
+	TArray<double> GetBits(const FMoverDefaultSyncState& SyncState)
+	{
+		const FVector Location = SyncState.GetLocation_WorldSpace();
+		const FRotator Orientation = SyncState.GetOrientation_WorldSpace();
+		const FVector Velocity = SyncState.GetVelocity_WorldSpace();
+		return { Location.X, Location.Y, Location.Z, Orientation.Pitch, Orientation.Yaw, Orientation.Roll, Velocity.X, Velocity.Y, Velocity.Z };
+	}
+
+	bool IsBitIdentical(const FMoverDefaultSyncState& A, const FMoverDefaultSyncState& B)
+	{
+		const TArray<double> BitsA = GetBits(A);
+		const TArray<double> BitsB = GetBits(B);
+		return FMemory::Memcmp(BitsA.GetData(), BitsB.GetData(), BitsA.Num() * sizeof(double)) == 0;
+	}
+
+	// Runs the scripted input through one mode from Start, the way the Mover backend would without corrections
+	void Run(UMoverComponent* MoverComponent, UBaseMovementMode* Mode, FName ModeName, const FMoverDefaultSyncState& Start, TArray<FMoverDefaultSyncState>& OutStates)
+	{
+		USceneComponent* UpdatedComponent = MoverComponent->GetOwner()->GetRootComponent();
+		UpdatedComponent->SetWorldLocationAndRotation(Start.GetLocation_WorldSpace(), Start.GetOrientation_WorldSpace(), false, nullptr, ETeleportType::TeleportPhysics);
+		UpdatedComponent->ComponentVelocity = Start.GetVelocity_WorldSpace();
+		MoverComponent->GetSimBlackboard_Mutable()->InvalidateAll();
+
+		FMoverTickStartData StartState;
+		StartState.SyncState.MovementMode = ModeName;
+		StartState.SyncState.SyncStateCollection.FindOrAddMutableDataByType<FMoverDefaultSyncState>() = Start;
+
+		OutStates.Reset(NumFrames);
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			FMoverTimeStep TimeStep;
+			TimeStep.ServerFrame = Frame;
+			TimeStep.BaseSimTimeMs = Frame * StepMs;
+			TimeStep.StepMs = StepMs;
+
+			StartState.InputCmd.InputCollection.FindOrAddMutableDataByType<FMoonshotMoverCharacterInputs>() = MakeInput(Frame);
+
+			FSimulationTickParams Params;
+			Params.MoverComponent = MoverComponent;
+			Params.UpdatedComponent = UpdatedComponent;
+			Params.UpdatedPrimitive = Cast<UPrimitiveComponent>(UpdatedComponent);
+			Params.StartState = StartState;
+			Params.TimeStep = TimeStep;
+			Mode->OnGenerateMove(StartState, TimeStep, Params.ProposedMove);
+
+			FMoverTickEndData EndState;
+			Mode->OnSimulationTick(Params, EndState);
+
+			// Mode transitions are ignored: each mode is replayed on its own
+			const FMoverDefaultSyncState& EndSyncState = EndState.SyncState.SyncStateCollection.FindOrAddMutableDataByType<FMoverDefaultSyncState>();
+			OutStates.Add(EndSyncState);
+			StartState.SyncState.SyncStateCollection.FindOrAddMutableDataByType<FMoverDefaultSyncState>() = EndSyncState;
+		}
+	}
+}
+
+bool FMoonshotMoverReplayTest::RunTest(const FString& Parameters)
+{
+	using namespace MoonshotMoverReplayTest;
+
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, /*bInformEngineOfWorld*/ false);
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+	World->InitializeActorsForPlay(FURL());
+
+	AActor* Actor = World->SpawnActor<AActor>();
+	USphereComponent* Collision = NewObject<USphereComponent>(Actor, TEXT("Collision"));
+	Collision->InitSphereRadius(40.0f);
+	Actor->SetRootComponent(Collision);
+	Collision->RegisterComponent();
+
+	UMoverComponent* MoverComponent = NewObject<UMoverComponent>(Actor, TEXT("MoverComponent"));
+
+	// Same registration the Blueprint pawns do, with the settings the modes look up in OnRegistered
+	const TPair<FName, UClass*> ModeClasses[] =
+	{
+		{ MoonshotModeNames::ZeroG, UMoonshotMoverZeroGMode::StaticClass() },
+		{ DefaultModeNames::Falling, UMoonshotMoverAttachingMode::StaticClass() },
+		{ DefaultModeNames::Walking, UMoonshotMoverSurfaceWalkingMode::StaticClass() },
+	};
+	for (const TPair<FName, UClass*>& ModeClass : ModeClasses)
+	{
+		UBaseMovementMode* Mode = NewObject<UBaseMovementMode>(MoverComponent, ModeClass.Value);
+		Mode->SharedSettingsClasses.Add(UMoonshotMoverCommonMovementSettings::StaticClass());
+		MoverComponent->MovementModes.Add(ModeClass.Key, Mode);
+	}
+	MoverComponent->StartingMovementMode = MoonshotModeNames::ZeroG;
+	MoverComponent->RegisterComponent();
+	if (!MoverComponent->HasBeenInitialized())
+	{
+		MoverComponent->InitializeComponent();
+	}
+
+	UMoonshotMoverCommonMovementSettings* Settings = MoverComponent->FindSharedSettings_Mutable<UMoonshotMoverCommonMovementSettings>();
+	// "Mode Frame Checksum" per line, in mode and frame order
+	TArray<FString> Checksums;
+
+	if (TestNotNull(TEXT("Common movement settings"), Settings))
+	{
+		Settings->bUseDeterministicMath = true;
+
+		FMoverDefaultSyncState Start;
+		Start.SetTransforms_WorldSpace(FVector(0.0, 0.0, 5000.0), FRotator(10.0, 20.0, 30.0), FVector(300.0, -150.0, 50.0), nullptr);
+
+		for (const TPair<FName, UClass*>& ModeClass : ModeClasses)
+		{
+			UBaseMovementMode* Mode = MoverComponent->MovementModes.FindRef(ModeClass.Key);
+			if (!TestNotNull(*FString::Printf(TEXT("%s mode"), *ModeClass.Key.ToString()), Mode))
+			{
+				continue;
+			}
+
+			TArray<FMoverDefaultSyncState> FirstRun, SecondRun;
+			Run(MoverComponent, Mode, ModeClass.Key, Start, FirstRun);
+			Run(MoverComponent, Mode, ModeClass.Key, Start, SecondRun);
+
+			TestFalse(*FString::Printf(TEXT("%s moved under the script"), *ModeClass.Key.ToString()), IsBitIdentical(FirstRun.Last(), Start));
+
+			for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+			{
+				if (!IsBitIdentical(FirstRun[Frame], SecondRun[Frame]))
+				{
+					AddError(FString::Printf(TEXT("%s diverged at frame %d: checksum %08x then %08x"), *ModeClass.Key.ToString(), Frame,
+						FMoonshotDeterministicMath::HashSyncState(FirstRun[Frame]), FMoonshotDeterministicMath::HashSyncState(SecondRun[Frame])));
+					break;
+				}
+			}
+
+			for (int32 Frame = CheckpointFrames - 1; Frame < NumFrames; Frame += CheckpointFrames)
+			{
+				Checksums.Add(FString::Printf(TEXT("%s %d %08x"), *ModeClass.Key.ToString(), Frame, FMoonshotDeterministicMath::HashSyncState(FirstRun[Frame])));
+			}
+		}
+	}
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(/*bInformEngineOfWorld*/ false);
+
+	// Two runs in one process only prove the sim is repeatable; the golden checksums prove it matches across platforms
+	const FString GoldenFilename = GetGoldenFilename();
+	TArray<FString> GoldenChecksums;
+	if (!FFileHelper::LoadFileToStringArray(GoldenChecksums, *GoldenFilename))
+	{
+		FFileHelper::SaveStringArrayToFile(Checksums, *GoldenFilename);
+		AddWarning(FString::Printf(TEXT("No golden checksums yet; recorded this platform's to %s. Commit it from the reference platform."), *GoldenFilename));
+		return true;
+	}
+
+	for (int32 Line = 0; Line < FMath::Max(Checksums.Num(), GoldenChecksums.Num()); ++Line)
+	{
+		const FString Actual = Checksums.IsValidIndex(Line) ? Checksums[Line] : FString(TEXT("(missing)"));
+		const FString Expected = GoldenChecksums.IsValidIndex(Line) ? GoldenChecksums[Line] : FString(TEXT("(missing)"));
+		if (!Actual.Equals(Expected, ESearchCase::CaseSensitive))
+		{
+			AddError(FString::Printf(TEXT("Diverged from the golden checksums: got \"%s\", expected \"%s\". Delete %s to re-record after an intended change."),
+				*Actual, *Expected, *GoldenFilename));
+			break;
+		}
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
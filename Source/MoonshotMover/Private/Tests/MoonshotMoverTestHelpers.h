@@ -0,0 +1,39 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/IConsoleManager.h"
+
+namespace MoonshotMoverTest
+{
+	// Sets a console variable for the lifetime of the scope
+	struct FScopedCVar
+	{
+		FScopedCVar(const TCHAR* Name, const TCHAR* Value)
+			: Variable(IConsoleManager::Get().FindConsoleVariable(Name))
+		{
+			if (Variable)
+			{
+				Previous = Variable->GetString();
+				Variable->Set(Value, ECVF_SetByCode);
+			}
+		}
+
+		FScopedCVar(const TCHAR* Name, bool bValue)
+			: FScopedCVar(Name, bValue ? TEXT("1") : TEXT("0"))
+		{
+		}
+
+		~FScopedCVar()
+		{
+			if (Variable)
+			{
+				Variable->Set(*Previous, ECVF_SetByCode);
+			}
+		}
+
+		IConsoleVariable* Variable = nullptr;
+		FString Previous;
+	};
+}
@@ -0,0 +1,91 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "MoonshotMoverZeroGBatch.h"
+#include "MoonshotMoverZeroGMode.h"
+#include "Math/RandomStream.h"
+#include "Mover/Public/MoverTypes.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMoonshotMoverZeroGBatchTest, "Moonshot.Mover.ZeroGBatchMatchesScalar",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+namespace MoonshotMoverZeroGBatchTest
+{
+	// Not a multiple of the lane width, so the padding lanes are exercised too
+	constexpr int32 NumMovers = 1021;
+
+	FVector RandomVector(FRandomStream& Random, double Scale)
+	{
+		return FVector(Random.FRandRange(-1.0, 1.0), Random.FRandRange(-1.0, 1.0), Random.FRandRange(-1.0, 1.0)) * Scale;
+	}
+
+	// Mostly ordinary movers, with every branch of the scalar path hit on purpose now and then
+	FZeroGModeParams MakeParams(FRandomStream& Random)
+	{
+		FZeroGModeParams Params;
+		Params.MaxSpeed = Random.RandRange(0, 9) == 0 ? 0.f : Random.FRandRange(100.f, 6400.f);
+		Params.MoveInput = Random.RandRange(0, 4) == 0 ? FVector::ZeroVector : RandomVector(Random, Random.FRandRange(0.f, 1.5f));
+		Params.PriorVelocity = RandomVector(Random, Random.FRandRange(0.f, 1.5f) * Params.MaxSpeed);
+		Params.AngularVelocity = FRotator(Random.FRandRange(-30.f, 30.f), Random.FRandRange(-30.f, 30.f), Random.FRandRange(-30.f, 30.f));
+		Params.Acceleration = Random.FRandRange(0.f, 4000.f);
+		Params.Deceleration = Random.FRandRange(0.f, 0.1f);
+		Params.TurningRate = Random.RandRange(0, 9) == 0 ? -1.f : Random.FRandRange(0.f, 500.f);
+		Params.DeltaSeconds = Random.RandRange(0, 19) == 0 ? 0.f : Random.FRandRange(1.f / 120.f, 1.f / 20.f);
+		return Params;
+	}
+
+	template<typename T>
+	bool IsBitIdentical(const T& A, const T& B)
+	{
+		return FMemory::Memcmp(&A, &B, sizeof(T)) == 0;
+	}
+}
+
+bool FMoonshotMoverZeroGBatchTest::RunTest(const FString& Parameters)
+{
+	using namespace MoonshotMoverZeroGBatchTest;
+
+	FRandomStream Random(0x2E60);
+	TArray<FZeroGModeParams> AllParams;
+	FZeroGModeBatch Batch;
+	Batch.SetNum(NumMovers);
+	for (int32 Index = 0; Index < NumMovers; ++Index)
+	{
+		Batch.SetMover(Index, AllParams.Add_GetRef(MakeParams(Random)));
+	}
+
+	UZeroGModeUtils::ComputeControlledFreeMoveBatch(Batch);
+
+	int32 NumMismatches = 0;
+	for (int32 Index = 0; Index < NumMovers; ++Index)
+	{
+		const FProposedMove Scalar = UZeroGModeUtils::ComputeControlledFreeMove(AllParams[Index], FTransform::Identity, nullptr);
+		const FProposedMove Batched = Batch.GetProposedMove(Index);
+
+		const bool bMatches = IsBitIdentical(Scalar.DirectionIntent, Batched.DirectionIntent)
+			&& Scalar.bHasDirIntent == Batched.bHasDirIntent
+			&& IsBitIdentical(Scalar.LinearVelocity, Batched.LinearVelocity)
+			&& IsBitIdentical(Scalar.AngularVelocity, Batched.AngularVelocity);
+
+		// Report a few rather than a thousand
+		if (!bMatches && ++NumMismatches <= 5)
+		{
+			AddError(FString::Printf(TEXT("Mover %d: scalar velocity %s angular %s, batched velocity %s angular %s"), Index,
+				*Scalar.LinearVelocity.ToString(), *Scalar.AngularVelocity.ToString(), *Batched.LinearVelocity.ToString(), *Batched.AngularVelocity.ToString()));
+		}
+	}
+	TestEqual(TEXT("Movers whose batched move differs from the scalar one"), NumMismatches, 0);
+
+	// Padding lanes stay idle
+	for (int32 Lane = NumMovers; Lane < Batch.GetPaddedNum(); ++Lane)
+	{
+		TestTrue(TEXT("Padding lane produces no velocity"), Batch.LinearVelocityX[Lane] == 0.0 && Batch.LinearVelocityY[Lane] == 0.0 && Batch.LinearVelocityZ[Lane] == 0.0);
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
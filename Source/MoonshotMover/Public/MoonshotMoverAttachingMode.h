@@ -166,4 +166,11 @@ public:
     UFUNCTION(BlueprintCallable, Category=Mover)
     static float TryMoveToFallAlongSurface(USceneComponent* UpdatedComponent, UPrimitiveComponent* UpdatedPrimitive, UMoverComponent* MoverComponent, const FVector& Delta, float PctOfDeltaToMove, const FQuat Rotation, const FVector& Normal, FHitResult& Hit, bool bHandleImpact, float FloorSweepDistance, float MaxWalkSlopeCosine, FFloorCheckResult& OutFloorResult, FMovementRecord& MoveRecord);
 
+    /**
+     * Time (seconds) until a body at Height above a plane reaches it, given its velocity and acceleration along the plane normal.
+     * Solves Height + NormalVelocity*t + 0.5*NormalAcceleration*t^2 = 0. Returns UE_BIG_NUMBER if it never gets there.
+     */
+    UFUNCTION(BlueprintCallable, Category=Mover)
+    static float ComputeTimeToImpact(float Height, float NormalVelocity, float NormalAcceleration);
+
 };
\ No newline at end of file
@@ -5,7 +5,7 @@
 #include "Mover/Public/MovementMode.h"
 #include "MoonshotMoverCommonMovementSettings.generated.h"
 
-UCLASS(BlueprintType)
+UCLASS(BlueprintType, config=Game)
 class MOONSHOTMOVER_API UMoonshotMoverCommonMovementSettings : public UObject, public IMovementSettingsInterface
 {
 	GENERATED_BODY()
@@ -45,6 +45,55 @@ public:
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category="General", meta = (ClampMin = "0", UIMin = "0", ForceUnits = "Multiplier"))
 	float TurningBoost = 8.f;
 
+	/** How far (cm) the actor may be from where another mode last validated its floor for the entering mode to reuse that floor instead of querying again */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category="General", meta = (ClampMin = "0", UIMin = "0", ForceUnits = "cm"))
+	float FloorHandoffTolerance = 1.0f;
+
+	/** Split ZeroG and Attaching moves into substeps when a single sweep would cover too much distance relative to the collider.
+	 *  Sweeps already stop at the first hit, so this only refines the path of fast moves that turn or slide; it costs up to MaxSubsteps times the sweeps. */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category="General|Substepping")
+	bool bEnableAdaptiveSubstepping = false;
+
+	/** A tick is split once its move exceeds this fraction of the collider radius per substep */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category="General|Substepping", meta = (ClampMin = "0.05", UIMin = "0.05", EditCondition = "bEnableAdaptiveSubstepping"))
+	float SubstepDistanceRadiusFraction = 0.5f;
+
+	/** Upper bound on substeps per tick. Also used when a known surface is predicted to be reached within the tick. */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category="General|Substepping", meta = (ClampMin = "1", UIMin = "1", ClampMax = "16", EditCondition = "bEnableAdaptiveSubstepping"))
+	int32 MaxSubsteps = 4;
+
+	/** Do the modes' rotation math through FMoonshotDeterministicMath so replaying the same inputs gives bit-identical results on every machine.
+	 *  Slower than FMath; enable when prediction corrections and resimulation cost matter more than tick cost. */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category="General")
+	bool bUseDeterministicMath = false;
+
+	/** Estimated cost of one correction's resimulation above which the modes take their cheapest path, leaving the remaining error to smoothing. 0 means no cap.
+	 *  SurfaceWalking keeps a standing pawn's floor on static geometry instead of searching for it again; ZeroG and Attaching also drop
+	 *  substepping when bEnableAdaptiveSubstepping is on. It does not skip or shorten the resim. See moonshot.Mover.SimTelemetry for what resims actually cost. */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category="General|Resimulation", meta = (ClampMin = "0", UIMin = "0", ForceUnits = "ms"))
+	float ResimBudgetMs = 0.f;
+
+	/** Let simulated proxies that are far away and off screen extrapolate without collision instead of running the full mode (see FMoonshotMoverProxySimulation) */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category="General|Proxies")
+	bool bExtrapolateDistantProxies = true;
+
+	/** Simulated proxies closer than this to the local view always run the full mode */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category="General|Proxies", meta = (ClampMin = "0", UIMin = "0", ForceUnits = "cm", EditCondition = "bExtrapolateDistantProxies"))
+	float ProxyFullSimDistance = 3000.f;
+
+	/** Simulated proxies that were just rendered run the full mode up to this distance from the local view */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category="General|Proxies", meta = (ClampMin = "0", UIMin = "0", ForceUnits = "cm", EditCondition = "bExtrapolateDistantProxies"))
+	float ProxyVisibleFullSimDistance = 20000.f;
+
+	/** Gravity applied by Attaching and SurfaceWalking, along the Mover's current down */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category="General|Gravity", meta = (ClampMin = "0", UIMin = "0", ForceUnits = "cm/s^2"))
+	float GravityMagnitude = 980.f;
+
+	/** Compatibility: let FMoonshotMoverCharacterInputs::GravityAcceleration override the sim-derived gravity. Off means clients cannot author gravity.
+	 *  Clients also need moonshot.Mover.SendInputGravity for the field to be sent at all. */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category="General|Gravity")
+	bool bAcceptInputGravity = false;
+
 /********************************
  * Attached Movement
  ********************************/
@@ -111,6 +160,11 @@ public:
 	/** Instantaneous speed induced in an actor upon jumping */
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category="Attached Movement", meta = (ClampMin = "0", UIMin = "0", ForceUnits = "cm/s"))
 	float JumpUpwardsSpeed = 500.0f;
+
+	/** Jump speeds a jump layered move can send as a 4-bit index instead of a float. Read from the class defaults so every machine uses the same table;
+	 *  speeds not listed still work but are sent in full. */
+	UPROPERTY(Config, EditDefaultsOnly, Category="Attached Movement")
+	TArray<float> NetJumpSpeedTable = { 500.0f };
 	
 	/** Depth at which the pawn starts swimming */
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Attached Movement", meta = (Units = "cm"))
@@ -135,6 +189,14 @@ public:
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category="Attaching", meta = (ClampMin = "0", UIMin = "0"))
 	float MaxAttachDistance = 3000.f;
 
+    /** When falling toward a static surface, predict time-to-impact against its plane and skip floor/attach queries until contact is near. */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category="Attaching")
+	bool bUsePredictedContact = true;
+
+    /** Extra time (seconds) before predicted contact at which full landing queries resume. Covers input and speed clamping the prediction ignores. */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category="Attaching", meta = (ClampMin = "0", UIMin = "0", ForceUnits = "s", EditCondition = "bUsePredictedContact"))
+	float PredictedContactWindow = 0.1f;
+
 /********************************
  * ZeroG Movement
  ********************************/
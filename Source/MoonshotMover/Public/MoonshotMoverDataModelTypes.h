@@ -5,8 +5,76 @@
 #include "Mover/Public/MoverTypes.h"
 #include "Mover/Public/LayeredMove.h"
 #include "Mover/Public/MoverDataModelTypes.h"
+#include "Mover/Public/MoveLibrary/BasedMovementUtils.h"
+#include "Mover/Public/MoveLibrary/FloorQueryUtils.h"
+#include "MoonshotMoverInputLatency.h"
 #include "MoonshotMoverDataModelTypes.generated.h"
 
+class UMoverBlackboard;
+class UMoonshotMoverCommonMovementSettings;
+
+namespace MoonshotBlackboard
+{
+	// FMoonshotMoverPredictedContact: surface plane an Attaching fall is heading toward
+	const FName PredictedContact = TEXT("PredictedContact");
+
+	// FMoonshotMoverFloorHandoff: last validated floor, kept across mode switches
+	const FName FloorHandoff = TEXT("FloorHandoff");
+
+	// FMoonshotMoverInputRepairState: last input sequence the server simulated
+	const FName InputRepair = TEXT("InputRepair");
+}
+
+// Blackboard entry for the Attaching mode's predicted contact. The plane comes from the attach trace and only static surfaces are predicted.
+struct FMoonshotMoverPredictedContact
+{
+	FVector PlanePoint = FVector::ZeroVector;
+	FVector PlaneNormal = FVector::UpVector;
+
+	// Distance from the updated component's origin to its lowest point along PlaneNormal
+	float ContactOffset = 0.f;
+
+	// Height of the component's lowest point above the plane
+	double GetHeightAbovePlane(const FVector& Location) const
+	{
+		return ((Location - PlanePoint) | PlaneNormal) - ContactOffset;
+	}
+};
+
+/**
+ * Blackboard entry carrying a validated floor, its movement base and contact normal across movement mode transitions.
+ * Stock modes wipe CommonBlackboard::LastFloorResult (ZeroG does so every tick); this survives them, so the entering mode
+ * can skip its initial FindFloor when the actor has not moved away from where the floor was validated.
+ */
+struct MOONSHOTMOVER_API FMoonshotMoverFloorHandoff
+{
+	FFloorCheckResult Floor;
+	FRelativeBaseInfo BaseInfo;
+	FVector ContactNormal = FVector::UpVector;
+	FVector ValidatedLocation = FVector::ZeroVector;
+	FName SourceModeName = NAME_None;
+
+	// True if the floor is still walkable, still exists, its dynamic base (if any) has not moved, and Location is within Tolerance of where it was validated
+	bool IsValidAt(const FVector& Location, float Tolerance) const;
+
+	static void Publish(UMoverBlackboard* SimBlackboard, FName SourceModeName, const FFloorCheckResult& Floor, const FRelativeBaseInfo& BaseInfo, const FVector& Location);
+
+	static bool TryGetValid(const UMoverBlackboard* SimBlackboard, const FVector& Location, float Tolerance, FMoonshotMoverFloorHandoff& OutHandoff);
+};
+
+/**
+ * Sim-side gravity. Derived from the sync state rather than sent by clients, so it is identical on client, server and during
+ * resimulation, and clients cannot author it.
+ */
+struct MOONSHOTMOVER_API FMoonshotMoverGravity
+{
+	// Input gravity if the settings accept it and the input carries one, otherwise GravityMagnitude along the sync state's down
+	static FVector Resolve(const FMoverDefaultSyncState& SyncState, const struct FMoonshotMoverCharacterInputs* Inputs, const UMoonshotMoverCommonMovementSettings& Settings);
+
+	// True if Resolve would use the input's gravity
+	static bool IsInputAuthored(const struct FMoonshotMoverCharacterInputs* Inputs, const UMoonshotMoverCommonMovementSettings& Settings);
+};
+
 // Data block containing all inputs that need to be authored and consumed for the default Mover character simulation
 USTRUCT(BlueprintType)
 struct MOONSHOTMOVER_API FMoonshotMoverCharacterInputs : public FCharacterDefaultInputs
@@ -14,16 +82,34 @@ struct MOONSHOTMOVER_API FMoonshotMoverCharacterInputs : public FCharacterDefaul
 	GENERATED_USTRUCT_BODY()
 
 protected:
+	/**
+	 * Compact wire profile, used when moonshot.Mover.CompactInputs is on: serializes every field itself (including the
+	 * FCharacterDefaultInputs ones) with zero flags, octahedral directions, gravity as magnitude index + direction and the
+	 * control rotation relative to the gravity frame. Once the receiver has acknowledged a command (FMoonshotMoverInputBaselines),
+	 * inputs are sent as a change mask plus only the fields that differ from it, preceded by up to moonshot.Mover.InputRedundancy
+	 * unacknowledged earlier commands, each delta-encoded against the one before.
+	 */
+	void NetSerializeCompact(FArchive& Ar, UPackageMap* Map);
+
+	// One command of the compact profile: a change mask against Previous (if any) plus the changed fields, jump flags and movement base
+	void SerializeCommandFields(FArchive& Ar, const FMoonshotMoverCharacterInputs* Previous);
 
 public:
     // For maintaining angular momentum in ZeroG
 	UPROPERTY(BlueprintReadWrite, Category = Mover)
 	FRotator AngularVelocity = FRotator::ZeroRotator;
 
-    // For synchronizing gravity
+    // Client-authored gravity override. Ignored unless UMoonshotMoverCommonMovementSettings::bAcceptInputGravity is set, and only sent
+    // when moonshot.Mover.SendInputGravity is on; the modes otherwise derive gravity themselves (FMoonshotMoverGravity).
     UPROPERTY(BlueprintReadWrite, Category = Mover)
     FVector GravityAcceleration = FVector::ZeroVector;
 
+	// Assigned per produced frame by the owning pawn. Identifies the command across redundant resends and acks.
+	uint8 InputSequence = 0;
+
+	// When the input in this command happened, for latency stats. Set by the producing pawn, never sent.
+	FMoonshotMoverInputLatencyStamp LatencyStamp;
+
 	FMoonshotMoverCharacterInputs() : FCharacterDefaultInputs()
 	{
 	}
@@ -0,0 +1,118 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FMoverDefaultSyncState;
+struct FMoverTimeStep;
+class UMoverComponent;
+
+/**
+ * FMoonshotDeterministicMath: scalar rotation math that gives the same bits on every platform and build configuration.
+ * It uses only IEEE basic operations and sqrt, evaluated in a fixed order with FMA contraction disabled. Trig functions
+ * are polynomial approximations instead of the CRT, and nothing goes through the SIMD paths FQuat/FRotator use.
+ * This is slower than FMath, so modes only use it when UMoonshotMoverCommonMovementSettings::bUseDeterministicMath is set.
+ */
+struct MOONSHOTMOVER_API FMoonshotDeterministicMath
+{
+	static void SinCos(double Radians, double& OutSin, double& OutCos);
+	static double Atan2(double Y, double X);
+	static double Asin(double X);
+	static double Acos(double X);
+
+	// Same conventions as FRotator::Quaternion and FQuat::Rotator
+	static FQuat RotatorToQuat(const FRotator& Rotator);
+	static FRotator QuatToRotator(const FQuat& Quat);
+
+	// Same conventions as FRotator::Vector, FVector::ToOrientationRotator and FRotator::GetWindingAndRemainder
+	static FVector RotatorToVector(const FRotator& Rotator);
+	static FRotator VectorToRotator(const FVector& V);
+	static void GetWindingAndRemainder(const FRotator& Rotator, FRotator& OutWinding, FRotator& OutRemainder);
+
+	// Same conventions as the FQuat operators/functions of the same name
+	static FQuat Multiply(const FQuat& A, const FQuat& B);
+	static FQuat GetNormalized(const FQuat& Quat);
+	static FQuat FindBetweenNormals(const FVector& A, const FVector& B);
+	static FQuat Slerp(const FQuat& A, const FQuat& B, double Alpha);
+	static FVector RotateVector(const FQuat& Quat, const FVector& V);
+	static FVector GetSafeNormal(const FVector& V, double Tolerance = UE_SMALL_NUMBER);
+
+	// Hash of the exact bits of location, orientation and velocity. Equal on client and server only if the simulation matched bit for bit.
+	static uint32 HashSyncState(const FMoverDefaultSyncState& SyncState);
+
+	// Logs HashSyncState for this frame when moonshot.Mover.LogSyncChecksums is enabled, so client and server logs can be diffed
+	static void LogSyncStateChecksum(const UMoverComponent* MoverComponent, const FMoverTimeStep& TimeStep, const FMoverDefaultSyncState& SyncState);
+};
+
+/**
+ * FMoonshotMoverMath: picks between FMath/FQuat and FMoonshotDeterministicMath once per tick, so mode code stays one path:
+ *     const FMoonshotMoverMath Math(CommonMovementSettings->bUseDeterministicMath);
+ *     OrientQuat = Math.Multiply(OrientQuat, Math.RotatorToQuat(AngularDelta));
+ */
+struct FMoonshotMoverMath
+{
+	explicit FMoonshotMoverMath(bool bInDeterministic) : bDeterministic(bInDeterministic) {}
+
+	FQuat RotatorToQuat(const FRotator& Rotator) const
+	{
+		return bDeterministic ? FMoonshotDeterministicMath::RotatorToQuat(Rotator) : Rotator.Quaternion();
+	}
+
+	FRotator QuatToRotator(const FQuat& Quat) const
+	{
+		return bDeterministic ? FMoonshotDeterministicMath::QuatToRotator(Quat) : Quat.Rotator();
+	}
+
+	FVector RotatorToVector(const FRotator& Rotator) const
+	{
+		return bDeterministic ? FMoonshotDeterministicMath::RotatorToVector(Rotator) : Rotator.Vector();
+	}
+
+	FRotator VectorToRotator(const FVector& V) const
+	{
+		return bDeterministic ? FMoonshotDeterministicMath::VectorToRotator(V) : V.ToOrientationRotator();
+	}
+
+	void GetWindingAndRemainder(const FRotator& Rotator, FRotator& OutWinding, FRotator& OutRemainder) const
+	{
+		if (bDeterministic)
+		{
+			FMoonshotDeterministicMath::GetWindingAndRemainder(Rotator, OutWinding, OutRemainder);
+		}
+		else
+		{
+			Rotator.GetWindingAndRemainder(OutWinding, OutRemainder);
+		}
+	}
+
+	FQuat Multiply(const FQuat& A, const FQuat& B) const
+	{
+		return bDeterministic ? FMoonshotDeterministicMath::Multiply(A, B) : A * B;
+	}
+
+	FQuat GetNormalized(const FQuat& Quat) const
+	{
+		return bDeterministic ? FMoonshotDeterministicMath::GetNormalized(Quat) : Quat.GetNormalized();
+	}
+
+	FQuat FindBetweenNormals(const FVector& A, const FVector& B) const
+	{
+		return bDeterministic ? FMoonshotDeterministicMath::FindBetweenNormals(A, B) : FQuat::FindBetweenNormals(A, B);
+	}
+
+	FQuat Slerp(const FQuat& A, const FQuat& B, double Alpha) const
+	{
+		return bDeterministic ? FMoonshotDeterministicMath::Slerp(A, B, Alpha) : FQuat::Slerp(A, B, Alpha);
+	}
+
+	FVector GetSafeNormal(const FVector& V) const
+	{
+		return bDeterministic ? FMoonshotDeterministicMath::GetSafeNormal(V) : V.GetSafeNormal();
+	}
+
+	bool IsDeterministic() const { return bDeterministic; }
+
+private:
+	bool bDeterministic;
+};
@@ -0,0 +1,151 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MoonshotMoverUtils.h"
+#include "Mover/Public/MoverComponent.h"
+#include "Mover/Public/MoveLibrary/FloorQueryUtils.h"
+#include "Mover/Public/MoveLibrary/MovementUtils.h"
+
+/**
+ * Mode traits for TMoonshotFallAlongSurface. A traits type supplies the floor query policy of a movement mode:
+ *   static bool IsHitSurfaceWalkable(const FHitResult&, float MaxWalkSlopeCosine, const USceneComponent* UpdatedComponent)
+ *   static void FindFloor(const USceneComponent*, const UPrimitiveComponent*, float FloorSweepDistance, float MaxWalkSlopeCosine, const FVector& Location, FFloorCheckResult&)
+ */
+
+// ZeroG has no surface-relative up direction, so it judges landing spots with the stock (world Z) Mover floor queries
+struct FZeroGFallAlongSurfaceTraits
+{
+	static FORCEINLINE bool IsHitSurfaceWalkable(const FHitResult& Hit, float MaxWalkSlopeCosine, const USceneComponent* UpdatedComponent)
+	{
+		return UFloorQueryUtils::IsHitSurfaceWalkable(Hit, MaxWalkSlopeCosine);
+	}
+
+	static FORCEINLINE void FindFloor(const USceneComponent* UpdatedComponent, const UPrimitiveComponent* UpdatedPrimitive, float FloorSweepDistance, float MaxWalkSlopeCosine, const FVector& Location, FFloorCheckResult& OutFloorResult)
+	{
+		UFloorQueryUtils::FindFloor(UpdatedComponent, UpdatedPrimitive, FloorSweepDistance, MaxWalkSlopeCosine, Location, OutFloorResult);
+	}
+};
+
+// Attaching measures walkability against the updated component's up vector, so it can land on arbitrarily oriented surfaces
+struct FAttachingFallAlongSurfaceTraits
+{
+	static FORCEINLINE bool IsHitSurfaceWalkable(const FHitResult& Hit, float MaxWalkSlopeCosine, const USceneComponent* UpdatedComponent)
+	{
+		return UMoonshotMoverUtils::IsHitSurfaceWalkable(Hit, MaxWalkSlopeCosine, UpdatedComponent);
+	}
+
+	static FORCEINLINE void FindFloor(const USceneComponent* UpdatedComponent, const UPrimitiveComponent* UpdatedPrimitive, float FloorSweepDistance, float MaxWalkSlopeCosine, const FVector& Location, FFloorCheckResult& OutFloorResult)
+	{
+		UMoonshotMoverUtils::FindFloor(UpdatedComponent, UpdatedPrimitive, FloorSweepDistance, MaxWalkSlopeCosine, Location, OutFloorResult);
+	}
+};
+
+/**
+ * TMoonshotFallAlongSurface: the landing check and fall-slide kernel shared by the ZeroG and Attaching modes.
+ * The mode-specific floor queries come from ModeTraits, so each instantiation is fully inlined with no runtime policy branches.
+ */
+template<typename ModeTraits>
+struct TMoonshotFallAlongSurface
+{
+	static constexpr double SMALL_MOVE_DISTANCE = 1e-3;
+
+	// Checks if a hit result represents a walkable location that an actor can land on
+	static bool IsValidLandingSpot(USceneComponent* UpdatedComponent, UPrimitiveComponent* UpdatedPrimitive, const FVector& Location, const FHitResult& Hit, float FloorSweepDistance, float MaxWalkSlopeCosine, FFloorCheckResult& OutFloorResult)
+	{
+		OutFloorResult.Clear();
+
+		if (!Hit.bBlockingHit)
+		{
+			return false;
+		}
+
+		if (Hit.bStartPenetrating)
+		{
+			return false;
+		}
+
+		// Reject unwalkable floor normals.
+		if (!ModeTraits::IsHitSurfaceWalkable(Hit, MaxWalkSlopeCosine, UpdatedComponent))
+		{
+			return false;
+		}
+
+		// Make sure floor test passes here.
+		ModeTraits::FindFloor(UpdatedComponent, UpdatedPrimitive,
+			FloorSweepDistance, MaxWalkSlopeCosine,
+			Location, OutFloorResult);
+
+		return OutFloorResult.IsWalkableFloor();
+	}
+
+	/** Attempts to move a component along a surface, while checking for landing on a walkable surface. Returns the percent of time applied, with 0.0 meaning no movement occurred. */
+	static float TryMoveToFallAlongSurface(USceneComponent* UpdatedComponent, UPrimitiveComponent* UpdatedPrimitive, UMoverComponent* MoverComponent, const FVector& Delta, float PctOfDeltaToMove, const FQuat Rotation, const FVector& Normal, FHitResult& Hit, bool bHandleImpact, float FloorSweepDistance, float MaxWalkSlopeCosine, FFloorCheckResult& OutFloorResult, FMovementRecord& MoveRecord)
+	{
+		OutFloorResult.Clear();
+
+		if (!Hit.bBlockingHit)
+		{
+			return 0.f;
+		}
+
+		float PctOfTimeUsed = 0.f;
+		const FVector OldHitNormal = Normal;
+
+		FVector SlideDelta = UMovementUtils::ComputeSlideDelta(Delta, PctOfDeltaToMove, Normal, Hit);
+
+		if ((SlideDelta | Delta) <= 0.f)
+		{
+			return 0.f;
+		}
+
+		// First sliding attempt along surface
+		UMovementUtils::TrySafeMoveUpdatedComponent(UpdatedComponent, UpdatedPrimitive, SlideDelta, Rotation, true, Hit, ETeleportType::None, MoveRecord);
+
+		PctOfTimeUsed = Hit.Time;
+		if (Hit.IsValidBlockingHit())
+		{
+			// Notify first impact
+			if (MoverComponent && bHandleImpact)
+			{
+				FMoverOnImpactParams ImpactParams(NAME_None, Hit, SlideDelta);
+				MoverComponent->HandleImpact(ImpactParams);
+			}
+
+			// Check if we landed
+			if (!IsValidLandingSpot(UpdatedComponent, UpdatedPrimitive, UpdatedPrimitive->GetComponentLocation(),
+				Hit, FloorSweepDistance, MaxWalkSlopeCosine, OutFloorResult))
+			{
+				// We've hit another surface during our first move, so let's try to slide along both of them together
+
+				// Compute new slide normal when hitting multiple surfaces.
+				SlideDelta = UMovementUtils::ComputeTwoWallAdjustedDelta(SlideDelta, Hit, OldHitNormal);
+
+				// Only proceed if the new direction is of significant length and not in reverse of original attempted move.
+				if (!SlideDelta.IsNearlyZero(SMALL_MOVE_DISTANCE) && (SlideDelta | Delta) > 0.f)
+				{
+					// Perform second move, taking 2 walls into account
+					UMovementUtils::TrySafeMoveUpdatedComponent(UpdatedComponent, UpdatedPrimitive, SlideDelta, Rotation, true, Hit, ETeleportType::None, MoveRecord);
+					PctOfTimeUsed += (Hit.Time * (1.f - PctOfTimeUsed));
+
+					// Notify second impact
+					if (MoverComponent && bHandleImpact && Hit.bBlockingHit)
+					{
+						FMoverOnImpactParams ImpactParams(NAME_None, Hit, SlideDelta);
+						MoverComponent->HandleImpact(ImpactParams);
+					}
+
+					// Check if we've landed, to acquire floor result
+					IsValidLandingSpot(UpdatedComponent, UpdatedPrimitive, UpdatedPrimitive->GetComponentLocation(),
+						Hit, FloorSweepDistance, MaxWalkSlopeCosine, OutFloorResult);
+				}
+			}
+		}
+
+		return FMath::Clamp(PctOfTimeUsed, 0.f, 1.f);
+	}
+};
+
+using FZeroGFallAlongSurface = TMoonshotFallAlongSurface<FZeroGFallAlongSurfaceTraits>;
+using FAttachingFallAlongSurface = TMoonshotFallAlongSurface<FAttachingFallAlongSurfaceTraits>;
@@ -0,0 +1,110 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MoonshotMoverDataModelTypes.h"
+
+class UPackageMap;
+class UMoverBlackboard;
+class UMoverComponent;
+struct FMoverTimeStep;
+
+/**
+ * FMoonshotMoverInputBaselines: per-connection input history, keyed by FMoonshotMoverCharacterInputs::InputSequence.
+ *
+ * The sender keeps the last NumSlots commands it produced and the receiver the last NumSlots it decoded, both keyed by the
+ * connection's package map. The receiving side acknowledges the newest sequence it decoded (see
+ * AMoonshotBasePlayerController::ClientAckInputBaseline). The sender uses the acked command as the delta baseline, and resends
+ * the unacknowledged commands before it as a redundant window, so a lost packet's commands still reach the server.
+ * Without a recent ack the sender writes a full keyframe.
+ *
+ * Sequences are 8 bits on the wire. Both ends widen them to a full count, taking the wire sequence nearest the newest
+ * one they hold, and only accept slots and acks within NumSlots of that newest. Otherwise a command from 256 sequences
+ * earlier could be taken for the current one once the 8 bits wrap. The receiver cannot place a sequence after a long
+ * gap (over MaxReceiveGapSeconds without a command, or a command more than NumSlots behind the newest), so it drops its
+ * history and starts again from that command.
+ *
+ * State is per connection, not per pawn: this assumes one autonomous Mover pawn per connection, which is how Moonshot plays.
+ * Only the autonomous client-to-server stream is acked. Anything serialized without acks (simulated proxy inputs, replays)
+ * always goes out as keyframes with no redundant window, since the per-connection history would hold other pawns' commands.
+ */
+struct MOONSHOTMOVER_API FMoonshotMoverInputBaselines
+{
+	static constexpr int32 NumSlots = 64;
+	static constexpr int32 SequenceBits = 8;
+	static constexpr double MaxReceiveGapSeconds = 1.0;
+
+	// Signed distance from B to A in sequence space, so 2 is "newer" than 255
+	static int32 SequenceDelta(uint8 A, uint8 B) { return static_cast<int8>(static_cast<uint8>(A - B)); }
+
+	// Sender: remembers Inputs under their InputSequence as a possible baseline or redundant resend
+	static void RecordSent(const UPackageMap* Map, const FMoonshotMoverCharacterInputs& Inputs);
+
+	// Sender: command previously recorded for Sequence, if still held
+	static bool FindSent(const UPackageMap* Map, uint8 Sequence, FMoonshotMoverCharacterInputs& OutInputs);
+
+	// Sender: newest acknowledged command that is still recent enough to delta against, or false for a keyframe
+	static bool FindSendBaseline(const UPackageMap* Map, FMoonshotMoverCharacterInputs& OutBaseline, uint8& OutBaselineSequence);
+
+	// Sender: whether the receiver has acknowledged anything on this connection, i.e. this is the autonomous input stream
+	static bool HasAcknowledged(const UPackageMap* Map);
+
+	// Sender: the receiver has decoded Sequence
+	static void Acknowledge(const UPackageMap* Map, uint8 Sequence);
+
+	// Receiver: remembers decoded Inputs under Sequence. Older reordered commands never replace newer ones in the same slot.
+	static void RecordReceived(const UPackageMap* Map, uint8 Sequence, const FMoonshotMoverCharacterInputs& Inputs);
+
+	// Receiver: decoded command for Sequence, if still held
+	static bool FindReceivedBaseline(const UPackageMap* Map, uint8 Sequence, FMoonshotMoverCharacterInputs& OutBaseline);
+
+	// Receiver: full count for the wire Sequence, relative to the newest decoded command. Counts only ever go up.
+	static bool WidenReceivedSequence(const UPackageMap* Map, uint8 Sequence, int64& OutSequence);
+
+	// Receiver: decoded command for a full count from WidenReceivedSequence, if still held
+	static bool FindReceived(const UPackageMap* Map, int64 Sequence, FMoonshotMoverCharacterInputs& OutInputs);
+
+	// Receiver: newest decoded command still held, the fallback when a delta's baseline is gone
+	static bool FindNewestReceived(const UPackageMap* Map, FMoonshotMoverCharacterInputs& OutInputs, uint8& OutSequence);
+
+	// Receiver: newest decoded sequence that has not been acknowledged yet. Marks it as acknowledged.
+	static bool ConsumeSequenceToAcknowledge(const UPackageMap* Map, uint8& OutSequence);
+};
+
+/** Blackboard entry tracking which input sequence the server simulated last, for FMoonshotMoverInputRepair */
+struct FMoonshotMoverInputRepairState
+{
+	int32 ServerFrame = INDEX_NONE;
+
+	// Full count, see FMoonshotMoverInputBaselines::WidenReceivedSequence
+	int64 LastSequence = 0;
+	bool bHasLastSequence = false;
+	bool bUseRepaired = false;
+	FMoonshotMoverCharacterInputs Repaired;
+};
+
+/**
+ * FMoonshotMoverInputRepair: when a client's input packet is lost, Network Prediction repeats the previous command on the server,
+ * which desyncs the pawn and later costs the client a correction. If the missing command has since arrived in a later packet's
+ * redundant window, the server simulates that command instead.
+ */
+struct MOONSHOTMOVER_API FMoonshotMoverInputRepair
+{
+	struct FStats
+	{
+		// Repeated commands replaced by the real one from a redundant window
+		uint64 RepairedFrames = 0;
+
+		// Repeated commands that had to be simulated as is, each one likely to be corrected on the client
+		uint64 UnrepairedFrames = 0;
+	};
+
+	/**
+	 * Inputs the server should simulate this frame: Inputs itself, or OutRepairedStorage holding the command NP should have had.
+	 * Only does anything on the server for remotely controlled pawns. Stable within a sim frame, so GenerateMove and SimulationTick agree.
+	 */
+	static const FMoonshotMoverCharacterInputs* Resolve(const UMoverComponent* MoverComponent, UMoverBlackboard* SimBlackboard, const FMoverTimeStep& TimeStep, const FMoonshotMoverCharacterInputs* Inputs, FMoonshotMoverCharacterInputs& OutRepairedStorage);
+
+	static FStats GetStats();
+};
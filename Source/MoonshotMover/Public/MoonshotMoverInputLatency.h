@@ -0,0 +1,63 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Input latency instrumentation is compiled into development builds only. Only behavior depends on this, never the layout
+// of a type, so modules built with different values still agree on FMoonshotMoverCharacterInputs.
+#ifndef MOONSHOT_INPUT_LATENCY
+#define MOONSHOT_INPUT_LATENCY !UE_BUILD_SHIPPING
+#endif
+
+class UMoverComponent;
+struct FMoverTimeStep;
+
+/**
+ * When an input command's input happened, carried in FMoonshotMoverCharacterInputs. Local only: never serialized, so it is
+ * unset on the server and on anything rebuilt from the network. Never set in shipping builds.
+ */
+struct FMoonshotMoverInputLatencyStamp
+{
+	double InputEventSeconds = 0.0;	// FPlatformTime::Seconds() of the oldest input event folded into the command, 0 if none
+	double ProducedSeconds = 0.0;	// When the command was produced
+};
+
+/**
+ * FMoonshotMoverInputLatency: how long input takes to turn into movement on the controlling client, in stages:
+ * input event -> ProduceInput -> GenerateMove -> SimulationTick -> transform applied.
+ *
+ * The pawn stamps each command (FMoonshotMoverInputLatencyStamp) when it produces it, the modes mark GenerateMove, and
+ * FMoonshotMoverSimTickScope marks the start and end of the simulation tick. Only forward-simulated frames of stamped
+ * commands are measured. Visible through "stat MoonshotMover", as Insights counters under MoonshotMover/InputLatency, and
+ * through moonshot.Mover.InputLatency (averages and maxima since startup). All calls compile to nothing in shipping builds.
+ */
+struct MOONSHOTMOVER_API FMoonshotMoverInputLatency
+{
+	enum class EStage : uint8
+	{
+		ProduceInput,		// Input event -> command produced
+		GenerateMove,		// Command produced -> GenerateMove
+		SimulationTick,		// GenerateMove -> SimulationTick starts
+		TransformApplied,	// SimulationTick starts -> the mode has moved the component
+		Num
+	};
+
+	struct FStageStats
+	{
+		uint64 Count = 0;
+		double TotalMs = 0.0;
+		double MaxMs = 0.0;
+	};
+
+	// Stamps a command being produced, with the time of the oldest input event it carries (0 if it carries none)
+	static void MarkProduceInput(FMoonshotMoverInputLatencyStamp& Stamp, double InputEventSeconds);
+
+	// Called by the modes' OnGenerateMove with the inputs they consume
+	static void MarkGenerateMove(const UMoverComponent* MoverComponent, const FMoverTimeStep& TimeStep, const FMoonshotMoverInputLatencyStamp& Stamp);
+
+	static void MarkSimulationTick(const UMoverComponent* MoverComponent, int32 ServerFrame);
+	static void MarkTransformApplied(const UMoverComponent* MoverComponent, int32 ServerFrame);
+
+	static FStageStats GetStats(EStage Stage);
+};
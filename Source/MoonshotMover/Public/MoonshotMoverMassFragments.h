@@ -0,0 +1,89 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MassEntityTypes.h"
+#include "Engine/EngineTypes.h"
+#include "MoonshotMoverCommonMovementSettings.h"
+#include "MoonshotMoverMassFragments.generated.h"
+
+/**
+ * Mass versions of the Moonshot movement modes. Players keep the full Mover path; background crews and EVA traffic
+ * run as entities whose current mode is a tag, so each mode processor only ever sees chunks of its own mode.
+ */
+UENUM(BlueprintType)
+enum class EMoonshotMassMoverMode : uint8
+{
+	None,
+	ZeroG,
+	Attaching,
+	SurfaceWalking
+};
+
+USTRUCT() struct MOONSHOTMOVER_API FMoonshotMassZeroGTag : public FMassTag { GENERATED_BODY() };
+USTRUCT() struct MOONSHOTMOVER_API FMoonshotMassAttachingTag : public FMassTag { GENERATED_BODY() };
+USTRUCT() struct MOONSHOTMOVER_API FMoonshotMassSurfaceWalkingTag : public FMassTag { GENERATED_BODY() };
+
+// Per-entity movement input, written by whatever drives the NPC (StateTree task, crowd processor, ...). Mirrors FMoonshotMoverCharacterInputs.
+USTRUCT()
+struct MOONSHOTMOVER_API FMoonshotMassMoverInputFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	// World space move input, magnitude 0-1
+	UPROPERTY(EditAnywhere, Category = Mover)
+	FVector MoveInput = FVector::ZeroVector;
+
+	// Look input for ZeroG, same units as FMoonshotMoverCharacterInputs::AngularVelocity
+	UPROPERTY(EditAnywhere, Category = Mover)
+	FRotator AngularVelocity = FRotator::ZeroRotator;
+
+	// World space facing direction while attached or walking. Zero keeps the current facing.
+	UPROPERTY(EditAnywhere, Category = Mover)
+	FVector OrientationIntent = FVector::ZeroVector;
+
+	// Gravity while attaching/walking. Zero means "toward the surface below".
+	UPROPERTY(EditAnywhere, Category = Mover)
+	FVector GravityAcceleration = FVector::ZeroVector;
+
+	// Brakes in ZeroG, jumps when walking
+	UPROPERTY(EditAnywhere, Category = Mover)
+	bool bIsJumpPressed = false;
+
+	// Mode change request, consumed (reset to None) by the processor of the current mode. Equivalent of SuggestedMovementMode.
+	UPROPERTY(EditAnywhere, Category = Mover)
+	EMoonshotMassMoverMode RequestedMode = EMoonshotMassMoverMode::None;
+};
+
+// Per-entity simulation state that FTransformFragment does not cover
+USTRUCT()
+struct MOONSHOTMOVER_API FMoonshotMassMoverStateFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere, Category = Mover)
+	FVector Velocity = FVector::ZeroVector;
+
+	// Normal of the surface being attached to / walked on
+	UPROPERTY(VisibleAnywhere, Category = Mover)
+	FVector SurfaceNormal = FVector::UpVector;
+};
+
+// Movement settings shared by every entity spawned from the same config
+USTRUCT()
+struct MOONSHOTMOVER_API FMoonshotMassMoverSettingsFragment : public FMassConstSharedFragment
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, Category = Mover)
+	TObjectPtr<const UMoonshotMoverCommonMovementSettings> CommonMovementSettings = nullptr;
+
+	// Same meaning as UMoonshotMoverAttachingMode::AirControlPercentage
+	UPROPERTY(EditAnywhere, Category = Mover, meta = (ClampMin = "0", ClampMax = "1.0"))
+	float AirControlPercentage = 0.4f;
+
+	// Channel for the single surface trace each attached/walking entity does per tick
+	UPROPERTY(EditAnywhere, Category = Mover)
+	TEnumAsByte<ECollisionChannel> SurfaceTraceChannel = ECC_Visibility;
+};
@@ -0,0 +1,65 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MassProcessor.h"
+#include "MassEntityQuery.h"
+#include "MoonshotMoverZeroGBatch.h"
+#include "MoonshotMoverMassProcessors.generated.h"
+
+/**
+ * Mass processors running the Moonshot movement modes over chunks of entities. They reuse the same math as the Mover modes,
+ * but entities have no collision primitive: surface contact comes from one line trace per entity per tick, and ZeroG is collision-free.
+ */
+
+/** ZeroG for entities tagged FMoonshotMassZeroGTag, integrated a chunk at a time through UZeroGModeUtils::ComputeControlledFreeMoveBatch */
+UCLASS()
+class MOONSHOTMOVER_API UMoonshotMassZeroGProcessor : public UMassProcessor
+{
+	GENERATED_BODY()
+
+public:
+	UMoonshotMassZeroGProcessor();
+
+protected:
+	virtual void ConfigureQueries() override;
+	virtual void Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context) override;
+
+	FMassEntityQuery EntityQuery;
+
+	// Reused between chunks to avoid reallocating the lanes every tick
+	FZeroGModeBatch Batch;
+};
+
+/** Attaching (falling toward a surface) for entities tagged FMoonshotMassAttachingTag */
+UCLASS()
+class MOONSHOTMOVER_API UMoonshotMassAttachingProcessor : public UMassProcessor
+{
+	GENERATED_BODY()
+
+public:
+	UMoonshotMassAttachingProcessor();
+
+protected:
+	virtual void ConfigureQueries() override;
+	virtual void Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context) override;
+
+	FMassEntityQuery EntityQuery;
+};
+
+/** Surface walking for entities tagged FMoonshotMassSurfaceWalkingTag */
+UCLASS()
+class MOONSHOTMOVER_API UMoonshotMassSurfaceWalkingProcessor : public UMassProcessor
+{
+	GENERATED_BODY()
+
+public:
+	UMoonshotMassSurfaceWalkingProcessor();
+
+protected:
+	virtual void ConfigureQueries() override;
+	virtual void Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context) override;
+
+	FMassEntityQuery EntityQuery;
+};
@@ -0,0 +1,33 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MassEntityTraitBase.h"
+#include "MoonshotMoverMassFragments.h"
+#include "MoonshotMoverMassTrait.generated.h"
+
+/**
+ * Adds Moonshot movement (ZeroG, Attaching, SurfaceWalking) to a Mass entity config.
+ */
+UCLASS(meta = (DisplayName = "Moonshot Mover"))
+class MOONSHOTMOVER_API UMoonshotMoverMassTrait : public UMassEntityTraitBase
+{
+	GENERATED_BODY()
+
+protected:
+	virtual void BuildTemplate(FMassEntityTemplateBuildContext& BuildContext, const UWorld& World) const override;
+
+	// Settings shared by all entities of this config. Class defaults are used when unset.
+	UPROPERTY(EditAnywhere, Instanced, Category = Mover)
+	TObjectPtr<UMoonshotMoverCommonMovementSettings> MovementSettings;
+
+	UPROPERTY(EditAnywhere, Category = Mover, meta = (ClampMin = "0", ClampMax = "1.0"))
+	float AirControlPercentage = 0.4f;
+
+	UPROPERTY(EditAnywhere, Category = Mover)
+	TEnumAsByte<ECollisionChannel> SurfaceTraceChannel = ECC_Visibility;
+
+	UPROPERTY(EditAnywhere, Category = Mover)
+	EMoonshotMassMoverMode StartingMode = EMoonshotMassMoverMode::ZeroG;
+};
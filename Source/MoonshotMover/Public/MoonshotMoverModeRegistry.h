@@ -0,0 +1,89 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/ScopeRWLock.h"
+
+/**
+ * FMoonshotMoverModeHandle: small integer ID for a movement mode name, resolved once through FMoonshotMoverModeRegistry.
+ * Comparing handles is a single byte compare, and built-in modes can be sent over the network in NumBits bits.
+ */
+struct MOONSHOTMOVER_API FMoonshotMoverModeHandle
+{
+	static constexpr uint8 InvalidIndex = 0;
+
+	constexpr FMoonshotMoverModeHandle() = default;
+	explicit constexpr FMoonshotMoverModeHandle(uint8 InIndex) : Index(InIndex) {}
+
+	constexpr bool IsValid() const { return Index != InvalidIndex; }
+	constexpr uint8 GetIndex() const { return Index; }
+
+	// Name this handle was registered with. NAME_None for the invalid handle.
+	FName GetName() const;
+
+	// Handle registered for ModeName, or the invalid handle if it was never registered
+	static FMoonshotMoverModeHandle Find(FName ModeName);
+
+	/**
+	 * Serializes a mode name compactly: built-in modes as their fixed index, anything else as an escape index followed by the full name.
+	 * Dynamic indices are per-process, so they are never written on their own.
+	 */
+	static void NetSerializeModeName(FArchive& Ar, FName& ModeName);
+
+	constexpr bool operator==(const FMoonshotMoverModeHandle& Other) const { return Index == Other.Index; }
+	constexpr bool operator!=(const FMoonshotMoverModeHandle& Other) const { return Index != Other.Index; }
+
+	friend uint32 GetTypeHash(const FMoonshotMoverModeHandle& Handle) { return Handle.Index; }
+
+private:
+	uint8 Index = InvalidIndex;
+};
+
+// Built-in modes have fixed handles, identical on every machine
+namespace MoonshotModeHandles
+{
+	inline constexpr FMoonshotMoverModeHandle None(0);
+	inline constexpr FMoonshotMoverModeHandle Walking(1);
+	inline constexpr FMoonshotMoverModeHandle Falling(2);
+	inline constexpr FMoonshotMoverModeHandle Flying(3);
+	inline constexpr FMoonshotMoverModeHandle Swimming(4);
+	inline constexpr FMoonshotMoverModeHandle ZeroG(5);
+
+	inline constexpr uint8 NumBuiltIn = 6;
+}
+
+namespace MoonshotModeNames
+{
+	const FName ZeroG = TEXT("ZeroG");
+}
+
+/**
+ * FMoonshotMoverModeRegistry: process-wide table of movement mode names. Built-in modes occupy fixed indices;
+ * any other mode name gets the next free index the first time it is registered (modes register themselves in OnRegistered).
+ */
+class MOONSHOTMOVER_API FMoonshotMoverModeRegistry
+{
+public:
+	static constexpr int32 MaxModes = 32;
+	static constexpr int32 NumBits = 5;	// Enough for MaxModes
+	static constexpr uint8 EscapeIndex = MaxModes - 1;	// Marks a full FName following on the wire
+
+	static FMoonshotMoverModeRegistry& Get();
+
+	// Returns the existing handle for ModeName, or assigns a new one
+	FMoonshotMoverModeHandle Register(FName ModeName);
+
+	FMoonshotMoverModeHandle Find(FName ModeName) const;
+
+	FName GetName(FMoonshotMoverModeHandle Handle) const;
+
+	int32 Num() const;
+
+private:
+	FMoonshotMoverModeRegistry();
+
+	mutable FRWLock Lock;
+	TArray<FName, TFixedAllocator<MaxModes>> Names;
+	TMap<FName, uint8> NameToIndex;
+};
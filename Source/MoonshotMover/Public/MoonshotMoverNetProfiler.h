@@ -0,0 +1,63 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UPackageMap;
+struct FMoverDefaultSyncState;
+
+/**
+ * FMoonshotMoverNetProfiler: opt-in attribution of net bits to the fields of MoonshotMover structs (moonshot.Mover.NetProfile).
+ *
+ * NetSerialize implementations open an FStructScope and wrap each field in an FFieldScope; bits are counted per connection,
+ * direction, struct and field, in buckets of 60 sim frames (see SetSimFrame). Struct scopes nest (a redundant input command is its own struct inside
+ * the input), and a struct's "(total)" row includes everything nested in it. Engine structs we do not serialize ourselves,
+ * like FMoverDefaultSyncState, are sampled by serializing a copy (SampleSyncState), so they only get a total.
+ *
+ * moonshot.Mover.NetProfileDump writes everything to a CSV in the profiling directory, sorted so runs can be diffed.
+ * Connections are labelled ConnectionN in the order they are first seen since the last Reset.
+ * Only measures archives that are bit streams (FBitWriter/FBitReader); everything else is ignored.
+ */
+struct MOONSHOTMOVER_API FMoonshotMoverNetProfiler
+{
+	struct MOONSHOTMOVER_API FStructScope
+	{
+		FStructScope(FArchive& Ar, const UPackageMap* Map, const TCHAR* StructName);
+		~FStructScope();
+
+	private:
+		friend struct FFieldScope;
+
+		FArchive* Ar = nullptr;
+		const UPackageMap* Map = nullptr;
+		const TCHAR* StructName = nullptr;
+		int64 StartBits = 0;
+		FStructScope* Outer = nullptr;
+	};
+
+	// Attributes the bits serialized during its lifetime to FieldName of the innermost open struct scope
+	struct MOONSHOTMOVER_API FFieldScope
+	{
+		FFieldScope(FArchive& Ar, const TCHAR* FieldName);
+		~FFieldScope();
+
+	private:
+		FStructScope* Struct = nullptr;
+		const TCHAR* FieldName = nullptr;
+		int64 StartBits = 0;
+	};
+
+	static bool IsEnabled();
+
+	// Moves recording on to the bucket holding ServerFrame. Fed by FMoonshotMoverSimTickScope on forward ticks.
+	static void SetSimFrame(int32 ServerFrame);
+
+	// Records what SyncState costs on the wire, measured by serializing a copy with no connection
+	static void SampleSyncState(const FMoverDefaultSyncState& SyncState);
+
+	// Writes every recorded bucket and the totals as CSV. Returns false if the file could not be written.
+	static bool WriteCsv(const FString& Filename);
+
+	static void Reset();
+};
@@ -0,0 +1,55 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FLayeredMoveBase;
+
+/**
+ * FMoonshotMoverNetQuantize: compact wire encodings for Moonshot input and state.
+ * Each function reads or writes depending on Ar.IsLoading(), like the engine's SerializePackedVector family.
+ */
+struct MOONSHOTMOVER_API FMoonshotMoverNetQuantize
+{
+	// Bits per axis for octahedral unit vectors. 12 bits keeps the angular error under 0.05 degrees.
+	static constexpr int32 OctahedralBitsPerAxis = 12;
+
+	// Gravity magnitude the modes fall back to when no gravity is supplied, sent as a 2-bit index
+	static constexpr float StandardGravityMagnitude = 980.f;
+
+	// Direction only. Zero vectors encode as +Z; callers send a zero flag first if zero is meaningful.
+	static void SerializeOctahedralUnitVector(FArchive& Ar, FVector& InOutDirection, int32 BitsPerAxis = OctahedralBitsPerAxis);
+
+	/**
+	 * Gravity as a 2-bit magnitude index (zero / standard / 0.1 cm/s^2 fixed point / full float) plus an octahedral direction.
+	 * A typical "standard gravity along some surface normal" costs 26 bits instead of ~60 for SerializePackedVector<100, 30>.
+	 */
+	static void SerializeGravity(FArchive& Ar, FVector& InOutGravity);
+
+	/**
+	 * Rotation as pitch and yaw relative to the frame whose up is -Gravity, plus a roll only when it is non-zero in that frame.
+	 * With zero gravity the frame is world space. If sender and receiver pass slightly different gravity (e.g. before and after
+	 * SerializeGravity), the decoded rotation is off by at most the angle between the two gravity directions.
+	 */
+	static void SerializeGravityRelativeRotation(FArchive& Ar, FRotator& InOutRotation, const FVector& Gravity);
+
+	// One bit when the rotator is zero, otherwise FRotator::SerializeCompressedShort
+	static void SerializeRotatorWithZeroFlag(FArchive& Ar, FRotator& InOutRotator);
+
+	// One bit when the vector is zero, otherwise an octahedral direction and, if it is not unit length, its size
+	static void SerializeDirectionWithZeroFlag(FArchive& Ar, FVector& InOutVector);
+
+	/**
+	 * Lossless, packed version of FLayeredMoveBase::NetSerialize for Moonshot layered moves: mix mode in 2 bits, priority
+	 * behind a zero flag, and duration as a 2-bit kind (zero / whole milliseconds in 16 bits / full float).
+	 */
+	static void SerializeLayeredMoveBase(FArchive& Ar, FLayeredMoveBase& InOutMove);
+
+	/** A value from Table as a MaxTableBits-bit index, with one escape bit for values that are not in it exactly (sent in full) */
+	static constexpr int32 MaxTableBits = 4;
+	static void SerializeTableValue(FArchive& Ar, float& InOutValue, TConstArrayView<float> Table);
+
+	// Rotation from the frame whose up is -Gravity into world space. Identity for zero gravity.
+	static FQuat GetGravityFrame(const FVector& Gravity);
+};
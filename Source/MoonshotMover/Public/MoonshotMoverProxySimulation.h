@@ -0,0 +1,35 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UMoverBlackboard;
+class UMoverComponent;
+class UMoonshotMoverCommonMovementSettings;
+class UPrimitiveComponent;
+class USceneComponent;
+struct FMoverDefaultSyncState;
+struct FProposedMove;
+
+/**
+ * FMoonshotMoverProxySimulation: the cheap path the Moonshot modes take for simulated proxies nobody is looking at closely.
+ *
+ * A proxy's state is overwritten by every server update, so between updates it only needs to look plausible. Proxies far
+ * from every local player's view, and not on screen, skip the mode's move generation, floor queries, step-ups and slides.
+ * They just integrate the replicated velocity and the last replicated input's angular velocity without collision. Authoritative updates are
+ * blended in the same way as for full-sim proxies: Network Prediction restarts from the server state and Mover's smoothing
+ * hides the jump.
+ */
+struct MOONSHOTMOVER_API FMoonshotMoverProxySimulation
+{
+	// True when MoverComponent is a simulated proxy far enough from every local player's view, and not rendered close enough, to skip collision.
+	// Gives the same answer in OnGenerateMove and OnSimulationTick of one frame.
+	static bool ShouldExtrapolate(const UMoverComponent* MoverComponent, const UPrimitiveComponent* UpdatedPrimitive, const FMoverDefaultSyncState& StartSyncState, const UMoonshotMoverCommonMovementSettings& Settings);
+
+	// Proposed move for a proxy that ShouldExtrapolate, in place of the mode's own: the replicated velocity, turning at AngularVelocity
+	static void GenerateMove(const FMoverDefaultSyncState& StartSyncState, const FRotator& AngularVelocity, FProposedMove& OutProposedMove);
+
+	// Moves UpdatedComponent by ProposedMove without sweeping and captures the result. Drops cached floors so a return to full sim queries fresh.
+	static void Extrapolate(USceneComponent* UpdatedComponent, const FMoverDefaultSyncState& StartSyncState, const FProposedMove& ProposedMove, float DeltaSeconds, const UMoonshotMoverCommonMovementSettings& Settings, UMoverBlackboard* SimBlackboard, FMoverDefaultSyncState& OutputSyncState);
+};
@@ -0,0 +1,66 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+
+DECLARE_STATS_GROUP(TEXT("MoonshotMover"), STATGROUP_MoonshotMover, STATCAT_Advanced);
+
+struct FMoverDefaultSyncState;
+struct FMoverTimeStep;
+class UMoverComponent;
+
+/**
+ * FMoonshotMoverSimTelemetry: how often Moonshot pawns are corrected and what the resulting resimulation costs.
+ *
+ * Fed by FMoonshotMoverSimTickScope in every mode's OnSimulationTick. A correction is counted when a component's ticks switch
+ * to resimulating (or jump back in time while resimulating), and its error is the distance between the corrected start state
+ * and what we had predicted for that frame. Visible through "stat MoonshotMover", moonshot.Mover.LogSimTelemetry (once a
+ * second) and moonshot.Mover.SimTelemetry (totals). Game thread only, like the simulation itself.
+ * Off in shipping builds, and switchable with moonshot.Mover.EnableSimTelemetry; a scope that is not tracking costs nothing.
+ */
+struct MOONSHOTMOVER_API FMoonshotMoverSimTelemetry
+{
+	struct FStats
+	{
+		uint64 Corrections = 0;
+		uint64 ReducedCostCorrections = 0;	// Corrections whose resim was over budget, see FMoonshotMoverSimTickScope::IsReducedCost
+		uint64 ForwardFrames = 0;
+		uint64 ResimFrames = 0;
+		double ForwardTickMs = 0.0;			// Time spent in OnSimulationTick while simulating forward
+		double ResimTickMs = 0.0;			// Time spent in OnSimulationTick while resimulating
+		double TotalErrorCm = 0.0;			// Summed over the corrections that had a prediction to compare against
+		double MaxErrorCm = 0.0;
+		uint64 MeasuredCorrections = 0;
+	};
+
+	static FStats GetStats();
+};
+
+/**
+ * FMoonshotMoverSimTickScope: put at the top of OnSimulationTick, once the output sync state exists. Times the tick and, on
+ * destruction, remembers the output as our prediction for the frame so a later correction can be measured against it.
+ *
+ * ResimBudgetMs (UMoonshotMoverCommonMovementSettings) caps the estimated cost of one correction's resimulation. Network
+ * Prediction owns rollback, so an over-budget resim still runs, but IsReducedCost() asks the mode to take its cheapest path
+ * for the rest of that resim; the remaining pop is left to Mover's smoothing. SurfaceWalking skips the floor search for a
+ * pawn standing on static geometry, and ZeroG and Attaching skip adaptive substepping.
+ */
+struct MOONSHOTMOVER_API FMoonshotMoverSimTickScope
+{
+	FMoonshotMoverSimTickScope(const UMoverComponent* MoverComponent, const FMoverTimeStep& TimeStep, const FMoverDefaultSyncState& StartSyncState, const FMoverDefaultSyncState& OutputSyncState, float ResimBudgetMs);
+	~FMoonshotMoverSimTickScope();
+
+	bool IsReducedCost() const { return bReducedCost; }
+
+private:
+	const UMoverComponent* MoverComponent;
+	const FMoverDefaultSyncState& OutputSyncState;
+	int32 ServerFrame;
+	uint64 StartCycles;
+	bool bIsResimulating;
+	FScopeCycleCounter CycleCounter;
+	bool bIsTracking = false;
+	bool bReducedCost = false;
+};
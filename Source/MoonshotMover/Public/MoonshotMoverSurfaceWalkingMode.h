@@ -193,8 +193,12 @@ struct MOONSHOTMOVER_API FLayeredMove_SurfaceWalkingModeJumpImpulse : public FLa
 
 	virtual FLayeredMoveBase* Clone() const override;
 
+	// Packed: see FMoonshotMoverNetQuantize::SerializeLayeredMoveBase, with the speed as an index into NetJumpSpeedTable when listed there
 	virtual void NetSerialize(FArchive& Ar) override;
 
+	// Same encoding, for when the move is serialized as a property
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+
 	virtual UScriptStruct* GetScriptStruct() const override;
 
 	virtual FString ToSimpleString() const override;
@@ -207,7 +211,7 @@ struct TStructOpsTypeTraits< FLayeredMove_SurfaceWalkingModeJumpImpulse > : publ
 {
 	enum
 	{
-		//WithNetSerializer = true,
+		WithNetSerializer = true,
 		WithCopy = true
 	};
 };
\ No newline at end of file
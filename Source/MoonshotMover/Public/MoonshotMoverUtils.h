@@ -23,12 +23,18 @@ public:
     UFUNCTION(BlueprintCallable, Category=Mover)
 	static bool IsHitSurfaceWalkable(const FHitResult& Hit, float MaxWalkSlopeCosine, const USceneComponent* UpdatedComponent);
 
+	/** Same as IsHitSurfaceWalkable, for callers without a scene component (e.g. Mass entities) that track their own up direction */
+	static bool IsHitSurfaceWalkableForUp(const FHitResult& Hit, float MaxWalkSlopeCosine, const FVector& ComponentUp);
+
 	/**
 	 * Return true if the 2D distance to the impact point is inside the edge tolerance (CapsuleRadius minus a small rejection threshold).
 	 * Useful for rejecting adjacent hits when finding a floor or landing spot.
 	 */
 	static bool IsWithinEdgeTolerance(const FVector& CapsuleLocation, const FVector& TestImpactPoint, float CapsuleRadius);
 
+	/** Number of substeps (at least 1, at most MaxSubsteps) needed so no single sweep of MoveDelta covers more than RadiusFraction of the collider radius */
+	static int32 ComputeNumSubsteps(const FVector& MoveDelta, const UPrimitiveComponent* UpdatedPrimitive, float RadiusFraction, int32 MaxSubsteps);
+
     static constexpr float MIN_FLOOR_DIST = 1.9f;
 	static constexpr float MAX_FLOOR_DIST = 2.4f;
 	static constexpr float SWEEP_EDGE_REJECT_DISTANCE = 0.15f;
@@ -0,0 +1,49 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MoonshotMoverZeroGMode.h"
+
+struct FProposedMove;
+
+/**
+ * FZeroGModeBatch: structure-of-arrays input/output for UZeroGModeUtils::ComputeControlledFreeMoveBatch.
+ * Each array holds one lane per mover. Arrays are padded to a multiple of LaneWidth; padding lanes are idle and produce zero moves.
+ * Vector members are stored per component in FVector::FReal precision so results match UZeroGModeUtils::ComputeControlledFreeMove bit for bit.
+ */
+struct MOONSHOTMOVER_API FZeroGModeBatch
+{
+	static constexpr int32 LaneWidth = 4;
+
+	/** Resizes the batch to hold InNum movers. Newly added and padding lanes are zeroed. */
+	void SetNum(int32 InNum);
+
+	int32 Num() const { return NumMovers; }
+	int32 GetPaddedNum() const { return MaxSpeed.Num(); }
+
+	/** Copies the inputs the batched integrator consumes from a scalar params struct into lane Index */
+	void SetMover(int32 Index, const FZeroGModeParams& Params);
+
+	/** Builds a proposed move from the outputs of lane Index, equivalent to what ComputeControlledFreeMove would return */
+	FProposedMove GetProposedMove(int32 Index) const;
+
+	// Inputs
+	TArray<FVector::FReal> MoveInputX, MoveInputY, MoveInputZ;
+	TArray<FVector::FReal> PriorVelocityX, PriorVelocityY, PriorVelocityZ;
+	TArray<FRotator::FReal> AngularVelocityPitch, AngularVelocityYaw, AngularVelocityRoll;
+	TArray<float> MaxSpeed;
+	TArray<float> Acceleration;
+	TArray<float> Deceleration;
+	TArray<float> TurningRate;
+	TArray<float> DeltaSeconds;
+
+	// Outputs
+	TArray<FVector::FReal> DirectionIntentX, DirectionIntentY, DirectionIntentZ;
+	TArray<uint8> bHasDirIntent;
+	TArray<FVector::FReal> LinearVelocityX, LinearVelocityY, LinearVelocityZ;
+	TArray<FRotator::FReal> OutAngularVelocityPitch, OutAngularVelocityYaw, OutAngularVelocityRoll;
+
+private:
+	int32 NumMovers = 0;
+};
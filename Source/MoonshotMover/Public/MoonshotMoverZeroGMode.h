@@ -9,6 +9,7 @@
 #include "MoonshotMoverZeroGMode.generated.h"
 
 struct FProposedMove;
+struct FZeroGModeBatch;
 
 UCLASS(Blueprintable, BlueprintType)
 class MOONSHOTMOVER_API UMoonshotMoverZeroGMode : public UBaseMovementMode
@@ -207,7 +208,10 @@ public:
 	/** Generate a new movement based on move/orientation intents and the prior state, unconstrained like when flying */
 	UFUNCTION(BlueprintCallable, Category = Mover)
 	static FProposedMove ComputeControlledFreeMove(const FZeroGModeParams& InParams,  FTransform OwnerTransform, UWorld* World);
-	
+
+	/** Batched SIMD version of ComputeControlledFreeMove for many movers at once (drone swarms, debris). Results are bit-compatible with the scalar path. */
+	static void ComputeControlledFreeMoveBatch(FZeroGModeBatch& Batch);
+
     // Checks if a hit result represents a walkable location that an actor can land on
     UFUNCTION(BlueprintCallable, Category=Mover)
     static bool IsValidLandingSpot(USceneComponent* UpdatedComponent, UPrimitiveComponent* UpdatedPrimitive, const FVector& Location, const FHitResult& Hit, float FloorSweepDistance, float MaxWalkSlopeCosine, FFloorCheckResult& OutFloorResult);
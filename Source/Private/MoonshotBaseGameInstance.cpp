@@ -2,6 +2,22 @@
 
 
 #include "MoonshotBaseGameInstance.h"
+#include "MoonshotNetSoak.h"
+
+void UMoonshotBaseGameInstance::Init()
+{
+    Super::Init();
+
+    // Only does anything in processes started by the network soak commandlet
+    FMoonshotNetSoak::Start(this);
+}
+
+void UMoonshotBaseGameInstance::Shutdown()
+{
+    FMoonshotNetSoak::Stop();
+
+    Super::Shutdown();
+}
 
 FString UMoonshotBaseGameInstance::GetPatchNotesFilePath()
 {
@@ -4,6 +4,9 @@
 #include "MoonshotBasePawn.h"
 #include "MoonshotMover/Public/MoonshotMoverDataModelTypes.h"
 #include "MoonshotBasePlayerController.h"
+#include "MoonshotGravityFrameComponent.h"
+#include "MoonshotInputModifier.h"
+#include "MoonshotNetSoak.h"
 #include "Components/InputComponent.h"
 #include "Engine/BlueprintGeneratedClass.h"
 #include "Engine/LocalPlayer.h"
@@ -15,6 +18,8 @@
 #include "GameFramework/PlayerController.h"
 #include "GameFramework/PlayerInput.h"
 #include "GameFramework/PhysicsVolume.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/App.h"
 #include "EnhancedInputComponent.h"
 #include "Kismet/BlueprintFunctionLibrary.h"
 #include "Kismet/KismetMathLibrary.h"
@@ -22,6 +27,22 @@
 #include "InputAction.h"
 
 static const FName Name_CharacterMotionComponent(TEXT("MoverComponent"));
+static const FName Name_GravityFrameComponent(TEXT("GravityFrame"));
+
+DECLARE_CYCLE_STAT(TEXT("Moonshot Input Modifiers"), STAT_MoonshotInputModifiers, STATGROUP_Game);
+DECLARE_CYCLE_STAT(TEXT("Moonshot Blueprint ProduceInput"), STAT_MoonshotBlueprintProduceInput, STATGROUP_Game);
+
+namespace MoonshotPawnInput
+{
+	// Longest span input is integrated over; anything older (a hitch, a pause) is skipped rather than replayed
+	constexpr double MaxIntegrationSeconds = 0.25;
+
+	// Input actions fire once per frame with the device state over that frame, so their values hold from the frame's start
+	double GetFrameStartSeconds()
+	{
+		return FPlatformTime::Seconds() - FApp::GetDeltaTime();
+	}
+}
 
 AMoonshotBasePawn::AMoonshotBasePawn(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
@@ -29,7 +50,7 @@ AMoonshotBasePawn::AMoonshotBasePawn(const FObjectInitializer& ObjectInitializer
 	CharacterMotionComponent = CreateDefaultSubobject<UCharacterMoverComponent>(Name_CharacterMotionComponent);
 	ensure(CharacterMotionComponent);
 
-	PrimaryActorTick.bCanEverTick = true;
+	GravityFrame = CreateDefaultSubobject<UMoonshotGravityFrameComponent>(Name_GravityFrameComponent);
 
 	SetReplicatingMovement(false);	// disable Actor-level movement replication, since our Mover component will handle it
 
@@ -43,6 +64,17 @@ AMoonshotBasePawn::AMoonshotBasePawn(const FObjectInitializer& ObjectInitializer
 	UFunction* ProduceInputFunction = GetClass()->FindFunctionByName(ProduceInputBPFuncName);
 	bHasProduceInputinBpFunc = IsImplementedInBlueprint(ProduceInputFunction);
 
+	static FName TickBPFuncName = FName(TEXT("ReceiveTick"));
+	bHasTickInBpFunc = IsImplementedInBlueprint(GetClass()->FindFunctionByName(TickBPFuncName));
+
+	// The pawn needs no per-frame work of its own, so the actor tick only exists for Event Tick in a Blueprint subclass
+	PrimaryActorTick.bCanEverTick = bHasTickInBpFunc;
+
+	// Enabled for locally controlled pawns only, see UpdateTickEnablement
+	SurfaceProbeTick.bCanEverTick = true;
+	SurfaceProbeTick.bStartWithTickEnabled = false;
+	SurfaceProbeTick.TickGroup = TG_PrePhysics;
+
 }
 
 void AMoonshotBasePawn::ResetCounter()
@@ -58,10 +90,86 @@ void AMoonshotBasePawn::IncrementCallCounter()
 }
 
 
-// Called every frame
-void AMoonshotBasePawn::Tick(float DeltaTime)
+void FMoonshotSurfaceProbeTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+	if (Target && IsValid(Target) && TickType != LEVELTICK_ViewportsOnly)
+	{
+		Target->UpdateSurfaceProbe();
+	}
+}
+
+FString FMoonshotSurfaceProbeTickFunction::DiagnosticMessage()
 {
-	Super::Tick(DeltaTime);
+	return Target ? Target->GetFullName() + TEXT("[SurfaceProbe]") : TEXT("<null>[SurfaceProbe]");
+}
+
+FName FMoonshotSurfaceProbeTickFunction::DiagnosticContext(bool bDetailed)
+{
+	return Target ? Target->GetClass()->GetFName() : NAME_None;
+}
+
+void AMoonshotBasePawn::RegisterActorTickFunctions(bool bRegister)
+{
+	Super::RegisterActorTickFunctions(bRegister);
+
+	if (bRegister)
+	{
+		if (SurfaceProbeTick.bCanEverTick)
+		{
+			SurfaceProbeTick.Target = this;
+			SurfaceProbeTick.SetTickFunctionEnable(SurfaceProbeTick.bStartWithTickEnabled || SurfaceProbeTick.IsTickFunctionEnabled());
+			SurfaceProbeTick.RegisterTickFunction(GetLevel());
+
+			// Probe before Event Tick too, which may read its results
+			PrimaryActorTick.AddPrerequisite(this, SurfaceProbeTick);
+		}
+	}
+	else if (SurfaceProbeTick.IsTickFunctionRegistered())
+	{
+		SurfaceProbeTick.UnRegisterTickFunction();
+	}
+}
+
+void AMoonshotBasePawn::NotifyControllerChanged()
+{
+	// The controller's input processing and UpdateRotation read the probe, so it goes first
+	if (PreviousController)
+	{
+		PreviousController->PrimaryActorTick.RemovePrerequisite(this, SurfaceProbeTick);
+	}
+	if (Controller)
+	{
+		Controller->PrimaryActorTick.AddPrerequisite(this, SurfaceProbeTick);
+	}
+
+	if (HasActorBegunPlay())
+	{
+		UpdateTickEnablement();
+	}
+
+	Super::NotifyControllerChanged();
+}
+
+void AMoonshotBasePawn::UpdateTickEnablement()
+{
+	// The probe only feeds input production and the local view. Servers simulating remote players and simulated proxies
+	// get their movement from the sim alone, and mode changes still arrive through OnMoverModeChanged.
+	const bool bShouldTick = IsLocallyControlled();
+
+	if (bShouldTick != SurfaceProbeTick.IsTickFunctionEnabled())
+	{
+		SurfaceProbeTick.SetTickFunctionEnable(bShouldTick);
+
+		// Whatever was found before is stale; the next probe reports the surface afresh
+		SurfaceProbeFrame = 0;
+	}
+}
+
+void AMoonshotBasePawn::UpdateSurfaceProbe()
+{
+	const bool bFirstProbe = SurfaceProbeFrame == 0;
+	const bool bHadSurface = bCanAttachToSurface;
+	SurfaceProbeFrame = GFrameCounter;
 
 	/// TODO: Replace this with a proper floor trace
     FHitResult HitResult;
@@ -74,18 +182,21 @@ void AMoonshotBasePawn::Tick(float DeltaTime)
         );
     AttachSurfaceNormal = HitResult.Normal;
 
-	if (!IsFlyingActive())
+	if (!bCanAttachToSurface && (bFirstProbe || bHadSurface))
 	{
-		if (!bCanAttachToSurface)
-		{
-			bShouldToggleFlying = true;
-		}
+		OnSurfaceLost();
 	}
 
-	UpdatePerspective(DeltaTime);
+	RefreshGravityFrame();
+}
 
-	FVector forward, right, up;
-	GetGravitySystemAxes(forward, right, up);
+void AMoonshotBasePawn::OnSurfaceLost()
+{
+	// Nothing to stand on: go ZeroG. Falling into a mode other than ZeroG later is caught in OnMoverModeChanged.
+	if (!IsFlyingActive())
+	{
+		bShouldEnterZeroG = true;
+	}
 }
 
 void AMoonshotBasePawn::BeginPlay()
@@ -110,6 +221,17 @@ void AMoonshotBasePawn::BeginPlay()
 
 	LookScaleToUse = LookInputScale;
 
+	UE_CLOG(bHasProduceInputinBpFunc && !bUseBlueprintProduceInput, LogTemp, Warning,
+		TEXT("%s implements On Produce Input but bUseBlueprintProduceInput is off, so it is not called. Enable it or move the logic to an input modifier."), *GetClass()->GetName());
+
+	if (CharacterMotionComponent)
+	{
+		CharacterMotionComponent->OnMovementModeChanged.AddUniqueDynamic(this, &AMoonshotBasePawn::OnMoverModeChanged);
+		CurrentModeHandle = FMoonshotMoverModeRegistry::Get().Register(CharacterMotionComponent->GetMovementModeName());
+	}
+
+	UpdateTickEnablement();
+
 	/// TODO: Remove debug timer
 	//GetWorld()->GetTimerManager().SetTimer(TimerHandle_Debug, this, &AMoonshotBasePawn::ResetCounter, 1.0f, true);
 }
@@ -157,28 +279,131 @@ bool AMoonshotBasePawn::FindSurfaceGravity(FVector& OutUnitGravity) const
 
 bool AMoonshotBasePawn::GetGravitySystemAxes(FVector& OutForward, FVector& OutRight, FVector& OutUp) const
 {
-	FMatrix GravMatrix = FRotationMatrix::Make(GravityQuat);
-
-	OutForward 	= GravMatrix.GetUnitAxis(EAxis::X);
-	OutRight 	= GravMatrix.GetUnitAxis(EAxis::Y);
-	OutUp 		= GravMatrix.GetUnitAxis(EAxis::Z);
+	if (GravityFrame)
+	{
+		OutForward 	= GravityFrame->GetForward();
+		OutRight 	= GravityFrame->GetRight();
+		OutUp 		= GravityFrame->GetUp();
+	}
+	else
+	{
+		OutForward 	= FVector::ForwardVector;
+		OutRight 	= FVector::RightVector;
+		OutUp 		= FVector::UpVector;
+	}
 
 	return bCanAttachToSurface;
 }
 
+FQuat AMoonshotBasePawn::GetGravityQuat() const
+{
+	return GravityFrame ? GravityFrame->GetFrameRotation() : FQuat::Identity;
+}
+
+void AMoonshotBasePawn::RefreshGravityFrame()
+{
+	if (!GravityFrame)
+	{
+		return;
+	}
+
+	// In ZeroG the frame turns with the pawn; on a surface gravity pulls into it
+	const FQuat ActorQuat = GetActorQuat();
+	FVector GravityDirection;
+	if (IsFlyingActive() || !FindSurfaceGravity(GravityDirection))
+	{
+		GravityDirection = -ActorQuat.GetUpVector();
+	}
+
+	GravityFrame->Update(GravityDirection, ActorQuat);
+}
+
 bool AMoonshotBasePawn::IsFlyingActive() const
 {
-	return GetMoverComponent()->GetMovementModeName() == "ZeroG";
+	return CurrentModeHandle == MoonshotModeHandles::ZeroG;
+}
+
+void AMoonshotBasePawn::AddInputModifier(UMoonshotInputModifier* Modifier)
+{
+	if (Modifier)
+	{
+		InputModifiers.AddUnique(Modifier);
+	}
+}
+
+void AMoonshotBasePawn::RemoveInputModifier(UMoonshotInputModifier* Modifier)
+{
+	InputModifiers.Remove(Modifier);
+}
+
+void AMoonshotBasePawn::OnMoverModeChanged(const FName& PreviousMovementModeName, const FName& NewMovementModeName)
+{
+	CurrentModeHandle = FMoonshotMoverModeRegistry::Get().Register(NewMovementModeName);
+
+	// Modes also switch on their own (Attaching drops into ZeroG when it loses the surface), so the toggle follows the sim
+	bIsFlyingActive = IsFlyingActive();
+
+	// Leaving ZeroG with no surface in reach goes straight back to it, the surface having been lost already
+	if (IsSurfaceProbeEnabled() && SurfaceProbeFrame != 0 && !bCanAttachToSurface && !IsFlyingActive())
+	{
+		bShouldEnterZeroG = true;
+	}
 }
 
 void AMoonshotBasePawn::ProduceInput_Implementation(int32 SimTimeMs, FMoverInputCmdContext& InputCmdResult)
 {
+#if !UE_BUILD_SHIPPING
+	if (FMoonshotNetSoak::IsScriptingInput())
+	{
+		// Network soak clients play from a script, fed through the same cached state the input actions set
+		const double PrevSeconds = SoakScriptSeconds;
+		SoakScriptSeconds += 0.001 * SimTimeMs;
+
+		const FMoonshotNetSoak::FScriptedInput Scripted = FMoonshotNetSoak::GetScriptedInput(PrevSeconds, SoakScriptSeconds);
+		CachedMoveInputIntent = Scripted.MoveIntent;
+		bIsJumpJustPressed = Scripted.bJumpPressed && !bIsJumpPressed;
+		bIsJumpPressed = Scripted.bJumpPressed;
+		bShouldToggleFlying |= Scripted.bToggleFlying;
+	}
+#endif
+
 	OnProduceInput((float)SimTimeMs, InputCmdResult);
 
-	if (bHasProduceInputinBpFunc)
+	if (InputModifiers.Num() > 0)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_MoonshotInputModifiers);
+
+		for (UMoonshotInputModifier* Modifier : InputModifiers)
+		{
+			if (Modifier && Modifier->bEnabled)
+			{
+				Modifier->ModifyInput(*this, (float)SimTimeMs, InputCmdResult);
+			}
+		}
+	}
+
+	if (bUseBlueprintProduceInput && bHasProduceInputinBpFunc)
 	{
+		SCOPE_CYCLE_COUNTER(STAT_MoonshotBlueprintProduceInput);
 		InputCmdResult = OnProduceInputInBlueprint((float)SimTimeMs, InputCmdResult);
 	}
+
+	// Stamped last so Blueprint overrides cannot disturb the sequence the server uses to spot lost commands
+	FMoonshotMoverCharacterInputs& CharacterInputs = InputCmdResult.InputCollection.FindOrAddMutableDataByType<FMoonshotMoverCharacterInputs>();
+	CharacterInputs.InputSequence = NextInputSequence++;
+
+	FMoonshotMoverInputLatency::MarkProduceInput(CharacterInputs.LatencyStamp, PendingInputEventSeconds);
+	PendingInputEventSeconds = 0.0;
+}
+
+void AMoonshotBasePawn::StampInputEvent()
+{
+#if MOONSHOT_INPUT_LATENCY
+	if (PendingInputEventSeconds == 0.0)
+	{
+		PendingInputEventSeconds = FPlatformTime::Seconds();
+	}
+#endif
 }
 
 /** Generate user commands to be fed into the Mover simulation this tick. 
@@ -212,7 +437,8 @@ void AMoonshotBasePawn::OnProduceInput(float DeltaMs, FMoverInputCmdContext& Out
 	//FQuat ControlRotationQuat = PC->GetControlRotation().Quaternion();
 	FQuat ControlRotationQuat = Boom->GetRelativeRotation().Quaternion();
 
-	FVector FinalDirectionalIntent = ControlRotationQuat.RotateVector(CachedMoveInputIntent);
+	const FVector MoveInputIntent = ConsumeMoveInput(DeltaMs);
+	FVector FinalDirectionalIntent = ControlRotationQuat.RotateVector(MoveInputIntent);
 	if (bCanAttachToSurface && (MoverComp->IsFalling() || MoverComp->IsOnGround()))
 	{
 		FinalDirectionalIntent = FVector::VectorPlaneProject(FinalDirectionalIntent, AttachSurfaceNormal).GetSafeNormal();
@@ -299,31 +525,31 @@ void AMoonshotBasePawn::OnProduceInput(float DeltaMs, FMoverInputCmdContext& Out
 		{
 			// Orient pawn with move direction
 			//ControlForward = PC->GetControlRotation().Quaternion().RotateVector(CachedMoveInputIntent);
-			ControlForward = Boom->GetRelativeRotation().Quaternion().RotateVector(CachedMoveInputIntent);
+			ControlForward = Boom->GetRelativeRotation().Quaternion().RotateVector(MoveInputIntent);
 			CharacterInputs.OrientationIntent = FMath::Lerp(GetActorForwardVector(), FVector::VectorPlaneProject(ControlForward, AttachSurfaceNormal).GetSafeNormal(), 1.0f);
 		}
 	}
 	
-	CharacterInputs.bIsJumpPressed = bIsJumpPressed;
+	// A press released within the same step still counts as pressed for it
+	CharacterInputs.bIsJumpPressed = bIsJumpPressed || bIsJumpJustPressed;
 	CharacterInputs.bIsJumpJustPressed = bIsJumpJustPressed;
 
-	if (bShouldToggleFlying)
+	if (bShouldEnterZeroG || (bShouldToggleFlying && !bIsFlyingActive))
 	{
-		if (!bIsFlyingActive)
-		{
-            CharacterInputs.SuggestedMovementMode = FName("ZeroG");
-            CachedMoveInputIntent = FVector::ZeroVector;
-			ZeroGCachedAngularVelocity = FRotator::ZeroRotator;
-		}
-		else
+		CharacterInputs.SuggestedMovementMode = MoonshotModeNames::ZeroG;
+		CachedMoveInputIntent = FVector::ZeroVector;
+		MoveInputSamples.Reset();
+		ZeroGCachedAngularVelocity = FRotator::ZeroRotator;
+		bIsFlyingActive = true;
+	}
+	else if (bShouldToggleFlying)
+	{
+		// Leaving ZeroG needs something to attach to; without it the press does nothing
+		if (bCanAttachToSurface)
 		{
-            if (bCanAttachToSurface)
-            {
-			    CharacterInputs.SuggestedMovementMode = DefaultModeNames::Falling;
-            }
+			CharacterInputs.SuggestedMovementMode = DefaultModeNames::Falling;
+			bIsFlyingActive = false;
 		}
-
-		bIsFlyingActive = !bIsFlyingActive;
 	}
 	else
 	{
@@ -359,75 +585,75 @@ void AMoonshotBasePawn::OnProduceInput(float DeltaMs, FMoverInputCmdContext& Out
 
 		bIsJumpJustPressed = false;
 		bShouldToggleFlying = false;
+		bShouldEnterZeroG = false;
 	}
 }
 
-/** Checks for changes in gravity reference frame and applies them
- * to the camera and control rotation.
-*/
-void AMoonshotBasePawn::UpdatePerspective(float DeltaSeconds)
+FVector AMoonshotBasePawn::ConsumeMoveInput(float DeltaMs)
 {
-	USpringArmComponent* Boom = GetCameraBoom();
-	UMoverComponent* Mover = GetMoverComponent();
-	APlayerController* PC = Cast<APlayerController>(Controller);
-	if (!Boom || !Mover || !PC) return;
+	// Sim steps are laid end to end on the input clock, so catch-up steps produced in one frame each get their own span
+	const double Now = FPlatformTime::Seconds();
+	const double StepSeconds = 0.001 * DeltaMs;
+	if (FMath::Abs(Now - MoveInputConsumedSeconds) > MoonshotPawnInput::MaxIntegrationSeconds)
+	{
+		MoveInputConsumedSeconds = Now - StepSeconds;
+	}
 
-	GravityQuat = GetActorTransform().GetRotation();
-	
-	/// TODO: This was a clever, stupid idea
-	// Get the new gravity reference frame
-//	FVector Forward, Right, Up;
-//    if (IsFlyingActive() || !bCanAttachToSurface)
-//    {
-//		Forward = PC->GetControlRotation().Vector().GetSafeNormal();
-//		Right = FVector::CrossProduct(GetActorUpVector(), Forward).GetSafeNormal();
-//		Up = FVector::CrossProduct(Forward, Right).GetSafeNormal();
-//	}
-//	else
-//	{
-//		Forward = FVector::VectorPlaneProject(PC->GetControlRotation().Vector(), AttachSurfaceNormal).GetSafeNormal();
-//		Right = FVector::CrossProduct(AttachSurfaceNormal, Forward).GetSafeNormal();
-//		Up = FVector::CrossProduct(Forward, Right).GetSafeNormal();
-//    }
-//	FQuat PawnQuat = FQuat(FMatrix(Forward, Right, Up, FVector::ZeroVector));
-//	PawnQuat.Normalize();
-//
-//
-//	SetActorRotation(
-//		FQuat::Slerp(GetActorTransform().GetrRotation(), PawnQuat, 0.5f)
-//		);
-//
-//	DrawDebugLine(GetWorld(), GetActorLocation(), GetActorLocation() + Forward * 200, FColor::Red, false, 0.1f);
-//	DrawDebugLine(GetWorld(), GetActorLocation(), GetActorLocation() + Right * 200, FColor::Green, false, 0.1f);
-//	DrawDebugLine(GetWorld(), GetActorLocation(), GetActorLocation() + Up * 200, FColor::Blue, false, 0.1f);
+	const double Start = MoveInputConsumedSeconds;
+	MoveInputConsumedSeconds += StepSeconds;
+
+	if (MoveInputSamples.IsEmpty())
+	{
+		return CachedMoveInputIntent;
+	}
+	return MoveInputSamples.Average(Start, MoveInputConsumedSeconds);
+}
+
+void AMoonshotBasePawn::ApplyLookInput(APlayerController* PC)
+{
+	const double Now = FPlatformTime::Seconds();
+	const double Start = FMath::Max(LookInputAppliedSeconds, Now - MoonshotPawnInput::MaxIntegrationSeconds);
+	LookInputAppliedSeconds = Now;
+
+	// Stick deflection times the time it was held, so turn rate follows neither frame rate nor time dilation
+	const FVector LookSeconds = LookInputSamples.Integrate(Start, Now);
+	PC->AddYawInput(LookSeconds.X * LookScaleToUse.Yaw * LookRateMaxDpS);
+	PC->AddPitchInput(-LookSeconds.Y * LookScaleToUse.Pitch * LookRateMaxDpS);
 }
 
 void AMoonshotBasePawn::OnMoveTriggered(const FInputActionValue& Value)
 {
+	StampInputEvent();
 	const FVector MovementVector = Value.Get<FVector>();
 	CachedMoveInputIntent.X = FMath::Clamp(ZeroGMoveInputScale.X * MovementVector.X, -1.0f, 1.0f);
 	CachedMoveInputIntent.Y = FMath::Clamp(ZeroGMoveInputScale.Y * MovementVector.Y, -1.0f, 1.0f);
+	MoveInputSamples.Add(MoonshotPawnInput::GetFrameStartSeconds(), CachedMoveInputIntent);
 }
 
 void AMoonshotBasePawn::OnMoveCompleted(const FInputActionValue& Value)
 {
 	CachedMoveInputIntent.X = 0.0f;
     CachedMoveInputIntent.Y = 0.0f;
+	MoveInputSamples.Add(MoonshotPawnInput::GetFrameStartSeconds(), CachedMoveInputIntent);
 }
 
 void AMoonshotBasePawn::OnMoveUpTriggered(const FInputActionValue& Value)
 {
+	StampInputEvent();
     const float MoveUpValue = Value.Get<float>();
     CachedMoveInputIntent.Z = FMath::Clamp(ZeroGMoveInputScale.Z * MoveUpValue, -1.0f, 1.0f);
+	MoveInputSamples.Add(MoonshotPawnInput::GetFrameStartSeconds(), CachedMoveInputIntent);
 }
 
 void AMoonshotBasePawn::OnMoveUpCompleted(const FInputActionValue& Value)
 {
     CachedMoveInputIntent.Z = 0.0f;
+	MoveInputSamples.Add(MoonshotPawnInput::GetFrameStartSeconds(), CachedMoveInputIntent);
 }
 
 void AMoonshotBasePawn::OnLookTriggered(const FInputActionValue& Value)
 {
+	StampInputEvent();
 	USpringArmComponent* Boom = Cast<USpringArmComponent>(CameraBoom);
 	APlayerController* PC = Cast<APlayerController>(Controller);
 
@@ -438,8 +664,8 @@ void AMoonshotBasePawn::OnLookTriggered(const FInputActionValue& Value)
 	CachedLookInput.Yaw = 	FMath::Clamp(LookVector.X, -1.0f, 1.0f);
 	CachedLookInput.Pitch = FMath::Clamp(LookVector.Y, -1.0f, 1.0f);
  
-	PC->AddYawInput(CachedLookInput.Yaw * LookScaleToUse.Yaw * LookRateMaxDpS * GetWorld()->GetDeltaSeconds());
-	PC->AddPitchInput(-CachedLookInput.Pitch * LookScaleToUse.Pitch * LookRateMaxDpS * GetWorld()->GetDeltaSeconds());
+	LookInputSamples.Add(MoonshotPawnInput::GetFrameStartSeconds(), FVector(CachedLookInput.Yaw, CachedLookInput.Pitch, 0.0));
+	ApplyLookInput(PC);
 
 	FRotator BoomRot = PC->GetControlRotation();
 	Boom->SetRelativeRotation(BoomRot);
@@ -449,10 +675,12 @@ void AMoonshotBasePawn::OnLookTriggered(const FInputActionValue& Value)
 void AMoonshotBasePawn::OnLookCompleted(const FInputActionValue& Value)
 {
 	CachedLookInput.Pitch = CachedLookInput.Pitch = 0.0f;
+	LookInputSamples.Add(MoonshotPawnInput::GetFrameStartSeconds(), FVector::ZeroVector);
 }
 
 void AMoonshotBasePawn::OnRollTriggered(const FInputActionValue& Value)
 {
+	StampInputEvent();
     const float RollValue = Value.Get<float>();
     CachedTurnInput.Roll = ZeroGAngularVelocityScale.Roll * FMath::Clamp(RollValue, -1.0f, 1.0f);
 }
@@ -468,6 +696,7 @@ void AMoonshotBasePawn::OnGamepadLookStarted(const FInputActionValue& Value)
 
 void AMoonshotBasePawn::OnGamepadLookTriggered(const FInputActionValue& Value)
 {
+	StampInputEvent();
     USpringArmComponent* Boom = Cast<USpringArmComponent>(CameraBoom);
 	APlayerController* PC = Cast<APlayerController>(Controller);
 
@@ -478,8 +707,8 @@ void AMoonshotBasePawn::OnGamepadLookTriggered(const FInputActionValue& Value)
 	CachedLookInput.Yaw = 	FMath::Clamp(LookVector.X, -1.0f, 1.0f);
 	CachedLookInput.Pitch = FMath::Clamp(LookVector.Y, -1.0f, 1.0f);
  
-	PC->AddYawInput(CachedLookInput.Yaw * LookScaleToUse.Yaw * LookRateMaxDpS * GetWorld()->GetDeltaSeconds());
-	PC->AddPitchInput(-CachedLookInput.Pitch * LookScaleToUse.Pitch * LookRateMaxDpS * GetWorld()->GetDeltaSeconds());
+	LookInputSamples.Add(MoonshotPawnInput::GetFrameStartSeconds(), FVector(CachedLookInput.Yaw, CachedLookInput.Pitch, 0.0));
+	ApplyLookInput(PC);
 
 	FRotator BoomRot = PC->GetControlRotation();
 	Boom->SetRelativeRotation(BoomRot);
@@ -488,10 +717,12 @@ void AMoonshotBasePawn::OnGamepadLookTriggered(const FInputActionValue& Value)
 void AMoonshotBasePawn::OnGamepadLookCompleted(const FInputActionValue& Value)
 {
 	CachedLookInput.Pitch = CachedLookInput.Pitch = 0.0f;
+	LookInputSamples.Add(MoonshotPawnInput::GetFrameStartSeconds(), FVector::ZeroVector);
 }
 
 void AMoonshotBasePawn::OnJumpStarted(const FInputActionValue& Value)
 {
+	StampInputEvent();
 	if (GetMoverComponent()->IsFalling())
 	{
 		bShouldToggleFlying = true;
@@ -504,8 +735,8 @@ void AMoonshotBasePawn::OnJumpStarted(const FInputActionValue& Value)
 
 void AMoonshotBasePawn::OnJumpReleased(const FInputActionValue& Value)
 {
+	// bIsJumpJustPressed stays latched until a sim step consumes it, so taps between steps are not lost
 	bIsJumpPressed = false;
-	bIsJumpJustPressed = false;
 }
 
 void AMoonshotBasePawn::OnFlyTriggered(const FInputActionValue& Value)
@@ -2,6 +2,9 @@
 
 #include "MoonshotBasePlayerController.h"
 #include "MoonshotBasePawn.h"
+#include "MoonshotGravityFrameComponent.h"
+#include "MoonshotMover/Public/MoonshotMoverInputBaselines.h"
+#include "Engine/NetConnection.h"
 #include "GameFramework/Pawn.h"
 #include "Mover/Public/DefaultMovementSet/CharacterMoverComponent.h"
 #include "DrawDebugHelpers.h"
@@ -13,51 +16,75 @@ void AMoonshotBasePlayerController::BeginPlay()
 	UpdateRotation(GetWorld()->GetDeltaSeconds());
 }
 
+void AMoonshotBasePlayerController::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	// Acknowledge remote players' inputs once per tick at most
+	uint8 Sequence = 0;
+	if (GetLocalRole() == ROLE_Authority && NetConnection && FMoonshotMoverInputBaselines::ConsumeSequenceToAcknowledge(NetConnection->PackageMap, Sequence))
+	{
+		ClientAckInputBaseline(Sequence);
+	}
+}
+
+void AMoonshotBasePlayerController::ClientAckInputBaseline_Implementation(uint8 Sequence)
+{
+	if (UNetConnection* Connection = GetNetConnection())
+	{
+		FMoonshotMoverInputBaselines::Acknowledge(Connection->PackageMap, Sequence);
+	}
+}
+
 void AMoonshotBasePlayerController::UpdateRotation(float DeltaTime)
 {	
-	FVector GravityDirection = FVector::DownVector;
-	FName MovementModeName = NAME_None;
+	FMoonshotMoverModeHandle MovementMode;
+	const UMoonshotGravityFrameComponent* GravityFrame = nullptr;
 	AMoonshotBasePawn* PlayerPawn = Cast<AMoonshotBasePawn>(GetPawn());
-	if (PlayerPawn)    // TODO: Get rid of this cast?
+	if (PlayerPawn && PlayerPawn->GetMoverComponent())    // TODO: Get rid of this cast?
 	{
-		if (UCharacterMoverComponent* MoveComp = PlayerPawn->GetMoverComponent())
-		{
-			MovementModeName = MoveComp->GetMovementModeName();
-
-			/** If the character is in ZeroG, rotate gravity reference frame with the character.
-			 * If not, try to find the surface gravity and set it as the gravity reference frame.
-			 * If no surface gravity is found, use the character's up vector as the gravity
-			 * reference frame (TODO: The character should be changing movement modes if no surface
-			 * gravity is found).
-			 * (TODO: We should really be slerping the gravity direction from one frame to the next?)
-			 */
-			if (MovementModeName == "ZeroG" || !PlayerPawn->FindSurfaceGravity(GravityDirection))
-			{
-				GravityDirection = -PlayerPawn->GetActorUpVector();
-			}
-		}
+		MovementMode = PlayerPawn->GetMovementModeHandle();
+
+		/** If the character is in ZeroG, the gravity reference frame rotates with the character.
+		 * If not, the surface gravity is the gravity reference frame, falling back to the character's
+		 * up vector if there is none (see AMoonshotBasePawn::RefreshGravityFrame).
+		 * The pawn's surface probe ticks before us and has already refreshed it for this frame.
+		 * (TODO: We should really be slerping the gravity direction from one frame to the next?)
+		 */
+		GravityFrame = PlayerPawn->GetGravityFrame();
+
+#if !UE_BUILD_SHIPPING
+		// Pipeline check: a stale probe means the tick prerequisites set up in AMoonshotBasePawn::NotifyControllerChanged were lost
+		ensureMsgf(GetWorld()->IsPaused() || !PlayerPawn->IsSurfaceProbeEnabled() || PlayerPawn->GetSurfaceProbeFrame() == 0 || PlayerPawn->GetSurfaceProbeFrame() == GFrameCounter,
+			TEXT("%s updated its rotation before %s probed for a surface this frame"), *GetName(), *PlayerPawn->GetName());
+#endif
 	}
 
+	const FVector GravityDirection = GravityFrame ? GravityFrame->GetGravityDirection() : FVector::DownVector;
+
 	// Get the current control rotation in world space
 	FRotator ViewRotation = GetControlRotation();
 	
 	// This is necessary for the camera to rotate with the character along changing surfaces.
-	if (!LastFrameGravity.Equals(FVector::ZeroVector) && MovementModeName != "ZeroG")
+	// The gravity frame only changes direction in steps, so this is skipped while it holds still.
+	if (!GravityDirection.Equals(LastFrameGravity, 0.0))
 	{
-		const FQuat DeltaGravityRotation = FQuat::FindBetweenNormals(LastFrameGravity, GravityDirection);
-		const FQuat WarpedCameraRotation = DeltaGravityRotation * FQuat(ViewRotation);
+		if (!LastFrameGravity.Equals(FVector::ZeroVector) && MovementMode != MoonshotModeHandles::ZeroG)
+		{
+			const FQuat DeltaGravityRotation = FQuat::FindBetweenNormals(LastFrameGravity, GravityDirection);
+			const FQuat WarpedCameraRotation = DeltaGravityRotation * FQuat(ViewRotation);
 	
-		ViewRotation = WarpedCameraRotation.Rotator();
-	}
+			ViewRotation = WarpedCameraRotation.Rotator();
+		}
 	
-	LastFrameGravity = GravityDirection;
+		LastFrameGravity = GravityDirection;
+	}
 
 	// Convert the view rotation from world space to gravity relative space.
 	// Now we can work with the rotation as if no custom gravity was affecting it.
-	//ViewRotation = GetGravityRelativeRotation(ViewRotation, GravityDirection);
-	if (!GravityDirection.Equals(FVector::DownVector))
+	if (GravityFrame)
 	{
-		ViewRotation = (FQuat::FindBetweenNormals(GravityDirection, FVector::DownVector) * ViewRotation.Quaternion()).Rotator();
+		ViewRotation = GravityFrame->ToGravityRelative(ViewRotation);
 	}
 
 	// Calculate Delta to be applied on ViewRotation
@@ -71,12 +98,7 @@ void AMoonshotBasePlayerController::UpdateRotation(float DeltaTime)
 		ViewRotation.Roll = 0;
 
 		// Convert the rotation back to world space, and set it as the current control rotation.
-		//FRotator NewControlRotation = GetGravityWorldRotation(ViewRotation, GravityDirection);
-		FRotator NewControlRotation = ViewRotation;
-		if (!GravityDirection.Equals(FVector::DownVector))
-		{
-			NewControlRotation = (FQuat::FindBetweenNormals(FVector::DownVector, GravityDirection) * ViewRotation.Quaternion()).Rotator();
-		}
+		const FRotator NewControlRotation = GravityFrame ? GravityFrame->ToWorld(ViewRotation) : ViewRotation;
 	
 		SetControlRotation(NewControlRotation);
 	}
@@ -0,0 +1,93 @@
+// Copyright 2024 Frazimuth, LLC.
+
+
+#include "MoonshotCameraBoomComponent.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/OverlapResult.h"
+#include "Engine/World.h"
+
+void UMoonshotCameraBoomComponent::UpdateDesiredArmLocation(bool bDoTrace, bool bDoLocationLag, bool bDoRotationLag, float DeltaTime)
+{
+	const UWorld* World = GetWorld();
+	if (!bDoTrace || !bCacheProbeCandidates || !World)
+	{
+		Super::UpdateDesiredArmLocation(bDoTrace, bDoLocationLag, bDoRotationLag, DeltaTime);
+		return;
+	}
+
+	// Let the stock update apply lag and place the unobstructed camera, then probe what it produced
+	Super::UpdateDesiredArmLocation(false, bDoLocationLag, bDoRotationLag, DeltaTime);
+	if (TargetArmLength == 0.f)
+	{
+		return;
+	}
+
+	const FTransform& ComponentTransform = GetComponentTransform();
+	const FVector ArmOrigin = PreviousDesiredLoc;
+	const FVector DesiredLoc = ComponentTransform.TransformPosition(RelativeSocketLocation);
+	const FQuat DesiredRot = ComponentTransform.TransformRotation(RelativeSocketRotation);
+
+	RefreshCandidates(ArmOrigin, FVector::Dist(ArmOrigin, DesiredLoc));
+
+	float HitTime = 1.f;
+	const FCollisionShape ProbeShape = FCollisionShape::MakeSphere(ProbeSize);
+	for (const TWeakObjectPtr<UPrimitiveComponent>& Candidate : Candidates)
+	{
+		FHitResult Hit;
+		if (Candidate.IsValid() && Candidate->SweepComponent(Hit, ArmOrigin, DesiredLoc, FQuat::Identity, ProbeShape))
+		{
+			HitTime = FMath::Min(HitTime, Hit.Time);
+		}
+	}
+
+	// Same resolution as the stock sweep: the probe center at the first hit along the whole arm, socket offset included
+	const bool bHit = HitTime < 1.f;
+	const FVector HitLoc = ArmOrigin + (DesiredLoc - ArmOrigin) * HitTime;
+	const FVector ResultLoc = BlendLocations(DesiredLoc, HitLoc, bHit, DeltaTime);
+
+	UnfixedCameraPosition = DesiredLoc;
+	bIsCameraFixed = ResultLoc != DesiredLoc;
+	if (!bIsCameraFixed)
+	{
+		return;
+	}
+
+	const FTransform RelCamTM = FTransform(DesiredRot, ResultLoc).GetRelativeTransform(ComponentTransform);
+	RelativeSocketLocation = RelCamTM.GetLocation();
+	RelativeSocketRotation = RelCamTM.GetRotation();
+	UpdateChildTransforms();
+}
+
+void UMoonshotCameraBoomComponent::RefreshCandidates(const FVector& ArmOrigin, float ProbeLength)
+{
+	const double Now = GetWorld()->GetTimeSeconds();
+
+	const bool bExpired = Now - CandidateGatheredSeconds > CandidateRefreshSeconds;
+	const bool bMoved = FVector::DistSquared(ArmOrigin, CandidateCenter) > FMath::Square(CandidateMargin);
+	// A shorter probe is still covered by the set gathered for a longer one, so only a longer arm forces a gather
+	if (!bExpired && !bMoved && ProbeLength <= CandidateProbeLength)
+	{
+		return;
+	}
+
+	CandidateCenter = ArmOrigin;
+	CandidateProbeLength = ProbeLength;
+	CandidateGatheredSeconds = Now;
+	Candidates.Reset();
+
+	// Covers the whole probe from anywhere within the margin of the center
+	const float Radius = ProbeLength + ProbeSize + CandidateMargin;
+
+	TArray<FOverlapResult> Overlaps;
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(MoonshotCameraBoomCandidates), false, GetOwner());
+	GetWorld()->OverlapMultiByChannel(Overlaps, ArmOrigin, FQuat::Identity, ProbeChannel, FCollisionShape::MakeSphere(Radius), QueryParams);
+
+	for (const FOverlapResult& Overlap : Overlaps)
+	{
+		UPrimitiveComponent* Component = Overlap.GetComponent();
+		if (Component && Component->GetCollisionResponseToChannel(ProbeChannel) == ECR_Block)
+		{
+			Candidates.AddUnique(Component);
+		}
+	}
+}
@@ -0,0 +1,53 @@
+// Copyright 2024 Frazimuth, LLC.
+
+
+#include "MoonshotGravityFrameComponent.h"
+
+UMoonshotGravityFrameComponent::UMoonshotGravityFrameComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+bool UMoonshotGravityFrameComponent::Update(const FVector& InGravityDirection, const FQuat& InFrameRotation)
+{
+	const FVector NewGravityDirection = InGravityDirection.GetSafeNormal();
+	if (NewGravityDirection.IsZero())
+	{
+		return false;
+	}
+
+	const double CosThreshold = FMath::Cos(FMath::DegreesToRadians(UpdateThresholdDegrees));
+	bool bRebuilt = false;
+
+	if ((NewGravityDirection | GravityDirection) < CosThreshold)
+	{
+		GravityDirection = NewGravityDirection;
+		bWorldAligned = GravityDirection.Equals(FVector::DownVector);
+		WorldToGravityRelative = bWorldAligned ? FQuat::Identity : FQuat::FindBetweenNormals(GravityDirection, FVector::DownVector);
+		GravityRelativeToWorld = WorldToGravityRelative.Inverse();
+		bRebuilt = true;
+	}
+
+	// |Q1 . Q2| is the cosine of half the angle between them
+	const double CosHalfThreshold = FMath::Cos(FMath::DegreesToRadians(UpdateThresholdDegrees) * 0.5);
+	if (FMath::Abs(InFrameRotation | FrameRotation) < CosHalfThreshold)
+	{
+		FrameRotation = InFrameRotation.GetNormalized();
+		Forward = FrameRotation.GetAxisX();
+		Right = FrameRotation.GetAxisY();
+		Up = FrameRotation.GetAxisZ();
+		bRebuilt = true;
+	}
+
+	return bRebuilt;
+}
+
+FRotator UMoonshotGravityFrameComponent::ToGravityRelative(const FRotator& WorldRotation) const
+{
+	return bWorldAligned ? WorldRotation : (WorldToGravityRelative * WorldRotation.Quaternion()).Rotator();
+}
+
+FRotator UMoonshotGravityFrameComponent::ToWorld(const FRotator& GravityRelativeRotation) const
+{
+	return bWorldAligned ? GravityRelativeRotation : (GravityRelativeToWorld * GravityRelativeRotation.Quaternion()).Rotator();
+}
@@ -0,0 +1,77 @@
+// Copyright 2024 Frazimuth, LLC.
+
+
+#include "MoonshotInputSampleBuffer.h"
+
+void FMoonshotInputSampleBuffer::Add(double Time, const FVector& Value)
+{
+	if (Num > 0)
+	{
+		Time = FMath::Max(Time, GetSample(Num - 1).Time);
+	}
+
+	if (Num == Capacity)
+	{
+		ValueBeforeOldest = GetSample(0).Value;
+		Head = (Head + 1) % Capacity;
+		--Num;
+	}
+
+	Samples[(Head + Num) % Capacity] = { Time, Value };
+	++Num;
+}
+
+void FMoonshotInputSampleBuffer::Reset(const FVector& Value)
+{
+	Head = 0;
+	Num = 0;
+	ValueBeforeOldest = Value;
+}
+
+FVector FMoonshotInputSampleBuffer::Integrate(double StartTime, double EndTime) const
+{
+	FVector Sum = FVector::ZeroVector;
+	if (EndTime <= StartTime)
+	{
+		return Sum;
+	}
+
+	// Each value holds from its own timestamp to the next one's; the first segment reaches back to the start of time
+	double SegmentStart = StartTime;
+	FVector SegmentValue = ValueBeforeOldest;
+
+	for (int32 Index = 0; Index < Num; ++Index)
+	{
+		const FSample& Sample = GetSample(Index);
+		if (Sample.Time >= EndTime)
+		{
+			break;
+		}
+
+		if (Sample.Time > SegmentStart)
+		{
+			Sum += SegmentValue * (Sample.Time - SegmentStart);
+			SegmentStart = Sample.Time;
+		}
+		SegmentValue = Sample.Value;
+	}
+
+	Sum += SegmentValue * (EndTime - SegmentStart);
+	return Sum;
+}
+
+FVector FMoonshotInputSampleBuffer::Average(double StartTime, double EndTime) const
+{
+	if (EndTime <= StartTime)
+	{
+		// The value held at EndTime
+		FVector Value = ValueBeforeOldest;
+		for (int32 Index = 0; Index < Num && GetSample(Index).Time <= EndTime; ++Index)
+		{
+			Value = GetSample(Index).Value;
+		}
+		return Value;
+	}
+
+	return Integrate(StartTime, EndTime) / (EndTime - StartTime);
+}
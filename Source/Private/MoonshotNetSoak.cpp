@@ -0,0 +1,303 @@
+// Copyright 2024 Frazimuth, LLC.
+
+
+#include "MoonshotNetSoak.h"
+#include "MoonshotMover/Public/MoonshotMoverInputBaselines.h"
+#include "MoonshotMover/Public/MoonshotMoverSimTelemetry.h"
+#include "Containers/Ticker.h"
+#include "Engine/GameInstance.h"
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "UObject/ObjectKey.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogMoonshotNetSoak, Log, All);
+
+namespace MoonshotNetSoak
+{
+	enum class ERole : uint8
+	{
+		None,
+		Server,
+		Client,
+	};
+
+	struct FConnectionBaseline
+	{
+		double InBytes = 0.0;
+		double OutBytes = 0.0;
+		int32 InPacketsLost = 0;
+		int32 OutPacketsLost = 0;
+	};
+
+	ERole Role = ERole::None;
+	int32 ClientIndex = 0;
+	double DurationSeconds = 120.0;
+	double WarmupSeconds = 15.0;
+	FString OutputDir;
+
+	TWeakObjectPtr<UGameInstance> GameInstance;
+	FTSTicker::FDelegateHandle TickerHandle;
+	double StartSeconds = 0.0;
+	double MeasureStartSeconds = 0.0;
+	bool bMeasuring = false;
+	bool bFinished = false;
+
+	// Game thread frame time, measured after warmup
+	uint64 NumFrames = 0;
+	double TotalFrameMs = 0.0;
+	double MaxFrameMs = 0.0;
+
+	FMoonshotMoverSimTelemetry::FStats TelemetryBaseline;
+	FMoonshotMoverInputRepair::FStats RepairBaseline;
+	TMap<TObjectKey<UNetConnection>, FConnectionBaseline> ConnectionBaselines;
+	TMap<TObjectKey<UNetConnection>, FString> ConnectionLabels;
+
+	TArray<UNetConnection*> GetConnections()
+	{
+		TArray<UNetConnection*> Connections;
+
+		const UWorld* World = GameInstance.IsValid() ? GameInstance->GetWorld() : nullptr;
+		const UNetDriver* NetDriver = World ? World->GetNetDriver() : nullptr;
+		if (!NetDriver)
+		{
+			return Connections;
+		}
+
+		if (NetDriver->ServerConnection)
+		{
+			Connections.Add(NetDriver->ServerConnection);
+		}
+		for (UNetConnection* Connection : NetDriver->ClientConnections)
+		{
+			if (Connection)
+			{
+				Connections.Add(Connection);
+			}
+		}
+		return Connections;
+	}
+
+	// "Server" on clients; on the server, connections are numbered in the order they are first seen so results from runs
+	// with different ports or addresses line up
+	const FString& GetConnectionLabel(const UNetConnection* Connection)
+	{
+		if (const FString* Existing = ConnectionLabels.Find(Connection))
+		{
+			return *Existing;
+		}
+
+		const UNetDriver* NetDriver = Connection->GetDriver();
+		if (NetDriver && NetDriver->ServerConnection == Connection)
+		{
+			return ConnectionLabels.Add(Connection, TEXT("Server"));
+		}
+		return ConnectionLabels.Add(Connection, FString::Printf(TEXT("Connection%d"), ConnectionLabels.Num()));
+	}
+
+	FConnectionBaseline SampleConnection(const UNetConnection* Connection)
+	{
+		FConnectionBaseline Sample;
+		Sample.InBytes = static_cast<double>(Connection->InTotalBytes);
+		Sample.OutBytes = static_cast<double>(Connection->OutTotalBytes);
+		Sample.InPacketsLost = Connection->InTotalPacketsLost;
+		Sample.OutPacketsLost = Connection->OutTotalPacketsLost;
+		return Sample;
+	}
+
+	void BeginMeasuring()
+	{
+		bMeasuring = true;
+		MeasureStartSeconds = FPlatformTime::Seconds();
+		TelemetryBaseline = FMoonshotMoverSimTelemetry::GetStats();
+		RepairBaseline = FMoonshotMoverInputRepair::GetStats();
+
+		ConnectionBaselines.Reset();
+		for (const UNetConnection* Connection : GetConnections())
+		{
+			ConnectionBaselines.Add(Connection, SampleConnection(Connection));
+			GetConnectionLabel(Connection);
+		}
+	}
+
+	void WriteResults()
+	{
+		const double Seconds = FMath::Max(FPlatformTime::Seconds() - MeasureStartSeconds, UE_DOUBLE_SMALL_NUMBER);
+		const FString Process = Role == ERole::Server ? FString(TEXT("Server")) : FString::Printf(TEXT("Client%d"), ClientIndex);
+
+		FString Csv;
+		auto AddRow = [&Csv, &Process](const FString& Connection, const TCHAR* Metric, double Value)
+		{
+			Csv += FString::Printf(TEXT("%s,%s,%s,%.3f\n"), *Process, *Connection, Metric, Value);
+		};
+
+		AddRow(TEXT(""), TEXT("MeasuredSeconds"), Seconds);
+		AddRow(TEXT(""), TEXT("AvgFrameMs"), NumFrames ? TotalFrameMs / NumFrames : 0.0);
+		AddRow(TEXT(""), TEXT("MaxFrameMs"), MaxFrameMs);
+
+		const FMoonshotMoverSimTelemetry::FStats Telemetry = FMoonshotMoverSimTelemetry::GetStats();
+		AddRow(TEXT(""), TEXT("Corrections"), double(Telemetry.Corrections - TelemetryBaseline.Corrections));
+		AddRow(TEXT(""), TEXT("ReducedCostCorrections"), double(Telemetry.ReducedCostCorrections - TelemetryBaseline.ReducedCostCorrections));
+		AddRow(TEXT(""), TEXT("ResimFrames"), double(Telemetry.ResimFrames - TelemetryBaseline.ResimFrames));
+		AddRow(TEXT(""), TEXT("ForwardFrames"), double(Telemetry.ForwardFrames - TelemetryBaseline.ForwardFrames));
+		AddRow(TEXT(""), TEXT("ResimTickMs"), Telemetry.ResimTickMs - TelemetryBaseline.ResimTickMs);
+		AddRow(TEXT(""), TEXT("MaxCorrectionErrorCm"), Telemetry.MaxErrorCm);
+
+		if (Role == ERole::Server)
+		{
+			const FMoonshotMoverInputRepair::FStats Repair = FMoonshotMoverInputRepair::GetStats();
+			AddRow(TEXT(""), TEXT("RepairedInputFrames"), double(Repair.RepairedFrames - RepairBaseline.RepairedFrames));
+			AddRow(TEXT(""), TEXT("UnrepairedInputFrames"), double(Repair.UnrepairedFrames - RepairBaseline.UnrepairedFrames));
+		}
+
+		for (const UNetConnection* Connection : GetConnections())
+		{
+			// Connections that arrived after warmup are measured from their start
+			const FConnectionBaseline* Baseline = ConnectionBaselines.Find(Connection);
+			const FConnectionBaseline Start = Baseline ? *Baseline : FConnectionBaseline();
+			const FConnectionBaseline End = SampleConnection(Connection);
+			const FString Label = GetConnectionLabel(Connection);
+
+			AddRow(Label, TEXT("InBytesPerSecond"), (End.InBytes - Start.InBytes) / Seconds);
+			AddRow(Label, TEXT("OutBytesPerSecond"), (End.OutBytes - Start.OutBytes) / Seconds);
+			AddRow(Label, TEXT("InPacketsLost"), double(End.InPacketsLost - Start.InPacketsLost));
+			AddRow(Label, TEXT("OutPacketsLost"), double(End.OutPacketsLost - Start.OutPacketsLost));
+		}
+
+		const FString Filename = OutputDir / (Process + TEXT(".csv"));
+		if (!FFileHelper::SaveStringToFile(Csv, *Filename))
+		{
+			UE_LOG(LogMoonshotNetSoak, Error, TEXT("Could not write soak results to %s"), *Filename);
+		}
+	}
+
+	bool Tick(float DeltaTime)
+	{
+		if (bFinished)
+		{
+			return false;
+		}
+
+		const double Now = FPlatformTime::Seconds();
+
+		if (!bMeasuring)
+		{
+			if (Now - StartSeconds >= WarmupSeconds)
+			{
+				BeginMeasuring();
+			}
+			return true;
+		}
+
+		// Work done on the game thread last frame, without the idle time the server's tick rate cap adds
+		const double FrameMs = FPlatformTime::ToMilliseconds(GGameThreadTime);
+		++NumFrames;
+		TotalFrameMs += FrameMs;
+		MaxFrameMs = FMath::Max(MaxFrameMs, FrameMs);
+
+		if (Now - StartSeconds >= DurationSeconds)
+		{
+			bFinished = true;
+			WriteResults();
+			UE_LOG(LogMoonshotNetSoak, Display, TEXT("Soak finished, results in %s"), *OutputDir);
+			FPlatformMisc::RequestExit(false);
+			return false;
+		}
+
+		return true;
+	}
+}
+
+void FMoonshotNetSoak::Start(UGameInstance* InGameInstance)
+{
+	using namespace MoonshotNetSoak;
+
+	FString RoleName;
+	if (Role != ERole::None || !FParse::Value(FCommandLine::Get(), TEXT("MoonshotSoak="), RoleName))
+	{
+		return;
+	}
+
+	if (RoleName == TEXT("Server"))
+	{
+		Role = ERole::Server;
+	}
+	else if (RoleName == TEXT("Client"))
+	{
+		Role = ERole::Client;
+	}
+	else
+	{
+		UE_LOG(LogMoonshotNetSoak, Error, TEXT("Unknown soak role %s, expected Server or Client"), *RoleName);
+		return;
+	}
+
+	FParse::Value(FCommandLine::Get(), TEXT("MoonshotSoakIndex="), ClientIndex);
+	FParse::Value(FCommandLine::Get(), TEXT("MoonshotSoakSeconds="), DurationSeconds);
+	FParse::Value(FCommandLine::Get(), TEXT("MoonshotSoakWarmup="), WarmupSeconds);
+	if (!FParse::Value(FCommandLine::Get(), TEXT("MoonshotSoakDir="), OutputDir))
+	{
+		OutputDir = FPaths::ProjectSavedDir() / TEXT("MoonshotSoak");
+	}
+	WarmupSeconds = FMath::Clamp(WarmupSeconds, 0.0, DurationSeconds);
+
+	GameInstance = InGameInstance;
+	StartSeconds = FPlatformTime::Seconds();
+	TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateStatic(&MoonshotNetSoak::Tick));
+
+	UE_LOG(LogMoonshotNetSoak, Display, TEXT("Soak %s %d: %.0fs, measuring after %.0fs"), *RoleName, ClientIndex, DurationSeconds, WarmupSeconds);
+}
+
+void FMoonshotNetSoak::Stop()
+{
+	using namespace MoonshotNetSoak;
+
+	if (TickerHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+		TickerHandle.Reset();
+	}
+
+	// Shut down early (the server went away, say): leave what was measured so the report shows a short run rather than none
+	if (Role != ERole::None && bMeasuring && !bFinished)
+	{
+		bFinished = true;
+		WriteResults();
+	}
+	GameInstance.Reset();
+}
+
+bool FMoonshotNetSoak::IsScriptingInput()
+{
+	return MoonshotNetSoak::Role == MoonshotNetSoak::ERole::Client;
+}
+
+FMoonshotNetSoak::FScriptedInput FMoonshotNetSoak::GetScriptedInput(double PrevSeconds, double Seconds)
+{
+	using namespace MoonshotNetSoak;
+
+	// Each client runs the same pattern shifted in time, with its own circling direction
+	const double Offset = ClientIndex * 1.7;
+	const double Time = Seconds + Offset;
+	const double PrevTime = PrevSeconds + Offset;
+	const double Turn = (ClientIndex % 2 == 0) ? 1.0 : -1.0;
+
+	FScriptedInput Scripted;
+
+	// Walk a circle, with a pause every 8s to exercise stopping
+	if (FMath::Fmod(Time, 8.0) < 6.5)
+	{
+		Scripted.MoveIntent = FVector(FMath::Cos(Time * 0.6), Turn * FMath::Sin(Time * 0.6), 0.0);
+	}
+
+	// A 0.3s jump every 3s and a flying toggle every 20s, fired on the step that crosses the boundary
+	Scripted.bJumpPressed = FMath::Fmod(Time, 3.0) < 0.3;
+	Scripted.bToggleFlying = FMath::FloorToInt64(Time / 20.0) != FMath::FloorToInt64(PrevTime / 20.0);
+
+	return Scripted;
+}
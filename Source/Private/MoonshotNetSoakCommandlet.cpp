@@ -0,0 +1,177 @@
+// Copyright 2024 Frazimuth, LLC.
+
+
+#include "MoonshotNetSoakCommandlet.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogMoonshotNetSoakCommandlet, Log, All);
+
+namespace MoonshotNetSoakCommandlet
+{
+	// Time the server gets to load the map before clients try to connect
+	constexpr double ServerStartupSeconds = 10.0;
+
+	// The server keeps running this long after the clients' run ends, so they finish connected
+	constexpr double ServerLingerSeconds = 10.0;
+
+	// Grace period past the run length before stragglers are killed
+	constexpr double ShutdownTimeoutSeconds = 60.0;
+
+	struct FSoakProcess
+	{
+		FString Name;
+		FProcHandle Handle;
+	};
+
+	bool Launch(const FString& Exe, const FString& Args, const FString& Name, TArray<FSoakProcess>& Processes)
+	{
+		UE_LOG(LogMoonshotNetSoakCommandlet, Display, TEXT("Starting %s: %s %s"), *Name, *Exe, *Args);
+
+		FProcHandle Handle = FPlatformProcess::CreateProc(*Exe, *Args, /*bLaunchDetached*/ false, /*bLaunchHidden*/ true, /*bLaunchReallyHidden*/ true, nullptr, 0, nullptr, nullptr);
+		if (!Handle.IsValid())
+		{
+			UE_LOG(LogMoonshotNetSoakCommandlet, Error, TEXT("Could not start %s"), *Name);
+			return false;
+		}
+
+		Processes.Add({ Name, Handle });
+		return true;
+	}
+
+	void TerminateAll(TArray<FSoakProcess>& Processes)
+	{
+		for (FSoakProcess& Process : Processes)
+		{
+			if (FPlatformProcess::IsProcRunning(Process.Handle))
+			{
+				UE_LOG(LogMoonshotNetSoakCommandlet, Warning, TEXT("%s did not exit, terminating it"), *Process.Name);
+				FPlatformProcess::TerminateProc(Process.Handle, /*KillTree*/ true);
+			}
+			FPlatformProcess::CloseProc(Process.Handle);
+		}
+		Processes.Reset();
+	}
+}
+
+UMoonshotNetSoakCommandlet::UMoonshotNetSoakCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UMoonshotNetSoakCommandlet::Main(const FString& Params)
+{
+	using namespace MoonshotNetSoakCommandlet;
+
+	int32 NumClients = 4;
+	double Seconds = 120.0;
+	double Warmup = 15.0;
+	int32 Port = 17777;
+	int32 PktLag = 0;
+	int32 PktLagVariance = 0;
+	int32 PktLoss = 0;
+	FString Map;
+	FString Exe;
+
+	FParse::Value(*Params, TEXT("Clients="), NumClients);
+	FParse::Value(*Params, TEXT("Seconds="), Seconds);
+	FParse::Value(*Params, TEXT("Warmup="), Warmup);
+	FParse::Value(*Params, TEXT("Port="), Port);
+	FParse::Value(*Params, TEXT("PktLag="), PktLag);
+	FParse::Value(*Params, TEXT("PktLagVariance="), PktLagVariance);
+	FParse::Value(*Params, TEXT("PktLoss="), PktLoss);
+	FParse::Value(*Params, TEXT("Map="), Map);
+
+	// Without -Exe, run this executable on the project, the way an editor build plays as a server or game
+	FString ProjectArg;
+	if (!FParse::Value(*Params, TEXT("Exe="), Exe))
+	{
+		Exe = FPlatformProcess::ExecutablePath();
+		ProjectArg = FString::Printf(TEXT("\"%s\" "), *FPaths::ConvertRelativePathToFull(FPaths::GetProjectFilePath()));
+	}
+
+	NumClients = FMath::Max(NumClients, 1);
+	Seconds = FMath::Max(Seconds, 1.0);
+	Warmup = FMath::Clamp(Warmup, 0.0, Seconds);
+
+	const FString OutputDir = FPaths::ConvertRelativePathToFull(FPaths::ProjectSavedDir() / TEXT("MoonshotSoak") / FDateTime::Now().ToString());
+	IFileManager::Get().MakeDirectory(*OutputDir, /*Tree*/ true);
+
+	const FString CommonArgs = FString::Printf(TEXT("-nullrhi -nosound -unattended -nosplash -stdout -FORCELOGFLUSH -PktLag=%d -PktLagVariance=%d -PktLoss=%d -MoonshotSoakDir=\"%s\""),
+		PktLag, PktLagVariance, PktLoss, *OutputDir);
+
+	TArray<FSoakProcess> Processes;
+
+	// The server starts first and outlives the clients; its measured window is shifted to line up with theirs
+	const FString ServerArgs = FString::Printf(TEXT("%s%s -server -port=%d -log=MoonshotSoak_Server.log -MoonshotSoak=Server -MoonshotSoakSeconds=%f -MoonshotSoakWarmup=%f %s"),
+		*ProjectArg, *Map, Port, ServerStartupSeconds + Seconds + ServerLingerSeconds, ServerStartupSeconds + Warmup, *CommonArgs);
+	if (!Launch(Exe, ServerArgs, TEXT("Server"), Processes))
+	{
+		return 1;
+	}
+
+	FPlatformProcess::Sleep(ServerStartupSeconds);
+
+	for (int32 ClientIndex = 0; ClientIndex < NumClients; ++ClientIndex)
+	{
+		const FString ClientArgs = FString::Printf(TEXT("%s127.0.0.1:%d -game -log=MoonshotSoak_Client%d.log -MoonshotSoak=Client -MoonshotSoakIndex=%d -MoonshotSoakSeconds=%f -MoonshotSoakWarmup=%f %s"),
+			*ProjectArg, Port, ClientIndex, ClientIndex, Seconds, Warmup, *CommonArgs);
+		if (!Launch(Exe, ClientArgs, FString::Printf(TEXT("Client%d"), ClientIndex), Processes))
+		{
+			TerminateAll(Processes);
+			return 1;
+		}
+	}
+
+	const double Deadline = FPlatformTime::Seconds() + Seconds + ServerLingerSeconds + ShutdownTimeoutSeconds;
+	while (FPlatformTime::Seconds() < Deadline)
+	{
+		const bool bAnyRunning = Processes.ContainsByPredicate([](const FSoakProcess& Process) { return FPlatformProcess::IsProcRunning(Process.Handle); });
+		if (!bAnyRunning)
+		{
+			break;
+		}
+		FPlatformProcess::Sleep(1.0f);
+	}
+	TerminateAll(Processes);
+
+	// One file of Process,Connection,Metric,Value rows per process
+	FString Report = TEXT("Process,Connection,Metric,Value\n");
+	int32 NumMissing = 0;
+
+	TArray<FString> Expected = { TEXT("Server") };
+	for (int32 ClientIndex = 0; ClientIndex < NumClients; ++ClientIndex)
+	{
+		Expected.Add(FString::Printf(TEXT("Client%d"), ClientIndex));
+	}
+
+	for (const FString& Process : Expected)
+	{
+		FString Rows;
+		if (FFileHelper::LoadFileToString(Rows, *(OutputDir / (Process + TEXT(".csv")))))
+		{
+			Report += Rows;
+		}
+		else
+		{
+			UE_LOG(LogMoonshotNetSoakCommandlet, Error, TEXT("%s wrote no results; see MoonshotSoak_%s.log"), *Process, *Process);
+			++NumMissing;
+		}
+	}
+
+	const FString ReportFile = OutputDir / TEXT("Report.csv");
+	FFileHelper::SaveStringToFile(Report, *ReportFile);
+
+	UE_LOG(LogMoonshotNetSoakCommandlet, Display, TEXT("Soak report (%d clients, %.0fs, lag %dms +-%d, loss %d%%):\n%s"), NumClients, Seconds, PktLag, PktLagVariance, PktLoss, *Report);
+	UE_LOG(LogMoonshotNetSoakCommandlet, Display, TEXT("Written to %s"), *ReportFile);
+
+	return NumMissing == 0 ? 0 : 1;
+}
@@ -0,0 +1,423 @@
+// Copyright 2024 Frazimuth, LLC.
+
+
+#include "MoonshotReplicationGraph.h"
+#include "MoonshotBasePlayerController.h"
+#include "Engine/ChildConnection.h"
+#include "Engine/NetConnection.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+
+UMoonshotReplicationGraphNode_OrbitalGrid::UMoonshotReplicationGraphNode_OrbitalGrid()
+{
+	// Cells are rebuilt in PrepareForReplication, which global nodes only get with this set
+	bRequiresPrepareForReplicationCall = true;
+}
+
+FIntVector UMoonshotReplicationGraphNode_OrbitalGrid::GetCell(const FVector& WorldLocation) const
+{
+	const FVector CellSpace = OrbitalFrame.InverseTransformPosition(WorldLocation) / CellSize;
+	return FIntVector(FMath::FloorToInt32(CellSpace.X), FMath::FloorToInt32(CellSpace.Y), FMath::FloorToInt32(CellSpace.Z));
+}
+
+void UMoonshotReplicationGraphNode_OrbitalGrid::NotifyAddNetworkActor(const FNewReplicatedActorInfo& ActorInfo)
+{
+	Actors.Add(ActorInfo.Actor);
+}
+
+bool UMoonshotReplicationGraphNode_OrbitalGrid::NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound)
+{
+	const bool bRemoved = Actors.RemoveSwap(ActorInfo.Actor) > 0;
+	UE_CLOG(!bRemoved && bWarnIfNotFound, LogReplicationGraph, Warning, TEXT("Orbital grid: %s was not in the grid."), *GetNameSafe(ActorInfo.Actor));
+	return bRemoved;
+}
+
+void UMoonshotReplicationGraphNode_OrbitalGrid::NotifyResetAllNetworkActors()
+{
+	Actors.Reset();
+	Cells.Reset();
+}
+
+void UMoonshotReplicationGraphNode_OrbitalGrid::PrepareForReplication()
+{
+	for (TPair<FIntVector, FActorRepListRefView>& Cell : Cells)
+	{
+		Cell.Value.Reset();
+	}
+
+	for (int32 Index = Actors.Num() - 1; Index >= 0; --Index)
+	{
+		AActor* Actor = Actors[Index];
+		if (!IsValid(Actor))
+		{
+			Actors.RemoveAtSwap(Index);
+			continue;
+		}
+
+		Cells.FindOrAdd(GetCell(Actor->GetActorLocation())).Add(Actor);
+	}
+
+	// Only occupied cells stay, so walking the map is bounded by the actor count
+	for (auto It = Cells.CreateIterator(); It; ++It)
+	{
+		if (It.Value().Num() == 0)
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+void UMoonshotReplicationGraphNode_OrbitalGrid::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
+{
+	const int32 NumRings = TierReplicationPeriods.Num();
+	if (NumRings == 0 || Cells.Num() == 0)
+	{
+		return;
+	}
+
+	// Stagger connections so one tier's updates do not all land on the same frame
+	const uint32 Phase = Params.ReplicationFrameNum + static_cast<uint32>(Params.ConnectionManager.ConnectionOrderNum);
+
+	auto GatherCell = [this, &Params, Phase](const FActorRepListRefView& List, int32 Ring)
+	{
+		const uint32 Period = static_cast<uint32>(FMath::Max(1, TierReplicationPeriods[Ring]));
+		if (Phase % Period == 0)
+		{
+			Params.OutGatheredReplicationLists.AddReplicationActorList(List);
+		}
+	};
+
+	const int32 Radius = NumRings - 1;
+	const int32 NumCellsInRange = FMath::Cube(2 * Radius + 1);
+
+	for (const FNetViewer& Viewer : Params.Viewers)
+	{
+		const FIntVector ViewerCell = GetCell(Viewer.ViewLocation);
+
+		// Walk whichever is smaller: the cells in range (729 with five rings) or every occupied cell, in range or not
+		if (NumCellsInRange < Cells.Num())
+		{
+			for (int32 X = -Radius; X <= Radius; ++X)
+			{
+				for (int32 Y = -Radius; Y <= Radius; ++Y)
+				{
+					for (int32 Z = -Radius; Z <= Radius; ++Z)
+					{
+						if (const FActorRepListRefView* List = Cells.Find(ViewerCell + FIntVector(X, Y, Z)))
+						{
+							GatherCell(*List, FMath::Max3(FMath::Abs(X), FMath::Abs(Y), FMath::Abs(Z)));
+						}
+					}
+				}
+			}
+		}
+		else
+		{
+			for (const TPair<FIntVector, FActorRepListRefView>& Cell : Cells)
+			{
+				const FIntVector Offset = Cell.Key - ViewerCell;
+				const int32 Ring = FMath::Max3(FMath::Abs(Offset.X), FMath::Abs(Offset.Y), FMath::Abs(Offset.Z));
+				if (Ring < NumRings)
+				{
+					GatherCell(Cell.Value, Ring);
+				}
+			}
+		}
+	}
+}
+
+void UMoonshotReplicationGraphNode_OrbitalGrid::LogNode(FReplicationGraphDebugInfo& DebugInfo, const FString& NodeName) const
+{
+	DebugInfo.Log(NodeName);
+	DebugInfo.PushIndent();
+	for (const TPair<FIntVector, FActorRepListRefView>& Cell : Cells)
+	{
+		LogActorRepList(DebugInfo, FString::Printf(TEXT("Cell %s"), *Cell.Key.ToString()), Cell.Value);
+	}
+	DebugInfo.PopIndent();
+}
+
+UMoonshotReplicationGraphNode_Squads::UMoonshotReplicationGraphNode_Squads()
+{
+	bRequiresPrepareForReplicationCall = true;
+}
+
+void UMoonshotReplicationGraphNode_Squads::PrepareForReplication()
+{
+	for (TPair<int32, FActorRepListRefView>& Squad : SquadPawns)
+	{
+		Squad.Value.Reset();
+	}
+
+	const UWorld* World = GraphGlobals.IsValid() ? GraphGlobals->World.Get() : nullptr;
+	if (World)
+	{
+		for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+		{
+			const AMoonshotBasePlayerController* PlayerController = Cast<AMoonshotBasePlayerController>(It->Get());
+			if (PlayerController && PlayerController->SquadId != INDEX_NONE && PlayerController->GetPawn())
+			{
+				SquadPawns.FindOrAdd(PlayerController->SquadId).Add(PlayerController->GetPawn());
+			}
+		}
+	}
+
+	for (auto It = SquadPawns.CreateIterator(); It; ++It)
+	{
+		if (It.Value().Num() == 0)
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+void UMoonshotReplicationGraphNode_Squads::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
+{
+	for (const FNetViewer& Viewer : Params.Viewers)
+	{
+		const AMoonshotBasePlayerController* PlayerController = Cast<AMoonshotBasePlayerController>(Viewer.InViewer);
+		if (!PlayerController || PlayerController->SquadId == INDEX_NONE)
+		{
+			continue;
+		}
+
+		if (const FActorRepListRefView* Squad = SquadPawns.Find(PlayerController->SquadId))
+		{
+			Params.OutGatheredReplicationLists.AddReplicationActorList(*Squad);
+		}
+	}
+}
+
+UMoonshotReplicationGraphNode_OwnerOnly::UMoonshotReplicationGraphNode_OwnerOnly()
+{
+	bRequiresPrepareForReplicationCall = true;
+}
+
+void UMoonshotReplicationGraphNode_OwnerOnly::NotifyAddNetworkActor(const FNewReplicatedActorInfo& ActorInfo)
+{
+	Actors.Add(ActorInfo.Actor);
+}
+
+bool UMoonshotReplicationGraphNode_OwnerOnly::NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound)
+{
+	const bool bRemoved = Actors.RemoveSwap(ActorInfo.Actor) > 0;
+	UE_CLOG(!bRemoved && bWarnIfNotFound, LogReplicationGraph, Warning, TEXT("Owner-only node: %s was not in the node."), *GetNameSafe(ActorInfo.Actor));
+	return bRemoved;
+}
+
+void UMoonshotReplicationGraphNode_OwnerOnly::NotifyResetAllNetworkActors()
+{
+	Actors.Reset();
+	ConnectionActors.Reset();
+}
+
+void UMoonshotReplicationGraphNode_OwnerOnly::PrepareForReplication()
+{
+	for (TPair<TObjectKey<UNetConnection>, FActorRepListRefView>& Connection : ConnectionActors)
+	{
+		Connection.Value.Reset();
+	}
+
+	for (int32 Index = Actors.Num() - 1; Index >= 0; --Index)
+	{
+		AActor* Actor = Actors[Index];
+		if (!IsValid(Actor))
+		{
+			Actors.RemoveAtSwap(Index);
+			continue;
+		}
+
+		// Split-screen players replicate through their parent connection
+		const UNetConnection* Connection = Actor->GetNetConnection();
+		if (const UChildConnection* ChildConnection = Cast<UChildConnection>(Connection))
+		{
+			Connection = ChildConnection->Parent;
+		}
+
+		if (Connection)
+		{
+			ConnectionActors.FindOrAdd(Connection).Add(Actor);
+		}
+	}
+
+	for (auto It = ConnectionActors.CreateIterator(); It; ++It)
+	{
+		if (It.Value().Num() == 0)
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+void UMoonshotReplicationGraphNode_OwnerOnly::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
+{
+	if (const FActorRepListRefView* List = ConnectionActors.Find(Params.ConnectionManager.NetConnection))
+	{
+		Params.OutGatheredReplicationLists.AddReplicationActorList(*List);
+	}
+}
+
+UMoonshotReplicationGraph::UMoonshotReplicationGraph()
+{
+	TierReplicationPeriods = { 1, 1, 2, 4, 8 };
+}
+
+void UMoonshotReplicationGraph::InitGlobalActorClassSettings()
+{
+	Super::InitGlobalActorClassSettings();
+
+	int32 SlowestPeriod = 1;
+	for (const int32 Period : TierReplicationPeriods)
+	{
+		SlowestPeriod = FMath::Max(SlowestPeriod, Period);
+	}
+
+	// The grid decides relevancy and rate, so classes replicate whenever they are gathered and are not distance culled again.
+	// Channels have to survive the frames the slowest tier skips.
+	FClassReplicationInfo DefaultInfo;
+	DefaultInfo.ReplicationPeriodFrame = 1;
+	DefaultInfo.SetCullDistanceSquared(0.f);
+	DefaultInfo.ActorChannelFrameTimeout = static_cast<uint8>(FMath::Clamp(SlowestPeriod * 2, 4, 255));
+	GlobalActorReplicationInfoMap.SetClassInfo(AActor::StaticClass(), DefaultInfo);
+}
+
+void UMoonshotReplicationGraph::InitGlobalGraphNodes()
+{
+	OrbitalGridNode = CreateNewNode<UMoonshotReplicationGraphNode_OrbitalGrid>();
+	OrbitalGridNode->CellSize = OrbitalCellSize;
+	OrbitalGridNode->TierReplicationPeriods = TierReplicationPeriods;
+	AddGlobalGraphNode(OrbitalGridNode);
+
+	AlwaysRelevantNode = CreateNewNode<UReplicationGraphNode_ActorList>();
+	AddGlobalGraphNode(AlwaysRelevantNode);
+
+	SquadNode = CreateNewNode<UMoonshotReplicationGraphNode_Squads>();
+	AddGlobalGraphNode(SquadNode);
+
+	OwnerOnlyNode = CreateNewNode<UMoonshotReplicationGraphNode_OwnerOnly>();
+	AddGlobalGraphNode(OwnerOnlyNode);
+}
+
+void UMoonshotReplicationGraph::InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection)
+{
+	Super::InitConnectionGraphNodes(RepGraphConnection);
+
+	// The connection's own controller, pawn and view target
+	UReplicationGraphNode_AlwaysRelevant_ForConnection* AlwaysRelevantForConnectionNode = CreateNewNode<UReplicationGraphNode_AlwaysRelevant_ForConnection>();
+	AddConnectionGraphNode(AlwaysRelevantForConnectionNode, RepGraphConnection);
+}
+
+void UMoonshotReplicationGraph::RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo)
+{
+	AActor* Actor = ActorInfo.Actor;
+	if (DependentActorParents.Contains(Actor))
+	{
+		return;
+	}
+
+	// Equipment already attached to a replicated actor goes wherever that actor goes
+	AActor* AttachParent = Actor->GetAttachParentActor();
+	if (AttachParent && AttachParent->GetIsReplicated() && !Actor->bAlwaysRelevant && !Actor->bOnlyRelevantToOwner)
+	{
+		GlobalActorReplicationInfoMap.AddDependentActor(AttachParent, Actor);
+		DependentActorParents.Add(Actor, AttachParent);
+		return;
+	}
+
+	RouteToOwnNode(ActorInfo);
+}
+
+void UMoonshotReplicationGraph::RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo)
+{
+	TWeakObjectPtr<AActor> Parent;
+	if (DependentActorParents.RemoveAndCopyValue(ActorInfo.Actor, Parent))
+	{
+		if (Parent.IsValid())
+		{
+			GlobalActorReplicationInfoMap.RemoveDependentActor(Parent.Get(), ActorInfo.Actor);
+		}
+		return;
+	}
+
+	RemoveFromOwnNode(ActorInfo);
+}
+
+void UMoonshotReplicationGraph::RouteToOwnNode(const FNewReplicatedActorInfo& ActorInfo)
+{
+	const AActor* Actor = ActorInfo.Actor;
+
+	if (Actor->bAlwaysRelevant)
+	{
+		AlwaysRelevantNode->NotifyAddNetworkActor(ActorInfo);
+	}
+	else if (Actor->bOnlyRelevantToOwner)
+	{
+		// Controllers reach their owner through the connection's always-relevant node
+		if (!Actor->IsA<AController>())
+		{
+			OwnerOnlyNode->NotifyAddNetworkActor(ActorInfo);
+		}
+	}
+	else
+	{
+		OrbitalGridNode->NotifyAddNetworkActor(ActorInfo);
+	}
+}
+
+void UMoonshotReplicationGraph::RemoveFromOwnNode(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound)
+{
+	const AActor* Actor = ActorInfo.Actor;
+
+	if (Actor->bAlwaysRelevant)
+	{
+		AlwaysRelevantNode->NotifyRemoveNetworkActor(ActorInfo, bWarnIfNotFound);
+	}
+	else if (Actor->bOnlyRelevantToOwner)
+	{
+		if (!Actor->IsA<AController>())
+		{
+			OwnerOnlyNode->NotifyRemoveNetworkActor(ActorInfo, bWarnIfNotFound);
+		}
+	}
+	else
+	{
+		OrbitalGridNode->NotifyRemoveNetworkActor(ActorInfo, bWarnIfNotFound);
+	}
+}
+
+void UMoonshotReplicationGraph::AddDependentActor(AActor* Parent, AActor* Child)
+{
+	if (!Parent || !Child || DependentActorParents.Contains(Child))
+	{
+		return;
+	}
+
+	// Child may not be replicating yet, in which case RouteAddNetworkActorToNodes leaves it out of the nodes
+	RemoveFromOwnNode(FNewReplicatedActorInfo(Child), false);
+
+	GlobalActorReplicationInfoMap.AddDependentActor(Parent, Child);
+	DependentActorParents.Add(Child, Parent);
+}
+
+void UMoonshotReplicationGraph::RemoveDependentActor(AActor* Child)
+{
+	TWeakObjectPtr<AActor> Parent;
+	if (!Child || !DependentActorParents.RemoveAndCopyValue(Child, Parent))
+	{
+		return;
+	}
+
+	if (Parent.IsValid())
+	{
+		GlobalActorReplicationInfoMap.RemoveDependentActor(Parent.Get(), Child);
+	}
+	RouteToOwnNode(FNewReplicatedActorInfo(Child));
+}
+
+void UMoonshotReplicationGraph::SetOrbitalFrame(const FTransform& OrbitalFrame)
+{
+	if (OrbitalGridNode)
+	{
+		OrbitalGridNode->SetOrbitalFrame(OrbitalFrame);
+	}
+}
@@ -0,0 +1,55 @@
+// Copyright 2024 Frazimuth, LLC.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "MoonshotBasePawn.h"
+#include "MoonshotBasePlayerController.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/WorldSettings.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMoonshotTickOrderTest, "Moonshot.Pawn.SurfaceProbeBeforeUpdateRotation",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FMoonshotTickOrderTest::RunTest(const FString& Parameters)
+{
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, /*bInformEngineOfWorld*/ false);
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+	World->InitializeActorsForPlay(FURL());
+	World->GetWorldSettings()->NotifyBeginPlay();
+
+	// Standalone, so the controller is local and possessing enables the pawn's probe and sets up the prerequisites.
+	// Without a ULocalPlayer the controller never gets to UpdateRotation in a tick, so the test checks the edge that orders
+	// the two: the controller's tick waits on the pawn's probe, which is the only other tick function the pawn has.
+	auto ControllerWaitsOnProbe = [](const AController* Controller, const AMoonshotBasePawn* Pawn)
+	{
+		return Controller->PrimaryActorTick.GetPrerequisites().ContainsByPredicate([Pawn](const FTickPrerequisite& Prerequisite)
+		{
+			return Prerequisite.PrerequisiteObject.Get() == Pawn && Prerequisite.Get() && Prerequisite.Get() != &Pawn->PrimaryActorTick;
+		});
+	};
+
+	AMoonshotBasePawn* Pawn = World->SpawnActor<AMoonshotBasePawn>();
+	AMoonshotBasePlayerController* Controller = World->SpawnActor<AMoonshotBasePlayerController>();
+	if (TestNotNull(TEXT("Pawn"), Pawn) && TestNotNull(TEXT("Controller"), Controller))
+	{
+		TestFalse(TEXT("Controller does not wait on an unpossessed pawn"), ControllerWaitsOnProbe(Controller, Pawn));
+
+		Controller->Possess(Pawn);
+		TestTrue(TEXT("Surface probe enabled on the possessed pawn"), Pawn->IsSurfaceProbeEnabled());
+		TestTrue(TEXT("Controller ticks after the surface probe"), ControllerWaitsOnProbe(Controller, Pawn));
+
+		Controller->UnPossess();
+		TestFalse(TEXT("Unpossessing removes the prerequisite"), ControllerWaitsOnProbe(Controller, Pawn));
+	}
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(/*bInformEngineOfWorld*/ false);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -18,6 +18,9 @@ class MOONSHOT_API UMoonshotBaseGameInstance : public UGameInstance
 	FString PatchNotesFilePath;
 
 public:
+	virtual void Init() override;
+	virtual void Shutdown() override;
+
 	UFUNCTION(BlueprintCallable, Category = "PatchNotes")
 	FString GetPatchNotesFilePath();
 };
@@ -7,13 +7,52 @@
 #include "GameFramework/Pawn.h"
 #include "Engine/EngineTypes.h"
 #include "EnhancedInput/Public/EnhancedInputComponent.h"
+#include "MoonshotMover/Public/MoonshotMoverModeRegistry.h"
+#include "MoonshotInputSampleBuffer.h"
 #include "MoonshotBasePawn.generated.h"
 
 class UInputAction;
 class UCharacterMoverComponent;
 class USpringArmComponent;
+class APlayerController;
+class UMoonshotInputModifier;
+class UMoonshotGravityFrameComponent;
+class AMoonshotBasePawn;
 struct FInputActionValue;
 
+/** Runs AMoonshotBasePawn::UpdateSurfaceProbe ahead of the pawn's controller, see AMoonshotBasePawn. */
+USTRUCT()
+struct FMoonshotSurfaceProbeTickFunction : public FTickFunction
+{
+	GENERATED_USTRUCT_BODY()
+
+	AMoonshotBasePawn* Target = nullptr;
+
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
+	virtual FString DiagnosticMessage() override;
+	virtual FName DiagnosticContext(bool bDetailed) override;
+};
+
+template<>
+struct TStructOpsTypeTraits<FMoonshotSurfaceProbeTickFunction> : public TStructOpsTypeTraitsBase2<FMoonshotSurfaceProbeTickFunction>
+{
+	enum
+	{
+		WithCopy = false
+	};
+};
+
+/**
+ * Per-frame pipeline, kept in this order by tick prerequisites so every stage sees the current frame's results:
+ *  1. Sim: Network Prediction produces input (ProduceInput) and ticks the Mover simulation before actors tick.
+ *  2. Probe: SurfaceProbeTick traces for an attachable surface from the pose the sim just produced and refreshes the gravity frame.
+ *  3. Input and camera: the controller processes input actions and runs UpdateRotation against that gravity frame (the
+ *     controller's tick depends on the probe, set up in NotifyControllerChanged).
+ *  4. Pawn: Event Tick, after its controller as usual. Only Blueprint subclasses that implement it have an actor tick.
+ * Input gathered in 3 is produced into the next frame's 1, against the surface found in 2.
+ * Only a locally controlled pawn produces input, so 2 is switched off everywhere else (dedicated servers simulating remote
+ * players, simulated proxies) and back on when possession changes; see UpdateTickEnablement.
+ */
 UCLASS()
 class MOONSHOT_API AMoonshotBasePawn : public APawn, public IMoverInputProducerInterface
 {
@@ -25,11 +64,20 @@ public:
 
 
 public:
-	// Called every frame
-	virtual void Tick(float DeltaTime) override;
-
 	virtual void BeginPlay() override;
 
+	virtual void RegisterActorTickFunctions(bool bRegister) override;
+
+	virtual void NotifyControllerChanged() override;
+
+	// Traces for an attachable surface and refreshes the gravity frame. Stage 2 of the pipeline above.
+	void UpdateSurfaceProbe();
+
+	// GFrameCounter of the last UpdateSurfaceProbe, 0 until the probe has run since it was last enabled
+	uint64 GetSurfaceProbeFrame() const { return SurfaceProbeFrame; }
+
+	bool IsSurfaceProbeEnabled() const { return SurfaceProbeTick.IsTickFunctionEnabled(); }
+
 	// Called to bind functionality to input
 	virtual void SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent) override;
 
@@ -42,7 +90,7 @@ public:
 
 	// Request the character starts moving with an intended directional magnitude. A length of 1 indicates maximum acceleration.
 	UFUNCTION(BlueprintCallable, Category=Movement)
-	virtual void RequestMoveByIntent(const FVector& DesiredIntent) { CachedMoveInputIntent = DesiredIntent; }
+	virtual void RequestMoveByIntent(const FVector& DesiredIntent) { CachedMoveInputIntent = DesiredIntent; MoveInputSamples.Reset(); }
 
 	// Request the character starts moving with a desired velocity. This will be used in lieu of any other input.
 	UFUNCTION(BlueprintCallable, Category=Movement)
@@ -61,16 +109,32 @@ public:
 	bool GetGravitySystemAxes(FVector& OutForward, FVector& OutRight, FVector& OutUp) const;
 
 	UFUNCTION(BlueprintCallable, Category=Gravity)
-	FQuat GetGravityQuat() const { return GravityQuat; }
+	FQuat GetGravityQuat() const;
+
+	UFUNCTION(BlueprintPure, Category=Gravity)
+	UMoonshotGravityFrameComponent* GetGravityFrame() const { return GravityFrame; }
+
+	// Pushes the current gravity direction and pawn rotation into the gravity frame, which only rebuilds if they moved enough
+	void RefreshGravityFrame();
 
 
 
 	UFUNCTION(BlueprintCallable, Category=Movement)
 	bool IsFlyingActive() const;
 
+	// Handle of the current movement mode, kept in sync with the mover component's mode changes
+	FMoonshotMoverModeHandle GetMovementModeHandle() const { return CurrentModeHandle; }
+
 	//UFUNCTION(BlueprintCallable, Category=Collision)
 	FCollisionQueryParams GetTraceIgnoreParams() const;
 
+	// Appends a native input modifier, run after OnProduceInput each produced frame
+	UFUNCTION(BlueprintCallable, Category=Input)
+	void AddInputModifier(UMoonshotInputModifier* Modifier);
+
+	UFUNCTION(BlueprintCallable, Category=Input)
+	void RemoveInputModifier(UMoonshotInputModifier* Modifier);
+
 	/// TODO: Remove debug timer
 	FTimerHandle TimerHandle_Debug;
 	int32 DebugTimerCount = 0;
@@ -82,16 +146,28 @@ public:
 	FVector CumulativeDebugIntent = FVector(0.0f, 1.0f, 0.0f);
 
 protected:
-	// Entry point for input production. Do not override. To extend in derived character types, override OnProduceInput for native types or implement "Produce Input" blueprint event
+	// Entry point for input production. Do not override. To extend in derived character types, override OnProduceInput for native types or add an input modifier
 	virtual void ProduceInput_Implementation(int32 SimTimeMs, FMoverInputCmdContext& InputCmdResult) override;
 
 	// Override this function in native class to author input for the next simulation frame. Consider also calling Super method.
 	virtual void OnProduceInput(float DeltaMs, FMoverInputCmdContext& InputCmdResult);
 
 	// Implement this event in Blueprints to author input for the next simulation frame. Consider also calling Parent event.
+	// Slow path: only called with bUseBlueprintProduceInput set, since the command is copied through the VM both ways (stat "Moonshot Blueprint ProduceInput").
 	UFUNCTION(BlueprintImplementableEvent, DisplayName="On Produce Input", meta = (ScriptName = "OnProduceInput"))
 	FMoverInputCmdContext OnProduceInputInBlueprint(float DeltaMs, FMoverInputCmdContext InputCmd);
 
+	/** Native input extensions, run in order after OnProduceInput and before the Blueprint event. */
+	UPROPERTY(EditAnywhere, Instanced, BlueprintReadOnly, Category=Input)
+	TArray<TObjectPtr<UMoonshotInputModifier>> InputModifiers;
+
+	// Called by UpdateSurfaceProbe when it first finds no attachable surface since the probe was enabled or since it last found one
+	virtual void OnSurfaceLost();
+
+	/** Call the "On Produce Input" Blueprint event every produced frame. Costs two copies of the input command; prefer InputModifiers. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category=Input)
+	bool bUseBlueprintProduceInput = false;
+
 	/** Move Input Action */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category=Input)
 	UInputAction* MoveInputAction;
@@ -207,14 +283,22 @@ protected:
 	UPROPERTY(Category = Camera, VisibleAnywhere, BlueprintReadOnly, meta = (AllowPrivateAccess = "true"))
     USpringArmComponent* CameraBoom;
 
+	UPROPERTY(Category = Gravity, VisibleAnywhere, BlueprintReadOnly, meta = (AllowPrivateAccess = "true"))
+	TObjectPtr<UMoonshotGravityFrameComponent> GravityFrame;
+
+	UPROPERTY()
+	FMoonshotSurfaceProbeTickFunction SurfaceProbeTick;
+
+	uint64 SurfaceProbeFrame = 0;
+
 private:
-	/** Checks for changes in gravity reference frame and applies them
-	 * to the camera and control rotation.
-	*/
-	void UpdatePerspective(float DeltaSeconds);
+	UFUNCTION()
+	void OnMoverModeChanged(const FName& PreviousMovementModeName, const FName& NewMovementModeName);
+
+	FMoonshotMoverModeHandle CurrentModeHandle;
 
-	FQuat GravityQuat = FQuat::Identity;
-	FVector LastGravityUp = FVector::UpVector;
+	// Enables the surface probe only on a locally controlled pawn
+	void UpdateTickEnablement();
 
 	FVector LastAffirmativeMoveInput = FVector::ZeroVector;	// Movement input (intent or velocity) the last time we had one that wasn't zero
 
@@ -224,6 +308,19 @@ private:
 	FRotator CachedTurnInput = FRotator::ZeroRotator;
 	FRotator CachedLookInput = FRotator::ZeroRotator;
 
+	// Move and look input from the input actions by time. Move intent is averaged over each sim step's span, look is integrated
+	// over the time since it was last applied. Without samples (AI, RequestMoveByIntent) CachedMoveInputIntent is used as is.
+	FMoonshotInputSampleBuffer MoveInputSamples;
+	FMoonshotInputSampleBuffer LookInputSamples;
+	double MoveInputConsumedSeconds = 0.0;	// End of the span the last sim step's move input was averaged over
+	double LookInputAppliedSeconds = 0.0;
+
+	// Move intent averaged over the next DeltaMs of input time
+	FVector ConsumeMoveInput(float DeltaMs);
+
+	// Turns the look input held since the last call into control rotation
+	void ApplyLookInput(APlayerController* PC);
+
 	float MaxAttachDistance = 3000.0f; /// TODO: Populate this from settings
 	bool bCanAttachToSurface = false;
 	FVector AttachSurfaceNormal = FVector::ZeroVector;
@@ -232,6 +329,7 @@ private:
 	bool bIsJumpPressed = false;
 	bool bIsFlyingActive = false;
 	bool bShouldToggleFlying = false;
+	bool bShouldEnterZeroG = false;	// Suggest ZeroG whatever bIsFlyingActive says, e.g. after losing the surface
 	bool bModifyControl = false;
 	bool bModifySelect = false;
 
@@ -261,5 +359,14 @@ private:
 	void OnModifySelectCompleted(const FInputActionValue& Value);
 	void OnModifySelectTriggered(const FInputActionValue& Value);
 
+	uint8 NextInputSequence = 0;	// FMoonshotMoverCharacterInputs::InputSequence of the next produced command
+
+	// Oldest input event not yet in a produced command, for FMoonshotMoverInputLatency. Only kept in development builds.
+	double PendingInputEventSeconds = 0.0;
+	void StampInputEvent();
+
+	double SoakScriptSeconds = 0.0;	// Input time fed to FMoonshotNetSoak::GetScriptedInput, in non-shipping network soak clients only
+
 	uint8 bHasProduceInputinBpFunc : 1;
+	uint8 bHasTickInBpFunc : 1;
 };
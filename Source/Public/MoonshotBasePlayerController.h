@@ -18,8 +18,18 @@ class AMoonshotBasePlayerController : public APlayerController
 public:
 	virtual void BeginPlay() override;
 	
+	virtual void Tick(float DeltaSeconds) override;
+
 	virtual void UpdateRotation(float DeltaTime) override;
 
+	// Newest input command the server decoded for this player. The client delta-compresses later inputs against it.
+	UFUNCTION(Client, Unreliable)
+	void ClientAckInputBaseline(uint8 Sequence);
+
+	// Server-side squad assignment. Squadmates' pawns are always relevant to each other (see UMoonshotReplicationGraph).
+	UPROPERTY(BlueprintReadWrite, Category=Squad)
+	int32 SquadId = INDEX_NONE;
+
 	// Converts a rotation from world space to gravity relative space.
 	UFUNCTION(BlueprintPure)
 	static FRotator GetGravityRelativeRotation(FRotator Rotation, FVector GravityDirection);
@@ -0,0 +1,52 @@
+// Copyright 2024 Frazimuth, LLC.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/SpringArmComponent.h"
+#include "MoonshotCameraBoomComponent.generated.h"
+
+class UPrimitiveComponent;
+
+/**
+ * Spring arm whose collision probe reuses a short-lived set of nearby candidate primitives instead of sweeping the scene
+ * every frame. The candidates come from one overlap query around the lagged arm origin, redone when that origin leaves the
+ * margin it was gathered with, the arm grows longer than it was gathered for or CandidateRefreshSeconds pass; each frame the
+ * probe is swept against just those components, from the lagged origin to the lagged camera location, and resolved like
+ * the stock sweep. In cramped interiors, where the pawn's surface trace and the mover's floor queries already hit the same
+ * geometry, this removes the boom's per-frame scene query.
+ *
+ * The stock sweep starts at the unlagged origin; starting at the lagged one keeps the probe on the arm the camera is
+ * actually on, so with location lag a wall between the two origins is not caught.
+ *
+ * Anything that enters the candidate radius between refreshes is missed until the next one, so keep the refresh short.
+ */
+UCLASS(ClassGroup=Camera, meta=(BlueprintSpawnableComponent))
+class MOONSHOT_API UMoonshotCameraBoomComponent : public USpringArmComponent
+{
+	GENERATED_BODY()
+
+public:
+	/** Probe against cached candidates. Off: the stock per-frame scene sweep. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=CameraCollision, meta=(editcondition="bDoCollisionTest"))
+	bool bCacheProbeCandidates = true;
+
+	/** Longest a candidate set is used before it is gathered again. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=CameraCollision, meta=(editcondition="bCacheProbeCandidates", ClampMin="0", Units="s"))
+	float CandidateRefreshSeconds = 0.25f;
+
+	/** Extra radius gathered around the arm, and how far its origin may move before the set is gathered again. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=CameraCollision, meta=(editcondition="bCacheProbeCandidates", ClampMin="0", Units="cm"))
+	float CandidateMargin = 150.f;
+
+protected:
+	virtual void UpdateDesiredArmLocation(bool bDoTrace, bool bDoLocationLag, bool bDoRotationLag, float DeltaTime) override;
+
+private:
+	void RefreshCandidates(const FVector& ArmOrigin, float ProbeLength);
+
+	TArray<TWeakObjectPtr<UPrimitiveComponent>> Candidates;
+	FVector CandidateCenter = FVector::ZeroVector;
+	float CandidateProbeLength = -1.f;
+	double CandidateGatheredSeconds = -UE_BIG_NUMBER;
+};
@@ -0,0 +1,72 @@
+// Copyright 2024 Frazimuth, LLC.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "MoonshotGravityFrameComponent.generated.h"
+
+/**
+ * Gravity-relative reference frame for the camera, controller and input code, kept incrementally.
+ *
+ * The owner pushes the current gravity direction and frame rotation (AMoonshotBasePawn::RefreshGravityFrame); the cached
+ * basis and the world <-> gravity-relative rotations are only rebuilt when either moves by more than UpdateThresholdDegrees,
+ * so a pawn standing on one surface or drifting in zero-G pays a dot product per update instead of FindBetweenNormals and
+ * rotation matrix builds every frame. The gravity direction only ever changes in those steps, so consumers can compare it
+ * against the one they last saw to tell when to re-warp anything they keep relative to it. Does not tick.
+ */
+UCLASS(ClassGroup=(Moonshot), meta=(BlueprintSpawnableComponent))
+class MOONSHOT_API UMoonshotGravityFrameComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UMoonshotGravityFrameComponent();
+
+	// Returns true if the cached frame was rebuilt
+	bool Update(const FVector& GravityDirection, const FQuat& FrameRotation);
+
+	// Unit vector gravity pulls along
+	UFUNCTION(BlueprintPure, Category=Gravity)
+	FVector GetGravityDirection() const { return GravityDirection; }
+
+	UFUNCTION(BlueprintPure, Category=Gravity)
+	FQuat GetFrameRotation() const { return FrameRotation; }
+
+	UFUNCTION(BlueprintPure, Category=Gravity)
+	FVector GetForward() const { return Forward; }
+
+	UFUNCTION(BlueprintPure, Category=Gravity)
+	FVector GetRight() const { return Right; }
+
+	UFUNCTION(BlueprintPure, Category=Gravity)
+	FVector GetUp() const { return Up; }
+
+	// Rotates world space into the space where gravity points down
+	const FQuat& GetWorldToGravityRelative() const { return WorldToGravityRelative; }
+
+	const FQuat& GetGravityRelativeToWorld() const { return GravityRelativeToWorld; }
+
+	UFUNCTION(BlueprintPure, Category=Gravity)
+	FRotator ToGravityRelative(const FRotator& WorldRotation) const;
+
+	UFUNCTION(BlueprintPure, Category=Gravity)
+	FRotator ToWorld(const FRotator& GravityRelativeRotation) const;
+
+	/** Smallest change in gravity direction or frame rotation, in degrees, that rebuilds the cached frame. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=Gravity, meta=(ClampMin="0"))
+	float UpdateThresholdDegrees = 0.05f;
+
+private:
+	FVector GravityDirection = FVector::DownVector;
+	FQuat WorldToGravityRelative = FQuat::Identity;
+	FQuat GravityRelativeToWorld = FQuat::Identity;
+
+	FQuat FrameRotation = FQuat::Identity;
+	FVector Forward = FVector::ForwardVector;
+	FVector Right = FVector::RightVector;
+	FVector Up = FVector::UpVector;
+
+	// Gravity is straight down, so the conversions are identities
+	bool bWorldAligned = true;
+};
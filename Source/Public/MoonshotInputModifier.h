@@ -0,0 +1,30 @@
+// Copyright 2024 Frazimuth, LLC.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "MoonshotInputModifier.generated.h"
+
+class AMoonshotBasePawn;
+struct FMoverInputCmdContext;
+
+/**
+ * Native extension point for AMoonshotBasePawn input production. Modifiers on the pawn's InputModifiers list run in order
+ * after the pawn's own OnProduceInput, editing the command in place, so extending input costs no copies of the input
+ * collection. Prefer this over the "On Produce Input" Blueprint event, which copies the whole command in and out of the VM.
+ *
+ * Runs only where input is produced (the controlling client, or the server for pawns it controls) and never during resimulation.
+ */
+UCLASS(Abstract, EditInlineNew, DefaultToInstanced, CollapseCategories)
+class MOONSHOT_API UMoonshotInputModifier : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	virtual void ModifyInput(AMoonshotBasePawn& Pawn, float DeltaMs, FMoverInputCmdContext& InputCmd) PURE_VIRTUAL(UMoonshotInputModifier::ModifyInput, );
+
+	// Disabled modifiers stay registered but are skipped
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=Input)
+	bool bEnabled = true;
+};
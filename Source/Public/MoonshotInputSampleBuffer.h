@@ -0,0 +1,50 @@
+// Copyright 2024 Frazimuth, LLC.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/StaticArray.h"
+
+/**
+ * Ring buffer of timestamped input values, each held from its timestamp until the next one (sample and hold), that can be
+ * integrated over any interval. Lets input be consumed over a sim step's exact span rather than as whatever value happened
+ * to be latest when the step was produced, independent of how render frames and sim steps line up.
+ *
+ * Timestamps are FPlatformTime::Seconds(). Samples older than Capacity entries are dropped; their last value is still used
+ * for any time before the oldest remaining sample.
+ */
+struct MOONSHOT_API FMoonshotInputSampleBuffer
+{
+	static constexpr int32 Capacity = 64;
+
+	// Time is clamped so samples stay in order
+	void Add(double Time, const FVector& Value);
+
+	// Forgets all samples; the value before the first new sample is Value
+	void Reset(const FVector& Value = FVector::ZeroVector);
+
+	bool IsEmpty() const { return Num == 0; }
+
+	// Integral of the held value over [StartTime, EndTime]
+	FVector Integrate(double StartTime, double EndTime) const;
+
+	// Time-weighted mean of the held value over [StartTime, EndTime], or the value at EndTime for an empty interval
+	FVector Average(double StartTime, double EndTime) const;
+
+private:
+	struct FSample
+	{
+		double Time = 0.0;
+		FVector Value = FVector::ZeroVector;
+	};
+
+	// Index 0 is the oldest sample
+	const FSample& GetSample(int32 Index) const { return Samples[(Head + Index) % Capacity]; }
+
+	TStaticArray<FSample, Capacity> Samples;
+	int32 Head = 0;
+	int32 Num = 0;
+
+	// Held before the oldest sample
+	FVector ValueBeforeOldest = FVector::ZeroVector;
+};
@@ -0,0 +1,37 @@
+// Copyright 2024 Frazimuth, LLC.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UGameInstance;
+
+/**
+ * In-process half of the network soak (UMoonshotNetSoakCommandlet). A server or client launched with -MoonshotSoak=Server|Client
+ * runs for -MoonshotSoakSeconds, writes what it measured after -MoonshotSoakWarmup to -MoonshotSoakDir and exits.
+ *
+ * Clients drive their pawn with a scripted input pattern instead of the player's devices (see AMoonshotBasePawn::ProduceInput),
+ * so runs are reproducible. Each process writes Process,Connection,Metric,Value rows: the server its frame time, input repairs and
+ * bandwidth per client connection, each client its corrections, resim frames and bandwidth.
+ */
+struct MOONSHOT_API FMoonshotNetSoak
+{
+	// What a scripted client pawn wants to do this frame
+	struct FScriptedInput
+	{
+		FVector MoveIntent = FVector::ZeroVector;
+		bool bJumpPressed = false;
+		bool bToggleFlying = false;
+	};
+
+	// Starts the soak if the command line asks for one. Called by the game instance.
+	static void Start(UGameInstance* GameInstance);
+
+	static void Stop();
+
+	// True in soak clients, whose locally controlled pawns should take their input from GetScriptedInput
+	static bool IsScriptingInput();
+
+	// Input for the sim step from PrevSeconds to Seconds of pawn lifetime. Varies with the client index, so clients do not move in lockstep.
+	static FScriptedInput GetScriptedInput(double PrevSeconds, double Seconds);
+};
@@ -0,0 +1,30 @@
+// Copyright 2024 Frazimuth, LLC.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "MoonshotNetSoakCommandlet.generated.h"
+
+/**
+ * Local network benchmark: starts a dedicated server and N headless clients of this project on loopback (-nullrhi), lets
+ * scripted clients play for a while under packet lag and loss emulation, then collects what each process measured
+ * (FMoonshotNetSoak) into one report.
+ *
+ * UnrealEditor-Cmd Moonshot.uproject -run=MoonshotNetSoak -Clients=8 -Seconds=120 -PktLag=60 -PktLoss=2
+ *
+ * Options: -Clients (4), -Seconds (120), -Warmup (15), -Map (the default server map), -Port (17777), -PktLag, -PktLagVariance
+ * and -PktLoss (0, applied to every process's outgoing packets, so round trips see twice the lag), -Exe to run a packaged
+ * build instead of this executable. The report is written to Saved/MoonshotSoak/<timestamp>/Report.csv and logged.
+ * Packet emulation needs a non-shipping build.
+ */
+UCLASS()
+class MOONSHOT_API UMoonshotNetSoakCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UMoonshotNetSoakCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,163 @@
+// Copyright 2024 Frazimuth, LLC.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ReplicationGraph.h"
+#include "MoonshotReplicationGraph.generated.h"
+
+class UReplicationGraphNode_ActorList;
+class UReplicationGraphNode_AlwaysRelevant_ForConnection;
+
+/**
+ * Buckets spatialized actors into a 3D grid in the orbital frame and gathers them per connection by ring of cells
+ * around the viewer's cell (ring 0 is the cell itself). Ring N replicates every TierReplicationPeriods[N] frames and
+ * nothing past the last ring is relevant. Unlike the engine's 2D grid this works for zero-G arenas where
+ * players are spread along all three axes.
+ */
+UCLASS()
+class MOONSHOT_API UMoonshotReplicationGraphNode_OrbitalGrid : public UReplicationGraphNode
+{
+	GENERATED_BODY()
+
+public:
+	UMoonshotReplicationGraphNode_OrbitalGrid();
+
+	virtual void NotifyAddNetworkActor(const FNewReplicatedActorInfo& ActorInfo) override;
+	virtual bool NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound = true) override;
+	virtual void NotifyResetAllNetworkActors() override;
+	virtual void PrepareForReplication() override;
+	virtual void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
+	virtual void LogNode(FReplicationGraphDebugInfo& DebugInfo, const FString& NodeName) const override;
+
+	// World transform of the frame actors are bucketed in, e.g. the body the arena orbits. Identity is world space.
+	void SetOrbitalFrame(const FTransform& InOrbitalFrame) { OrbitalFrame = InOrbitalFrame; }
+
+	float CellSize = 10000.f;
+
+	// Replication period in frames for each ring of cells around the viewer; the array size sets the relevancy radius
+	TArray<int32> TierReplicationPeriods;
+
+private:
+	FIntVector GetCell(const FVector& WorldLocation) const;
+
+	FTransform OrbitalFrame = FTransform::Identity;
+
+	// Every spatialized actor, rebucketed each frame since Moonshot pawns rarely stand still
+	TArray<TObjectPtr<AActor>> Actors;
+
+	TMap<FIntVector, FActorRepListRefView> Cells;
+};
+
+/**
+ * Always gathers the pawns of a viewer's squad (AMoonshotBasePlayerController::SquadId), wherever they are on the grid,
+ * so squadmates never drop out of each other's relevancy or update tiers.
+ */
+UCLASS()
+class MOONSHOT_API UMoonshotReplicationGraphNode_Squads : public UReplicationGraphNode
+{
+	GENERATED_BODY()
+
+public:
+	UMoonshotReplicationGraphNode_Squads();
+
+	virtual void NotifyAddNetworkActor(const FNewReplicatedActorInfo& ActorInfo) override {}
+	virtual bool NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound = true) override { return false; }
+	virtual void PrepareForReplication() override;
+	virtual void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
+
+private:
+	TMap<int32, FActorRepListRefView> SquadPawns;
+};
+
+/**
+ * Gathers owner-only actors (bOnlyRelevantToOwner, other than controllers) for the connection that owns them. Each actor's
+ * connection is looked up through its owner chain (AActor::GetNetConnection) every frame, so an owner set after spawn is
+ * picked up. Split-screen players share their parent connection's list.
+ */
+UCLASS()
+class MOONSHOT_API UMoonshotReplicationGraphNode_OwnerOnly : public UReplicationGraphNode
+{
+	GENERATED_BODY()
+
+public:
+	UMoonshotReplicationGraphNode_OwnerOnly();
+
+	virtual void NotifyAddNetworkActor(const FNewReplicatedActorInfo& ActorInfo) override;
+	virtual bool NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound = true) override;
+	virtual void NotifyResetAllNetworkActors() override;
+	virtual void PrepareForReplication() override;
+	virtual void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
+
+private:
+	TArray<TObjectPtr<AActor>> Actors;
+
+	TMap<TObjectKey<UNetConnection>, FActorRepListRefView> ConnectionActors;
+};
+
+/**
+ * Replication graph for Moonshot: what each connection receives scales with how many players are near it, not with the
+ * total player count. Finding them costs each viewer a walk over the cells in range or over the occupied cells, whichever is fewer.
+ *
+ * Spatialized actors (pawns included) go into the orbital grid with distance-tiered update rates, which also throttles
+ * the Mover sync state since it replicates with the pawn. Always-relevant actors go to every connection, each connection
+ * always gets its own controller, pawn and view target and its owner-only actors, and squads always see each other.
+ * Actors attached to a replicated actor when they start replicating (equipment) are its dependents and replicate with it
+ * rather than on their own; see AddDependentActor for attachments made later.
+ *
+ * Enable with [/Script/OnlineSubsystemUtils.IpNetDriver] ReplicationDriverClassName="/Script/Moonshot.MoonshotReplicationGraph"
+ * in DefaultEngine.ini; the Moonshot module needs the ReplicationGraph dependency.
+ */
+UCLASS(Transient, config=Engine)
+class MOONSHOT_API UMoonshotReplicationGraph : public UReplicationGraph
+{
+	GENERATED_BODY()
+
+public:
+	UMoonshotReplicationGraph();
+
+	virtual void InitGlobalActorClassSettings() override;
+	virtual void InitGlobalGraphNodes() override;
+	virtual void InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection) override;
+	virtual void RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo) override;
+	virtual void RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo) override;
+
+	UFUNCTION(BlueprintCallable, Category=Replication)
+	void SetOrbitalFrame(const FTransform& OrbitalFrame);
+
+	/** Replicate Child whenever Parent replicates, to the same connections, instead of on its own. For equipment attached to a pawn. */
+	UFUNCTION(BlueprintCallable, Category=Replication)
+	void AddDependentActor(AActor* Parent, AActor* Child);
+
+	/** Undo AddDependentActor, e.g. when equipment is dropped, so Child is routed on its own again */
+	UFUNCTION(BlueprintCallable, Category=Replication)
+	void RemoveDependentActor(AActor* Child);
+
+	/** Edge length of an orbital grid cell */
+	UPROPERTY(Config)
+	float OrbitalCellSize = 10000.f;
+
+	/** Replication period in frames for each ring of cells around the viewer, starting with its own cell. Nothing past the last ring is relevant. */
+	UPROPERTY(Config)
+	TArray<int32> TierReplicationPeriods;
+
+	UPROPERTY()
+	TObjectPtr<UMoonshotReplicationGraphNode_OrbitalGrid> OrbitalGridNode;
+
+	UPROPERTY()
+	TObjectPtr<UReplicationGraphNode_ActorList> AlwaysRelevantNode;
+
+	UPROPERTY()
+	TObjectPtr<UMoonshotReplicationGraphNode_Squads> SquadNode;
+
+	UPROPERTY()
+	TObjectPtr<UMoonshotReplicationGraphNode_OwnerOnly> OwnerOnlyNode;
+
+private:
+	// Adds Actor to the node for how it replicates on its own: always relevant, owner only or the grid
+	void RouteToOwnNode(const FNewReplicatedActorInfo& ActorInfo);
+	void RemoveFromOwnNode(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound = true);
+
+	// Parent of every dependent actor, so it can be released from the right parent however its attachment changed since
+	TMap<TObjectKey<AActor>, TWeakObjectPtr<AActor>> DependentActorParents;
+};